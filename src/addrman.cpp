@@ -15,7 +15,7 @@
 #include <cstdio>
 #include <cstring>
 
-int CAddrInfo::GetTriedBucket(const uint256 &nKey, const std::vector<bool> &asmap) const {
+int CAddrInfo::GetTriedBucket(const uint256 &nKey, const ASMap &asmap) const {
     uint64_t hash1 =
         (CHashWriter(SER_GETHASH, 0) << nKey << GetKey()).GetCheapHash();
     uint64_t hash2 =
@@ -27,7 +27,7 @@ int CAddrInfo::GetTriedBucket(const uint256 &nKey, const std::vector<bool> &asma
     return tried_bucket;
 }
 
-int CAddrInfo::GetNewBucket(const uint256 &nKey, const CNetAddr &src, const std::vector<bool> &asmap) const {
+int CAddrInfo::GetNewBucket(const uint256 &nKey, const CNetAddr &src, const ASMap &asmap) const {
     std::vector<uint8_t> vchSourceGroupKey = src.GetGroup(asmap);
     uint64_t hash1 = (CHashWriter(SER_GETHASH, 0) << nKey << GetGroup(asmap) << vchSourceGroupKey).GetCheapHash();
     uint64_t hash2 = (CHashWriter(SER_GETHASH, 0)
@@ -16,6 +16,7 @@
 #include <sync.h>
 #include <timedata.h>
 #include <tinyformat.h>
+#include <util/asmap.h>
 #include <util/system.h>
 
 #include <cstdint>
@@ -68,15 +69,15 @@ public:
     CAddrInfo() : CAddress(), source() {}
 
     //! Calculate in which "tried" bucket this entry belongs
-    int GetTriedBucket(const uint256 &nKey, const std::vector<bool> &asmap) const;
+    int GetTriedBucket(const uint256 &nKey, const ASMap &asmap) const;
 
     //! Calculate in which "new" bucket this entry belongs, given a certain
     //! source
-    int GetNewBucket(const uint256 &nKey, const CNetAddr &src, const std::vector<bool> &asmap) const;
+    int GetNewBucket(const uint256 &nKey, const CNetAddr &src, const ASMap &asmap) const;
 
     //! Calculate in which "new" bucket this entry belongs, using its default
     //! source
-    int GetNewBucket(const uint256 &nKey, const std::vector<bool> &asmap) const {
+    int GetNewBucket(const uint256 &nKey, const ASMap &asmap) const {
         return GetNewBucket(nKey, source, asmap);
     }
 
@@ -301,7 +302,8 @@ public:
 
     // Compressed IP->ASN mapping, loaded from a file when a node starts.
     // Should be always empty if no file was provided.
-    // This mapping is then used for bucketing nodes in Addrman.
+    // This mapping is then used for bucketing nodes in Addrman, and is
+    // compiled into a range table for fast lookups when it is set.
     //
     // If asmap is provided, nodes will be bucketed by
     // AS they belong to, in order to make impossible for a node
@@ -313,7 +315,7 @@ public:
     //
     // If a new asmap was provided, the existing records
     // would be re-bucketed accordingly.
-    std::vector<bool> m_asmap;
+    ASMap m_asmap;
 
     // Read asmap from provided binary file
     static std::vector<bool> DecodeAsmap(fs::path path);
@@ -402,8 +404,8 @@ public:
         // Store asmap version after bucket entries so that it
         // can be ignored by older clients for backward compatibility.
         uint256 asmap_version;
-        if (m_asmap.size() != 0) {
-            asmap_version = SerializeHash(m_asmap);
+        if (!m_asmap.empty()) {
+            asmap_version = SerializeHash(m_asmap.GetBits());
         }
         s << asmap_version;
     }
@@ -507,8 +509,8 @@ public:
         }
 
         uint256 supplied_asmap_version;
-        if (m_asmap.size() != 0) {
-            supplied_asmap_version = SerializeHash(m_asmap);
+        if (!m_asmap.empty()) {
+            supplied_asmap_version = SerializeHash(m_asmap.GetBits());
         }
         uint256 serialized_asmap_version;
         if (format >= Format::V2_ASMAP) {
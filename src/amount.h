@@ -142,9 +142,9 @@ public:
     SERIALIZE_METHODS(Amount, obj) { READWRITE(obj.amount); }
 };
 
-inline constexpr Amount SATOSHI = Amount::yaro();
-inline constexpr Amount CASH = 100 * YARO;
-inline constexpr Amount COIN = 100'000'000 * YARO;
+inline constexpr Amount SATOSHI = Amount::satoshi();
+inline constexpr Amount CASH = 100 * SATOSHI;
+inline constexpr Amount COIN = 100'000'000 * SATOSHI;
 
 extern const std::string CURRENCY_UNIT;
 
@@ -0,0 +1,203 @@
+// Copyright (c) 2026 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <netaddress.h>
+#include <random.h>
+#include <util/asmap.h>
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+/**
+ * A synthetic asmap mapping random IPv4 /24 prefixes to random ASNs, encoded
+ * as a binary trie of JUMP and RETURN instructions. Its size and lookup depth
+ * are of the order of those of a real asmap.
+ */
+namespace {
+
+constexpr size_t NUM_PREFIXES = 20000;
+constexpr size_t NUM_LOOKUPS = 1000;
+
+constexpr std::array<uint8_t, 3> TYPE_BIT_SIZES{{0, 0, 1}};
+constexpr std::array<uint8_t, 10> ASN_BIT_SIZES{{15, 16, 17, 18, 19, 20, 21, 22, 23, 24}};
+constexpr std::array<uint8_t, 26> JUMP_BIT_SIZES{{5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15, 16, 17,
+                                                  18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30}};
+
+/** Inverse of DecodeBits() in util/asmap.cpp. */
+template <size_t N>
+void EncodeBits(std::vector<bool> &out, uint32_t val, uint32_t minval, const std::array<uint8_t, N> &bit_sizes) {
+    val -= minval;
+    for (size_t i = 0; i < N; ++i) {
+        const bool last = i + 1 == N;
+        if (!last && val >= (uint32_t(1) << bit_sizes[i])) {
+            out.push_back(true);
+            val -= uint32_t(1) << bit_sizes[i];
+            continue;
+        }
+        if (!last) {
+            out.push_back(false);
+        }
+        for (int b = bit_sizes[i] - 1; b >= 0; --b) {
+            out.push_back((val >> b) & 1);
+        }
+        return;
+    }
+}
+
+template <size_t N> size_t EncodedSize(uint32_t val, uint32_t minval, const std::array<uint8_t, N> &bit_sizes) {
+    std::vector<bool> tmp;
+    EncodeBits(tmp, val, minval, bit_sizes);
+    return tmp.size();
+}
+
+/** ASN returned for addresses outside of all prefixes (RETURN cannot encode 0). */
+constexpr uint32_t UNMAPPED_ASN = 1;
+
+struct Trie {
+    struct Node {
+        int child[2] = {-1, -1};
+        uint32_t asn = 0;
+        size_t size = 0; //!< Size of the encoded subtree, in bits
+    };
+    std::vector<Node> nodes{1};
+
+    void Insert(const std::vector<bool> &prefix, uint32_t asn) {
+        int node = 0;
+        for (bool bit : prefix) {
+            if (nodes[node].child[bit] < 0) {
+                nodes[node].child[bit] = nodes.size();
+                nodes.emplace_back();
+            }
+            node = nodes[node].child[bit];
+        }
+        nodes[node].asn = asn;
+    }
+
+    bool IsLeaf(int node) const { return nodes[node].child[0] < 0 && nodes[node].child[1] < 0; }
+
+    uint32_t GetASN(int node) const { return node < 0 ? UNMAPPED_ASN : nodes[node].asn; }
+
+    /**
+     * Compute the encoded size of every subtree. Leaves and missing children
+     * RETURN their ASN, other nodes JUMP on the next bit.
+     */
+    size_t ComputeSize(int node) {
+        size_t size;
+        if (node < 0 || IsLeaf(node)) {
+            size = EncodedSize(0, 0, TYPE_BIT_SIZES) + EncodedSize(GetASN(node), 1, ASN_BIT_SIZES);
+        } else {
+            const size_t zero = ComputeSize(nodes[node].child[0]);
+            const size_t one = ComputeSize(nodes[node].child[1]);
+            size = EncodedSize(1, 0, TYPE_BIT_SIZES) + EncodedSize(zero, 17, JUMP_BIT_SIZES) + zero + one;
+        }
+        if (node >= 0) {
+            nodes[node].size = size;
+        }
+        return size;
+    }
+
+    void Encode(int node, std::vector<bool> &out) const {
+        if (node < 0 || IsLeaf(node)) {
+            EncodeBits(out, 0, 0, TYPE_BIT_SIZES); // RETURN
+            EncodeBits(out, GetASN(node), 1, ASN_BIT_SIZES);
+            return;
+        }
+        const int zero = nodes[node].child[0];
+        const size_t zero_size =
+            zero < 0 ? EncodedSize(0, 0, TYPE_BIT_SIZES) + EncodedSize(UNMAPPED_ASN, 1, ASN_BIT_SIZES)
+                     : nodes[zero].size;
+        EncodeBits(out, 1, 0, TYPE_BIT_SIZES); // JUMP over the 0 branch
+        EncodeBits(out, zero_size, 17, JUMP_BIT_SIZES);
+        Encode(zero, out);
+        Encode(nodes[node].child[1], out);
+    }
+};
+
+std::vector<bool> IPv4MappedBits(uint32_t ipv4) {
+    std::vector<bool> bits(128);
+    for (int i = 80; i < 96; ++i) {
+        bits[i] = true;
+    }
+    for (int i = 0; i < 32; ++i) {
+        bits[96 + i] = (ipv4 >> (31 - i)) & 1;
+    }
+    return bits;
+}
+
+struct BenchASMap {
+    std::vector<bool> asmap;
+    std::vector<uint32_t> addresses; //!< IPv4 addresses to look up
+
+    BenchASMap() {
+        FastRandomContext rng(true);
+        Trie trie;
+        std::vector<uint32_t> prefixes;
+        for (size_t i = 0; i < NUM_PREFIXES; ++i) {
+            const uint32_t prefix = rng.rand32() & 0xffffff00;
+            std::vector<bool> bits = IPv4MappedBits(prefix);
+            bits.resize(120);
+            trie.Insert(bits, 2 + rng.randrange(100000));
+            prefixes.push_back(prefix);
+        }
+        trie.ComputeSize(0);
+        trie.Encode(0, asmap);
+        assert(SanityCheckASMap(asmap, 128));
+
+        // Half of the lookups hit a mapped prefix.
+        for (size_t i = 0; i < NUM_LOOKUPS; ++i) {
+            addresses.push_back(i % 2 ? prefixes[rng.randrange(prefixes.size())] | rng.randbits(8) : rng.rand32());
+        }
+    }
+};
+
+const BenchASMap &GetBenchASMap() {
+    static const BenchASMap bench_asmap;
+    return bench_asmap;
+}
+
+} // namespace
+
+static void ASMapInterpret(benchmark::State &state) {
+    const BenchASMap &data = GetBenchASMap();
+    std::vector<std::vector<bool>> ips;
+    for (uint32_t address : data.addresses) {
+        ips.push_back(IPv4MappedBits(address));
+    }
+    BENCHMARK_LOOP {
+        for (const std::vector<bool> &ip : ips) {
+            Interpret(data.asmap, ip);
+        }
+    }
+}
+
+static void ASMapLookup(benchmark::State &state) {
+    const BenchASMap &data = GetBenchASMap();
+    const ASMap asmap(data.asmap);
+    std::vector<CNetAddr> addrs;
+    for (uint32_t address : data.addresses) {
+        in_addr ipv4;
+        ipv4.s_addr = htonl(address);
+        addrs.emplace_back(ipv4);
+    }
+    BENCHMARK_LOOP {
+        for (const CNetAddr &addr : addrs) {
+            addr.GetMappedAS(asmap);
+        }
+    }
+}
+
+static void ASMapCompile(benchmark::State &state) {
+    const BenchASMap &data = GetBenchASMap();
+    BENCHMARK_LOOP {
+        const ASMap asmap(data.asmap);
+        assert(asmap.RangeCount() > 0);
+    }
+}
+
+BENCHMARK(ASMapInterpret, 20);
+BENCHMARK(ASMapLookup, 2000);
+BENCHMARK(ASMapCompile, 2);
@@ -0,0 +1,118 @@
+// Copyright (c) 2026 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chain.h>
+#include <random.h>
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+/**
+ * Block tree shaped like mainnet's: a long active chain, and a stale branch
+ * of FORK_LENGTH blocks forking off it, as seen while syncing headers from a
+ * peer on a long-lived split.
+ */
+namespace {
+
+constexpr int CHAIN_LENGTH = 700000;
+constexpr int FORK_HEIGHT = 500000;
+constexpr int FORK_LENGTH = 2000;
+
+struct BlockTree {
+    std::vector<BlockHash> hashes;
+    std::vector<std::unique_ptr<CBlockIndex>> blocks;
+    CChain chain;
+    const CBlockIndex *fork_tip = nullptr;
+
+    BlockTree() : hashes(CHAIN_LENGTH + FORK_LENGTH) {
+        blocks.reserve(hashes.size());
+        for (size_t i = 0; i < hashes.size(); ++i) {
+            hashes[i] = BlockHash(ArithToUint256(arith_uint256(i)));
+            auto pindex = std::make_unique<CBlockIndex>();
+            pindex->phashBlock = &hashes[i];
+            if (i < CHAIN_LENGTH) {
+                pindex->nHeight = i;
+                pindex->pprev = i ? blocks.back().get() : nullptr;
+            } else {
+                pindex->nHeight = FORK_HEIGHT + 1 + (i - CHAIN_LENGTH);
+                pindex->pprev = i == CHAIN_LENGTH ? blocks[FORK_HEIGHT].get()
+                                                  : blocks.back().get();
+            }
+            pindex->BuildSkip();
+            blocks.push_back(std::move(pindex));
+        }
+        chain.SetTip(blocks[CHAIN_LENGTH - 1].get());
+        fork_tip = blocks.back().get();
+    }
+};
+
+const BlockTree &GetBlockTree() {
+    static const BlockTree tree;
+    return tree;
+}
+
+std::vector<int> RandomHeights(int max_height) {
+    FastRandomContext rng(true);
+    std::vector<int> heights(1000);
+    for (int &height : heights) {
+        height = rng.randrange(max_height + 1);
+    }
+    return heights;
+}
+
+} // namespace
+
+/** Ancestor lookups from the active tip, walking the skiplist. */
+static void SkipListGetAncestor(benchmark::State &state) {
+    const BlockTree &tree = GetBlockTree();
+    const CBlockIndex *tip = tree.chain.Tip();
+    const std::vector<int> heights = RandomHeights(tip->nHeight);
+    BENCHMARK_LOOP {
+        for (int height : heights) {
+            assert(tip->GetAncestor(height)->nHeight == height);
+        }
+    }
+}
+
+/** The same lookups answered by the active chain's height index. */
+static void ChainGetAncestor(benchmark::State &state) {
+    const BlockTree &tree = GetBlockTree();
+    const CBlockIndex *tip = tree.chain.Tip();
+    const std::vector<int> heights = RandomHeights(tip->nHeight);
+    BENCHMARK_LOOP {
+        for (int height : heights) {
+            assert(tree.chain.GetAncestor(tip, height)->nHeight == height);
+        }
+    }
+}
+
+/** Fork point of the tip of a long stale branch. */
+static void ChainFindFork(benchmark::State &state) {
+    const BlockTree &tree = GetBlockTree();
+    BENCHMARK_LOOP {
+        assert(tree.chain.FindFork(tree.fork_tip)->nHeight == FORK_HEIGHT);
+    }
+}
+
+/**
+ * Header sync against a peer on the stale branch: locate it from our locator
+ * and find the common ancestor of both tips.
+ */
+static void ChainHeaderSync(benchmark::State &state) {
+    const BlockTree &tree = GetBlockTree();
+    BENCHMARK_LOOP {
+        const CBlockLocator locator = tree.chain.GetLocator(tree.fork_tip);
+        assert(!locator.IsNull());
+        const CBlockIndex *common =
+            LastCommonAncestor(tree.chain.Tip(), tree.fork_tip);
+        assert(common->nHeight == FORK_HEIGHT);
+    }
+}
+
+BENCHMARK(SkipListGetAncestor, 2000);
+BENCHMARK(ChainGetAncestor, 2000);
+BENCHMARK(ChainFindFork, 100000);
+BENCHMARK(ChainHeaderSync, 50000);
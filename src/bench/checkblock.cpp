@@ -6,6 +6,7 @@
 #include <bench/bench.h>
 #include <bench/data.h>
 
+#include <blockencodings.h>
 #include <chainparams.h>
 #include <config.h>
 #include <consensus/validation.h>
@@ -106,6 +107,21 @@ static void CheckBlockHashTest(const std::vector<uint8_t> &data, benchmark::Stat
     }
 }
 
+static void CompactBlockTest(const std::vector<uint8_t> &data, benchmark::State &state) {
+    CDataStream stream(data, SER_NETWORK, PROTOCOL_VERSION);
+    char a = '\0';
+    stream.write(&a, 1); // Prevent compaction
+
+    CBlock block;
+    stream >> block;
+
+    // computes the short ID of every transaction in the block
+    BENCHMARK_LOOP {
+        CBlockHeaderAndShortTxIDs cmpctblock(block);
+        assert(cmpctblock.BlockTxCount() == block.vtx.size());
+    }
+}
+
 static void DeserializeBlockTest_1MB(benchmark::State &state) {
     DeserializeBlockTest(benchmark::data::Get_block413567(), state);
 }
@@ -130,6 +146,12 @@ static void CheckProofOfWorkTest_1MB(benchmark::State &state) {
 static void CheckProofOfWorkTest_32MB(benchmark::State &state) {
     CheckProofOfWorkTest(benchmark::data::Get_block556034(), state);
 }
+static void CompactBlockTest_1MB(benchmark::State &state) {
+    CompactBlockTest(benchmark::data::Get_block413567(), state);
+}
+static void CompactBlockTest_32MB(benchmark::State &state) {
+    CompactBlockTest(benchmark::data::Get_block556034(), state);
+}
 static void CheckBlockHashTest_1MB(benchmark::State &state) {
     CheckBlockHashTest(benchmark::data::Get_block413567(), state, "0000000000000000025aff8be8a55df8f89c77296db6198f272d6577325d4069");
 }
@@ -145,5 +167,7 @@ BENCHMARK(CheckBlockTest_1MB, 1600);
 BENCHMARK(CheckBlockTest_32MB, 20);
 BENCHMARK(CheckProofOfWorkTest_1MB, 1'000'000);
 BENCHMARK(CheckProofOfWorkTest_32MB, 1'000'000);
+BENCHMARK(CompactBlockTest_1MB, 1600);
+BENCHMARK(CompactBlockTest_32MB, 20);
 BENCHMARK(CheckBlockHashTest_1MB, 1'000'000);
 BENCHMARK(CheckBlockHashTest_32MB, 1'000'000);
@@ -12,8 +12,10 @@
 #include <crypto/sha512.h>
 #include <crypto/siphash.h>
 #include <hash.h>
+#include <primitives/transaction.h>
 #include <random.h>
 #include <uint256.h>
+#include <util/saltedhashers.h>
 #include <util/time.h>
 
 #include <iostream>
@@ -85,6 +87,56 @@ static void SipHash_32b(benchmark::State &state) {
     }
 }
 
+static void SipHash_32b_4way(benchmark::State &state) {
+    uint256 x[4];
+    const uint256 *const px[4] = {&x[0], &x[1], &x[2], &x[3]};
+    uint64_t k1 = 0;
+    BENCHMARK_LOOP {
+        uint64_t hash64[4];
+        SipHashUint256_4way(0, ++k1, px, hash64);
+        for (int i = 0; i < 4; ++i) {
+            std::memcpy(x[i].begin(), &hash64[i], sizeof(hash64[i]));
+        }
+    }
+}
+
+/* Number of outpoints to hash per iteration */
+static const size_t NUM_OUTPOINTS = 1000;
+
+static std::vector<COutPoint> RandomOutpoints() {
+    FastRandomContext rng(true);
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(NUM_OUTPOINTS);
+    for (size_t i = 0; i < NUM_OUTPOINTS; ++i) {
+        outpoints.emplace_back(TxId(rng.rand256()), rng.randbits(4));
+    }
+    return outpoints;
+}
+
+static void SaltedOutpointHasher_1000(benchmark::State &state) {
+    const std::vector<COutPoint> outpoints = RandomOutpoints();
+    const SaltedOutpointHasher hasher;
+    std::vector<size_t> hashes(outpoints.size());
+    BENCHMARK_LOOP {
+        for (size_t i = 0; i < outpoints.size(); ++i) {
+            hashes[i] = hasher(outpoints[i]);
+        }
+    }
+}
+
+static void SaltedOutpointHasherBatch_1000(benchmark::State &state) {
+    const std::vector<COutPoint> outpoints = RandomOutpoints();
+    std::vector<const COutPoint *> poutpoints;
+    for (const COutPoint &outpoint : outpoints) {
+        poutpoints.push_back(&outpoint);
+    }
+    const SaltedOutpointHasher hasher;
+    std::vector<size_t> hashes(outpoints.size());
+    BENCHMARK_LOOP {
+        hasher.HashBatch(poutpoints.data(), poutpoints.size(), hashes.data());
+    }
+}
+
 static void FastRandom_32bit(benchmark::State &state) {
     FastRandomContext rng(true);
     BENCHMARK_LOOP {
@@ -107,6 +159,9 @@ BENCHMARK(SHA3_256_1M, 250);
 
 BENCHMARK(SHA256_32b, 4700 * 1000);
 BENCHMARK(SipHash_32b, 40 * 1000 * 1000);
+BENCHMARK(SipHash_32b_4way, 10 * 1000 * 1000);
+BENCHMARK(SaltedOutpointHasher_1000, 40 * 1000);
+BENCHMARK(SaltedOutpointHasherBatch_1000, 40 * 1000);
 BENCHMARK(SHA256D64_1024, 7400);
 BENCHMARK(FastRandom_32bit, 110 * 1000 * 1000);
 BENCHMARK(FastRandom_1bit, 440 * 1000 * 1000);
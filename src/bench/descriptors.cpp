@@ -0,0 +1,31 @@
+// Copyright (c) 2026 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <key.h>
+#include <key_io.h>
+#include <script/descriptor.h>
+#include <script/script.h>
+#include <script/sign.h>
+#include <script/standard.h>
+
+#include <cassert>
+#include <vector>
+
+/** Expand 1000 positions of a ranged descriptor, as scantxoutset does. */
+static void DescriptorExpandRange(benchmark::State &state) {
+    const std::vector<uint8_t> seed(32, 0x01);
+    CExtKey key;
+    key.SetSeed(seed.data(), seed.size());
+    FlatSigningProvider provider;
+    const auto desc = Parse("pkh(" + EncodeExtPubKey(key.Neuter()) + "/0/*)", provider);
+    assert(desc);
+    BENCHMARK_LOOP {
+        std::vector<CScript> scripts;
+        const bool ok = ExpandRange(*desc, 0, 1000, provider, scripts);
+        assert(ok && scripts.size() == 1000);
+    }
+}
+
+BENCHMARK(DescriptorExpandRange, 2);
@@ -73,6 +73,35 @@ static void DuplicateInputs(benchmark::State &state) {
     }
 }
 
+// CheckBlock() on a block with many small transactions, which has its
+// context-free transaction checks spread over the tx-check worker threads.
+static void CheckBlockManyTxs(benchmark::State &state) {
+    FastRandomContext rng(true);
+
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].scriptSig.resize(10);
+    tx.vout.resize(1);
+    tx.vout[0].nValue = 42 * SATOSHI;
+    tx.vout[0].scriptPubKey = CScript(OP_TRUE);
+
+    CBlock block{};
+    block.vtx.push_back(MakeTransactionRef(tx));
+    for (size_t i = 1; i < 100000; i++) {
+        tx.vin[0].prevout = COutPoint(TxId(rng.rand256()), 0);
+        block.vtx.push_back(MakeTransactionRef(tx));
+    }
+
+    BENCHMARK_LOOP {
+        block.fChecked = false;
+        CValidationState cvstate{};
+        assert(CheckBlock(block, cvstate, Params().GetConsensus(),
+                          BlockValidationOptions(GetConfig())
+                              .withCheckPoW(false)
+                              .withCheckMerkleRoot(false)));
+    }
+}
+
 template<size_t vinSize, size_t batchSize>
 static void CheckRegularTransactionBench(benchmark::State &state) {
     FastRandomContext rng(true);
@@ -125,6 +154,7 @@ static void CheckRegularTransactionBench(benchmark::State &state) {
 }
 
 BENCHMARK(DuplicateInputs, 10);
+BENCHMARK(CheckBlockManyTxs, 5);
 
 constexpr auto CheckRegularTransaction_1 = CheckRegularTransactionBench<1, 1000>;
 constexpr auto CheckRegularTransaction_2 = CheckRegularTransactionBench<2, 1000>;
@@ -9,7 +9,8 @@
 
 #include <functional>
 
-static void TopUpKeyPoolShared(benchmark::State &state, std::function<void(CWallet&)> setup) {
+static void TopUpKeyPoolShared(benchmark::State &state, std::function<void(CWallet&)> setup,
+                               unsigned int num_keys = 10) {
     SelectParams(CBaseChainParams::REGTEST);
 
     auto chain = interfaces::MakeChain();
@@ -20,7 +21,7 @@ static void TopUpKeyPoolShared(benchmark::State &state, std::function<void(CWall
     LOCK(wallet.cs_wallet);
 
     BENCHMARK_LOOP {
-        wallet.TopUpKeyPool(wallet.GetKeyPoolSize() + 10);
+        wallet.TopUpKeyPool(wallet.GetKeyPoolSize() + num_keys);
     }
 }
 
@@ -33,6 +34,16 @@ static void TopUpKeyPoolHD(benchmark::State &state) {
 
 BENCHMARK(TopUpKeyPoolHD, 25);
 
+// Large top-ups, as with a high -keypool, derive keys over several threads
+static void TopUpKeyPoolHD_1000(benchmark::State &state) {
+    TopUpKeyPoolShared(state, [](CWallet& wallet) {
+        auto master_pub_key = wallet.GenerateNewSeed();
+        wallet.SetHDSeed(master_pub_key);
+    }, 1000);
+}
+
+BENCHMARK(TopUpKeyPoolHD_1000, 1);
+
 static void TopUpKeyPool(benchmark::State &state) {
     TopUpKeyPoolShared(state, [](CWallet& wallet) { });
 }
@@ -0,0 +1,139 @@
+// Copyright (c) 2026 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <bench/data.h>
+#include <coins.h>
+#include <dbwrapper.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <serialize.h>
+#include <streams.h>
+#include <txdb.h>
+#include <util/system.h>
+#include <version.h>
+
+#include <util/crc32c.h> // leveldb's
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <vector>
+
+/**
+ * Chainstate-shaped LevelDB workload: the 166943 coins spent by block 556034,
+ * stored under the same keys and with the same values as in the chainstate
+ * database (see CoinEntry in txdb.cpp). The database is not obfuscated, and
+ * lives in the benchmark's temporary data directory.
+ */
+namespace {
+
+constexpr size_t DB_CACHE_SIZE = 8 << 20;
+constexpr char DB_COIN = 'C';
+
+struct BenchCoinKey {
+    const COutPoint &outpoint;
+
+    template <typename Stream> void Serialize(Stream &s) const {
+        const uint32_t n = outpoint.GetN();
+        s << DB_COIN << outpoint.GetTxId() << VARINT(n);
+    }
+};
+
+const std::map<COutPoint, Coin> &GetCoins() {
+    static const std::map<COutPoint, Coin> coins = [] {
+        std::map<COutPoint, Coin> ret;
+        CDataStream(benchmark::data::Get_coins_spent_556034(), SER_NETWORK,
+                    PROTOCOL_VERSION) >>
+            ret;
+        return ret;
+    }();
+    return coins;
+}
+
+/** Write all coins, in batches of at most -dbbatchsize like a flush does. */
+void WriteCoins(CDBWrapper &db) {
+    CDBBatch batch(db);
+    for (const auto &[outpoint, coin] : GetCoins()) {
+        batch.Write(BenchCoinKey{outpoint}, coin);
+        if (batch.SizeEstimate() > size_t(nDefaultDbBatchSize)) {
+            db.WriteBatch(batch);
+            batch.Clear();
+        }
+    }
+    db.WriteBatch(batch, true);
+}
+
+void CompactCoins(CDBWrapper &db) {
+    db.CompactRange(DB_COIN, char(DB_COIN + 1));
+}
+
+} // namespace
+
+/** Bulk write of all coins into an empty database. */
+static void LevelDBCoinsWrite(benchmark::State &state) {
+    const fs::path path = GetDataDir() / "bench_leveldb";
+    GetCoins();
+    BENCHMARK_LOOP {
+        CDBWrapper db(path, DB_CACHE_SIZE, false, true);
+        WriteCoins(db);
+    }
+}
+
+/** Point lookups of every coin, in random order, from a compacted database. */
+static void LevelDBCoinsRead(benchmark::State &state) {
+    CDBWrapper db(GetDataDir() / "bench_leveldb", DB_CACHE_SIZE, false, true,
+                  false, true);
+    WriteCoins(db);
+    CompactCoins(db);
+
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(GetCoins().size());
+    for (const auto &entry : GetCoins()) {
+        outpoints.push_back(entry.first);
+    }
+    FastRandomContext rng(true);
+    std::shuffle(outpoints.begin(), outpoints.end(), rng);
+
+    BENCHMARK_LOOP {
+        Coin coin;
+        for (const COutPoint &outpoint : outpoints) {
+            bool found = db.Read(BenchCoinKey{outpoint}, coin);
+            assert(found);
+        }
+    }
+}
+
+/**
+ * Overwrite all coins and compact them with the previous generation, so that
+ * every iteration merges two full copies of the coin set.
+ */
+static void LevelDBCoinsCompact(benchmark::State &state) {
+    CDBWrapper db(GetDataDir() / "bench_leveldb", DB_CACHE_SIZE, false, true);
+    WriteCoins(db);
+    CompactCoins(db);
+    BENCHMARK_LOOP {
+        WriteCoins(db);
+        CompactCoins(db);
+    }
+}
+
+/** Checksum over a LevelDB block's worth of data, as done on every read. */
+static void LevelDBCRC32C(benchmark::State &state) {
+    std::vector<char> data(4096);
+    FastRandomContext rng(true);
+    for (char &c : data) {
+        c = char(rng.randbits(8));
+    }
+    uint32_t crc = 0;
+    BENCHMARK_LOOP {
+        crc = leveldb::crc32c::Extend(crc, data.data(), data.size());
+    }
+    assert(crc != 0);
+}
+
+BENCHMARK(LevelDBCoinsWrite, 1);
+BENCHMARK(LevelDBCoinsRead, 1);
+BENCHMARK(LevelDBCoinsCompact, 1);
+BENCHMARK(LevelDBCRC32C, 500000);
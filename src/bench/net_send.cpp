@@ -0,0 +1,87 @@
+// Copyright (c) 2026 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <compat.h>
+#include <net.h>
+#include <protocol.h>
+
+#include <cassert>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#ifndef WIN32
+
+/**
+ * Queue of small INV-sized messages, as header and payload entries, the way
+ * CConnman::PushMessage() queues them.
+ */
+static std::deque<std::vector<uint8_t>> MakeSendQueue() {
+    std::deque<std::vector<uint8_t>> queue;
+    for (int i = 0; i < 1000; ++i) {
+        queue.emplace_back(CMessageHeader::HEADER_SIZE, uint8_t(i));
+        queue.emplace_back(37, uint8_t(i));
+    }
+    return queue;
+}
+
+/**
+ * Send the whole queue over a local stream socket which is drained by another
+ * thread, using either one send() per queue entry (as was done before) or
+ * SocketSendQueued(). Per iteration, the former takes 2000 send calls and the
+ * latter about 2000 / MAX_SEND_IOVECS, for the same number of bytes.
+ */
+static void SocketSend(benchmark::State &state, bool vectored) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        assert(false);
+    }
+    std::thread reader([fd = fds[1]] {
+        std::vector<uint8_t> buf(1 << 16);
+        while (recv(fd, buf.data(), buf.size(), 0) > 0) {
+        }
+    });
+
+    const std::deque<std::vector<uint8_t>> fullQueue = MakeSendQueue();
+    BENCHMARK_LOOP {
+        std::deque<std::vector<uint8_t>> queue = fullQueue;
+        size_t offset = 0;
+        while (!queue.empty()) {
+            int n;
+            if (vectored) {
+                n = SocketSendQueued(fds[0], queue, offset);
+            } else {
+                n = send(fds[0], queue.front().data() + offset,
+                         queue.front().size() - offset, MSG_DONTWAIT);
+            }
+            if (n <= 0) {
+                continue;
+            }
+            size_t nLeft = n;
+            while (nLeft > 0 && nLeft >= queue.front().size() - offset) {
+                nLeft -= queue.front().size() - offset;
+                offset = 0;
+                queue.pop_front();
+            }
+            offset += nLeft;
+        }
+    }
+    close(fds[0]);
+    reader.join();
+    close(fds[1]);
+}
+
+static void SocketSendPerEntry(benchmark::State &state) {
+    SocketSend(state, false);
+}
+
+static void SocketSendVectored(benchmark::State &state) {
+    SocketSend(state, true);
+}
+
+BENCHMARK(SocketSendPerEntry, 100);
+BENCHMARK(SocketSendVectored, 100);
+
+#endif // WIN32
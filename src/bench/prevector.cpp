@@ -4,11 +4,15 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <prevector.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
 #include <serialize.h>
 #include <streams.h>
+#include <version.h>
 #include <type_traits>
 
 #include <bench/bench.h>
+#include <bench/data.h>
 
 // GCC 4.8 is missing some C++11 type_traits,
 // https://www.gnu.org/software/gcc/gcc-5/changes.html
@@ -67,6 +71,17 @@ template <typename T> static void PrevectorResize(benchmark::State &state) {
     }
 }
 
+// Create and destroy prevectors holding as much as a P2PKH scriptSig, which
+// does not fit inline.
+template <typename T> static void PrevectorSpill(benchmark::State &state) {
+    BENCHMARK_LOOP {
+        for (auto x = 0; x < 1000; ++x) {
+            prevector<28, T> t0;
+            t0.resize(107);
+        }
+    }
+}
+
 template <typename T>
 static void PrevectorDeserialize(benchmark::State &state) {
     CDataStream s0(SER_NETWORK, 0);
@@ -102,3 +117,27 @@ PREVECTOR_TEST(Clear, 28300, 88600)
 PREVECTOR_TEST(Destructor, 28800, 88900)
 PREVECTOR_TEST(Resize, 28900, 90300)
 PREVECTOR_TEST(Deserialize, 6800, 52000)
+PREVECTOR_TEST(Spill, 3000, 15000)
+
+// Deserialize the transactions of a real block one at a time, as when they are
+// relayed, so that the scripts of each are freed before the next is read.
+static void PrevectorDeserializeBlockTxs(benchmark::State &state) {
+    const std::vector<uint8_t> &data = benchmark::data::Get_block556034();
+    CDataStream stream(data, SER_NETWORK, PROTOCOL_VERSION);
+    char a = '\0';
+    stream.write(&a, 1); // Prevent compaction
+
+    BENCHMARK_LOOP {
+        CBlockHeader header;
+        stream >> header;
+        const uint64_t count = ReadCompactSize(stream);
+        for (uint64_t i = 0; i < count; ++i) {
+            CMutableTransaction tx;
+            stream >> tx;
+        }
+        bool rewound = stream.Rewind(data.size());
+        assert(rewound);
+    }
+}
+
+BENCHMARK(PrevectorDeserializeBlockTxs, 5);
@@ -0,0 +1,77 @@
+// Copyright (c) 2026 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <key.h>
+#include <policy/policy.h>
+#include <psbt.h>
+#include <random.h>
+#include <script/script_execution_context.h>
+#include <script/standard.h>
+
+#include <cassert>
+
+/** A consolidation PSBT spending num_inputs P2PKH coins of a single key. */
+static PartiallySignedTransaction MakeConsolidationPSBT(FlatSigningProvider &provider, size_t num_inputs) {
+    CKey key;
+    key.MakeNewKey(true);
+    const CPubKey pubkey = key.GetPubKey();
+    provider.pubkeys.emplace(pubkey.GetID(), pubkey);
+    provider.keys.emplace(pubkey.GetID(), key);
+    const CScript script = GetScriptForDestination(pubkey.GetID());
+
+    CMutableTransaction mtx;
+    for (size_t i = 0; i < num_inputs; ++i) {
+        mtx.vin.emplace_back(COutPoint(TxId(GetRandHash()), 0));
+    }
+    mtx.vout.emplace_back(int64_t(num_inputs) * COIN, script);
+
+    PartiallySignedTransaction psbt{CTransaction(mtx)};
+    for (PSBTInput &input : psbt.inputs) {
+        input.utxo = CTxOut(COIN, script);
+    }
+    return psbt;
+}
+
+/** Sign all inputs of a 1000 input PSBT, as walletprocesspsbt does. */
+static void PSBTSignInputs(benchmark::State &state) {
+    FlatSigningProvider provider;
+    const PartiallySignedTransaction unsigned_psbt = MakeConsolidationPSBT(provider, 1000);
+    BENCHMARK_LOOP {
+        PartiallySignedTransaction psbt = unsigned_psbt;
+        const bool complete = SignPSBTInputs(provider, psbt, STANDARD_SCRIPT_VERIFY_FLAGS, SigHashType().withFork());
+        assert(complete);
+    }
+}
+
+/** Finalize all inputs of a signed 1000 input PSBT, verifying their signatures. */
+static void PSBTFinalizeInputs(benchmark::State &state) {
+    FlatSigningProvider provider;
+    PartiallySignedTransaction signed_psbt = MakeConsolidationPSBT(provider, 1000);
+    SignPSBTInputs(provider, signed_psbt, STANDARD_SCRIPT_VERIFY_FLAGS, SigHashType().withFork());
+    // Turn the final P2PKH scripts back into partial signatures, so that they
+    // are rebuilt and verified.
+    const CPubKey &pubkey = provider.pubkeys.begin()->second;
+    for (PSBTInput &input : signed_psbt.inputs) {
+        CScript::const_iterator pc = input.final_script_sig.begin();
+        opcodetype opcode;
+        std::vector<uint8_t> sig;
+        const bool ok = input.final_script_sig.GetOp(pc, opcode, sig);
+        assert(ok);
+        input.partial_sigs.emplace(pubkey.GetID(), SigPair(pubkey, sig));
+        input.final_script_sig.clear();
+    }
+    BENCHMARK_LOOP {
+        PartiallySignedTransaction psbt = signed_psbt;
+        const auto contexts = ScriptExecutionContext::createForAllInputs(*psbt.tx, psbt.inputs);
+        // P2PKH scripts can only be finalized with a provider of the public
+        // key, so hide the private key instead of using no provider.
+        const bool complete = SignPSBTInputs(HidingSigningProvider(&provider, true, false), psbt,
+                                             STANDARD_SCRIPT_VERIFY_FLAGS, SigHashType().withFork(), contexts);
+        assert(complete);
+    }
+}
+
+BENCHMARK(PSBTSignInputs, 2);
+BENCHMARK(PSBTFinalizeInputs, 2);
@@ -14,7 +14,9 @@
 #include <rpc/client.h>
 #include <rpc/protocol.h>
 #include <support/events.h>
+#include <sync.h>
 #include <util/strencodings.h>
+#include <util/string.h>
 #include <util/system.h>
 
 #include <event2/buffer.h>
@@ -22,8 +24,13 @@
 
 #include <univalue.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstdio>
 #include <memory>
+#include <optional>
+#include <thread>
 #include <tuple>
 
 const std::function<std::string(const char *)> G_TRANSLATION_FUN = nullptr;
@@ -31,6 +38,8 @@ const std::function<std::string(const char *)> G_TRANSLATION_FUN = nullptr;
 static const char DEFAULT_RPCCONNECT[] = "127.0.0.1";
 static const int DEFAULT_HTTP_CLIENT_TIMEOUT = 900;
 static const bool DEFAULT_NAMED = false;
+static const int DEFAULT_BULK_BATCH_SIZE = 100;
+static const int DEFAULT_BULK_CONNECTIONS = 4;
 static const int CONTINUE_EXECUTION = -1;
 
 static void SetupCliArgs() {
@@ -107,6 +116,25 @@ static void SetupCliArgs() {
                  "EOF/Ctrl-D (recommended for sensitive information such as "
                  "passphrases)",
                  ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    gArgs.AddArg(
+        "-bulk",
+        "Read commands from standard input, one per line with the command and "
+        "its arguments separated by whitespace, until EOF/Ctrl-D. The commands "
+        "are sent as JSON-RPC batches over kept-alive connections, and their "
+        "results are printed in order, one per line, with errors printed as "
+        "\"error: \" followed by the JSON error object. Blank lines are "
+        "skipped.",
+        ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-bulkbatchsize=<n>",
+                 strprintf("Number of commands sent per JSON-RPC batch in "
+                           "-bulk mode (default: %d)",
+                           DEFAULT_BULK_BATCH_SIZE),
+                 ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-bulkconnections=<n>",
+                 strprintf("Number of parallel connections used in -bulk mode "
+                           "(default: %d)",
+                           DEFAULT_BULK_CONNECTIONS),
+                 ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg(
         "-rpcwallet=<walletname>",
         "Send RPC for non-default wallet on RPC server (needs to exactly match "
@@ -210,6 +238,9 @@ struct HTTPReply {
     int status;
     int error;
     std::string body;
+    //! Event loop to break out of once the request is done, so that a
+    //! kept-alive connection does not keep it running
+    struct event_base *base = nullptr;
 };
 
 static const char *http_errorstring(int code) {
@@ -235,6 +266,9 @@ static const char *http_errorstring(int code) {
 
 static void http_request_done(struct evhttp_request *req, void *ctx) {
     HTTPReply *reply = static_cast<HTTPReply *>(ctx);
+    if (reply->base) {
+        event_base_loopbreak(reply->base);
+    }
 
     if (req == nullptr) {
         /**
@@ -354,136 +388,329 @@ public:
     }
 };
 
-static UniValue CallRPC(BaseRequestHandler *rh, const std::string &strMethod,
-                        const std::vector<std::string> &args) {
-    std::string host;
-    // In preference order, we choose the following for the port:
-    //     1. -rpcport
-    //     2. port in -rpcconnect (ie following : in ipv4 or ]: in ipv6)
-    //     3. default port for chain
-    int port = BaseParams().RPCPort();
-    SplitHostPort(gArgs.GetArg("-rpcconnect", DEFAULT_RPCCONNECT), port, host);
-    port = gArgs.GetArg("-rpcport", port);
-
-    // Obtain event base
-    raii_event_base base = obtain_event_base();
-
-    // Synchronously look up hostname
-    raii_evhttp_connection evcon =
-        obtain_evhttp_connection_base(base.get(), host, port);
-    evhttp_connection_set_timeout(
-        evcon.get(),
-        gArgs.GetArg("-rpcclienttimeout", DEFAULT_HTTP_CLIENT_TIMEOUT));
+/**
+ * Connection to the RPC server. With keepAlive, consecutive requests are sent
+ * over the same HTTP connection.
+ */
+class RPCConnection {
+public:
+    explicit RPCConnection(bool _keepAlive) : keepAlive(_keepAlive) {
+        // In preference order, we choose the following for the port:
+        //     1. -rpcport
+        //     2. port in -rpcconnect (ie following : in ipv4 or ]: in ipv6)
+        //     3. default port for chain
+        port = BaseParams().RPCPort();
+        SplitHostPort(gArgs.GetArg("-rpcconnect", DEFAULT_RPCCONNECT), port,
+                      host);
+        port = gArgs.GetArg("-rpcport", port);
+
+        // Synchronously look up hostname
+        evcon = obtain_evhttp_connection_base(base.get(), host, port);
+        evhttp_connection_set_timeout(
+            evcon.get(),
+            gArgs.GetArg("-rpcclienttimeout", DEFAULT_HTTP_CLIENT_TIMEOUT));
+
+        // Get credentials
+        if (gArgs.GetArg("-rpcpassword", "") == "") {
+            // Try fall back to cookie-based authentication if no password is
+            // provided
+            if (!GetAuthCookie(&strRPCUserColonPass)) {
+                failedToGetAuthCookie = true;
+            }
+        } else {
+            strRPCUserColonPass = gArgs.GetArg("-rpcuser", "") + ":" +
+                                  gArgs.GetArg("-rpcpassword", "");
+        }
 
-    HTTPReply response;
-    raii_evhttp_request req =
-        obtain_evhttp_request(http_request_done, (void *)&response);
-    if (req == nullptr) {
-        throw std::runtime_error("create http request failed");
+        // check if we should use a special wallet endpoint
+        if (!gArgs.GetArgs("-rpcwallet").empty()) {
+            std::string walletName = gArgs.GetArg("-rpcwallet", "");
+            char *encodedURI =
+                evhttp_uriencode(walletName.c_str(), walletName.size(), false);
+            if (encodedURI) {
+                endpoint = "/wallet/" + std::string(encodedURI);
+                free(encodedURI);
+            } else {
+                throw CConnectionFailed("uri-encode failed");
+            }
+        }
     }
+
+    /** Send a request and return the parsed reply. */
+    UniValue Send(const UniValue &request) {
+        HTTPReply response;
+        response.base = base.get();
+        raii_evhttp_request req =
+            obtain_evhttp_request(http_request_done, (void *)&response);
+        if (req == nullptr) {
+            throw std::runtime_error("create http request failed");
+        }
 #if LIBEVENT_VERSION_NUMBER >= 0x02010300
-    evhttp_request_set_error_cb(req.get(), http_error_cb);
+        evhttp_request_set_error_cb(req.get(), http_error_cb);
 #endif
 
-    // Get credentials
-    std::string strRPCUserColonPass;
-    bool failedToGetAuthCookie = false;
-    if (gArgs.GetArg("-rpcpassword", "") == "") {
-        // Try fall back to cookie-based authentication if no password is
-        // provided
-        if (!GetAuthCookie(&strRPCUserColonPass)) {
-            failedToGetAuthCookie = true;
+        struct evkeyvalq *output_headers =
+            evhttp_request_get_output_headers(req.get());
+        assert(output_headers);
+        evhttp_add_header(output_headers, "Host", host.c_str());
+        if (!keepAlive) {
+            evhttp_add_header(output_headers, "Connection", "close");
+        }
+        evhttp_add_header(
+            output_headers, "Authorization",
+            (std::string("Basic ") + EncodeBase64(strRPCUserColonPass))
+                .c_str());
+
+        // Attach request data
+        std::string strRequest = UniValue::stringify(request) + "\n";
+        struct evbuffer *output_buffer =
+            evhttp_request_get_output_buffer(req.get());
+        assert(output_buffer);
+        evbuffer_add(output_buffer, strRequest.data(), strRequest.size());
+
+        int r = evhttp_make_request(evcon.get(), req.get(), EVHTTP_REQ_POST,
+                                    endpoint.c_str());
+        // ownership moved to evcon in above call
+        req.release();
+        if (r != 0) {
+            throw CConnectionFailed("send http request failed");
+        }
+
+        event_base_dispatch(base.get());
+
+        if (response.status == 0) {
+            std::string responseErrorMessage;
+            if (response.error != -1) {
+                responseErrorMessage =
+                    strprintf(" (error code %d - \"%s\")", response.error,
+                              http_errorstring(response.error));
+            }
+            throw CConnectionFailed(strprintf(
+                "Could not connect to the server %s:%d%s\n\nMake sure the "
+                "bitcoind server is running and that you are connecting to "
+                "the correct RPC port.",
+                host, port, responseErrorMessage));
+        } else if (response.status == HTTP_UNAUTHORIZED) {
+            if (failedToGetAuthCookie) {
+                throw std::runtime_error(strprintf(
+                    "Could not locate RPC credentials. No authentication "
+                    "cookie could be found, and RPC password is not set.  See "
+                    "-rpcpassword and -stdinrpcpass.  Configuration file: (%s)",
+                    GetConfigFile(gArgs.GetArg("-conf", BITCOIN_CONF_FILENAME))
+                        .string()
+                        .c_str()));
+            } else {
+                throw std::runtime_error(
+                    "Authorization failed: Incorrect rpcuser or rpcpassword");
+            }
+        } else if (response.status >= 400 &&
+                   response.status != HTTP_BAD_REQUEST &&
+                   response.status != HTTP_NOT_FOUND &&
+                   response.status != HTTP_INTERNAL_SERVER_ERROR) {
+            throw std::runtime_error(
+                strprintf("server returned HTTP error %d", response.status));
+        } else if (response.body.empty()) {
+            throw std::runtime_error("no response from server");
+        }
+
+        // Parse reply
+        UniValue valReply(UniValue::VSTR);
+        if (!valReply.read(response.body)) {
+            throw std::runtime_error("couldn't parse reply from server");
         }
-    } else {
-        strRPCUserColonPass = gArgs.GetArg("-rpcuser", "") + ":" +
-                              gArgs.GetArg("-rpcpassword", "");
+        return valReply;
     }
 
-    struct evkeyvalq *output_headers =
-        evhttp_request_get_output_headers(req.get());
-    assert(output_headers);
-    evhttp_add_header(output_headers, "Host", host.c_str());
-    evhttp_add_header(output_headers, "Connection", "close");
-    evhttp_add_header(
-        output_headers, "Authorization",
-        (std::string("Basic ") + EncodeBase64(strRPCUserColonPass)).c_str());
-
-    // Attach request data
-    std::string strRequest = UniValue::stringify(rh->PrepareRequest(strMethod, args)) + "\n";
-    struct evbuffer *output_buffer =
-        evhttp_request_get_output_buffer(req.get());
-    assert(output_buffer);
-    evbuffer_add(output_buffer, strRequest.data(), strRequest.size());
-
-    // check if we should use a special wallet endpoint
+private:
+    const bool keepAlive;
+    std::string host;
+    int port;
+    // Obtain event base
+    raii_event_base base = obtain_event_base();
+    raii_evhttp_connection evcon;
+    std::string strRPCUserColonPass;
+    bool failedToGetAuthCookie = false;
     std::string endpoint = "/";
-    if (!gArgs.GetArgs("-rpcwallet").empty()) {
-        std::string walletName = gArgs.GetArg("-rpcwallet", "");
-        char *encodedURI =
-            evhttp_uriencode(walletName.c_str(), walletName.size(), false);
-        if (encodedURI) {
-            endpoint = "/wallet/" + std::string(encodedURI);
-            free(encodedURI);
-        } else {
-            throw CConnectionFailed("uri-encode failed");
+};
+
+static UniValue CallRPC(BaseRequestHandler *rh, const std::string &strMethod,
+                        const std::vector<std::string> &args) {
+    RPCConnection connection(false);
+    UniValue reply =
+        rh->ProcessReply(connection.Send(rh->PrepareRequest(strMethod, args)));
+    if (reply.empty()) {
+        throw std::runtime_error(
+            "expected reply to have result, error and id properties");
+    }
+
+    return reply;
+}
+
+/** Format the reply to one command in -bulk mode as a single line. */
+static std::string FormatBulkReply(const UniValue &reply, int &nRet) {
+    const UniValue &error = reply["error"];
+    if (!error.isNull()) {
+        if (nRet == 0) {
+            nRet = error.isObject() && error["code"].isNum()
+                       ? abs(error["code"].get_int())
+                       : EXIT_FAILURE;
         }
+        return "error: " + UniValue::stringify(error);
     }
-    int r = evhttp_make_request(evcon.get(), req.get(), EVHTTP_REQ_POST,
-                                endpoint.c_str());
-    // ownership moved to evcon in above call
-    req.release();
-    if (r != 0) {
-        throw CConnectionFailed("send http request failed");
+    const UniValue &result = reply["result"];
+    if (result.isNull()) {
+        return "";
     }
+    if (result.isStr()) {
+        return result.get_str();
+    }
+    return UniValue::stringify(result);
+}
 
-    event_base_dispatch(base.get());
-
-    if (response.status == 0) {
-        std::string responseErrorMessage;
-        if (response.error != -1) {
-            responseErrorMessage =
-                strprintf(" (error code %d - \"%s\")", response.error,
-                          http_errorstring(response.error));
+/**
+ * Send the commands read from standard input as JSON-RPC batches of
+ * -bulkbatchsize commands, spread over -bulkconnections connections, and
+ * print the results in order as soon as all earlier ones are printed.
+ */
+static int BulkRPC() {
+    const bool named = gArgs.GetBoolArg("-named", DEFAULT_NAMED);
+    const size_t batchSize = std::max<int64_t>(
+        1, gArgs.GetArg("-bulkbatchsize", DEFAULT_BULK_BATCH_SIZE));
+    const size_t nConnections = std::max<int64_t>(
+        1, gArgs.GetArg("-bulkconnections", DEFAULT_BULK_CONNECTIONS));
+
+    // Convert every command to a request, with its index in its batch as id.
+    // Commands whose arguments cannot be converted are not sent, and their
+    // reply is the conversion error.
+    std::vector<UniValue> requests;
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::vector<std::string> args;
+        Split(args, TrimString(line), " \f\n\r\t\v", true);
+        if (args.empty() || args[0].empty()) {
+            continue;
         }
-        throw CConnectionFailed(
-            strprintf("Could not connect to the server %s:%d%s\n\nMake sure "
-                      "the bitcoind server is running and that you are "
-                      "connecting to the correct RPC port.",
-                      host, port, responseErrorMessage));
-    } else if (response.status == HTTP_UNAUTHORIZED) {
-        if (failedToGetAuthCookie) {
-            throw std::runtime_error(strprintf(
-                "Could not locate RPC credentials. No authentication cookie "
-                "could be found, and RPC password is not set.  See "
-                "-rpcpassword and -stdinrpcpass.  Configuration file: (%s)",
-                GetConfigFile(gArgs.GetArg("-conf", BITCOIN_CONF_FILENAME))
-                    .string()
-                    .c_str()));
-        } else {
-            throw std::runtime_error(
-                "Authorization failed: Incorrect rpcuser or rpcpassword");
+        const std::string method = args[0];
+        args.erase(args.begin());
+        const int id = requests.size() % batchSize;
+        try {
+            requests.emplace_back(JSONRPCRequestObj(
+                std::string(method),
+                named ? UniValue(RPCConvertNamedValues(method, args))
+                      : UniValue(RPCConvertValues(method, args)),
+                id));
+        } catch (const std::exception &e) {
+            requests.emplace_back(JSONRPCReplyObj(
+                UniValue(), JSONRPCError(RPC_PARSE_ERROR, e.what()).toObj(),
+                id));
         }
-    } else if (response.status >= 400 && response.status != HTTP_BAD_REQUEST &&
-               response.status != HTTP_NOT_FOUND &&
-               response.status != HTTP_INTERNAL_SERVER_ERROR) {
-        throw std::runtime_error(
-            strprintf("server returned HTTP error %d", response.status));
-    } else if (response.body.empty()) {
-        throw std::runtime_error("no response from server");
     }
 
-    // Parse reply
-    UniValue valReply(UniValue::VSTR);
-    if (!valReply.read(response.body)) {
-        throw std::runtime_error("couldn't parse reply from server");
+    auto IsReply = [](const UniValue &request) {
+        return request.locate("error") != nullptr;
+    };
+
+    const size_t nBatches = (requests.size() + batchSize - 1) / batchSize;
+    Mutex cs;
+    std::condition_variable cond;
+    // Output lines of every batch, once it is done
+    std::vector<std::optional<std::vector<std::string>>> outputs(nBatches);
+    std::string failure;
+    int nRet = 0;
+    std::atomic<size_t> nextBatch{0};
+
+    auto worker = [&]() {
+        try {
+            std::optional<RPCConnection> connection;
+            size_t i;
+            while ((i = nextBatch++) < nBatches) {
+                {
+                    LOCK(cs);
+                    if (!failure.empty()) {
+                        return;
+                    }
+                }
+                const size_t begin = i * batchSize;
+                const size_t end = std::min(begin + batchSize, requests.size());
+                UniValue::Array batch;
+                for (size_t j = begin; j < end; ++j) {
+                    if (!IsReply(requests[j])) {
+                        batch.push_back(requests[j]);
+                    }
+                }
+
+                std::vector<UniValue> replies;
+                if (!batch.empty()) {
+                    const UniValue request(std::move(batch));
+                    const bool fWait = gArgs.GetBoolArg("-rpcwait", false);
+                    while (true) {
+                        try {
+                            if (!connection) {
+                                connection.emplace(true);
+                            }
+                            replies = JSONRPCProcessBatchReply(
+                                connection->Send(request), end - begin);
+                            break;
+                        } catch (const CConnectionFailed &) {
+                            connection.reset();
+                            if (!fWait) {
+                                throw;
+                            }
+                            MilliSleep(1000);
+                        }
+                    }
+                }
+
+                std::vector<std::string> lines;
+                LOCK(cs);
+                for (size_t j = begin; j < end; ++j) {
+                    const UniValue &reply =
+                        IsReply(requests[j]) ? requests[j] : replies[j - begin];
+                    lines.push_back(FormatBulkReply(reply, nRet));
+                }
+                outputs[i] = std::move(lines);
+                cond.notify_all();
+            }
+        } catch (const std::exception &e) {
+            LOCK(cs);
+            if (failure.empty()) {
+                failure = e.what();
+            }
+            cond.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < std::min(nConnections, nBatches); ++i) {
+        threads.emplace_back(worker);
     }
-    UniValue reply = rh->ProcessReply(valReply);
-    if (reply.empty()) {
-        throw std::runtime_error(
-            "expected reply to have result, error and id properties");
+
+    for (size_t i = 0; i < nBatches; ++i) {
+        std::vector<std::string> lines;
+        {
+            WAIT_LOCK(cs, lock);
+            cond.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(cs) {
+                return outputs[i] || !failure.empty();
+            });
+            if (!outputs[i]) {
+                break;
+            }
+            lines.swap(*outputs[i]);
+        }
+        for (const std::string &output : lines) {
+            fprintf(stdout, "%s\n", output.c_str());
+        }
+        fflush(stdout);
     }
 
-    return reply;
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    if (!failure.empty()) {
+        fprintf(stderr, "error: %s\n", failure.c_str());
+        return EXIT_FAILURE;
+    }
+    return nRet;
 }
 
 static int CommandLineRPC(int argc, char *argv[]) {
@@ -505,6 +732,15 @@ static int CommandLineRPC(int argc, char *argv[]) {
         }
         std::vector<std::string> args =
             std::vector<std::string>(&argv[1], &argv[argc]);
+        if (gArgs.GetBoolArg("-bulk", false)) {
+            if (!args.empty() || gArgs.GetBoolArg("-stdin", false) ||
+                gArgs.GetBoolArg("-getinfo", false)) {
+                throw std::runtime_error("-bulk reads all commands from "
+                                         "standard input and takes no "
+                                         "arguments, -stdin or -getinfo");
+            }
+            return BulkRPC();
+        }
         if (gArgs.GetBoolArg("-stdin", false)) {
             // Read one arg per line from stdin and append
             std::string line;
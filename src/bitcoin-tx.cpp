@@ -27,18 +27,41 @@
 
 #include <univalue.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
+#include <fstream>
+#include <iostream>
 #include <memory>
+#include <thread>
+
+/** JSON registers set by the set and load commands, by name. */
+using Registers = std::map<std::string, UniValue>;
 
 static bool fCreateBlank;
-static std::map<std::string, UniValue> registers;
 static const int CONTINUE_EXECUTION = -1;
+/** Number of batch jobs read and processed at once in -batch mode. */
+static const size_t BATCH_CHUNK_SIZE = 1024;
 
 const std::function<std::string(const char *)> G_TRANSLATION_FUN = nullptr;
 
 static void SetupBitcoinTxArgs() {
     SetupHelpOptions(gArgs);
 
+    gArgs.AddArg("-batch=<file>",
+                 "Read transaction jobs from <file>, or from standard input if "
+                 "<file> is \"-\", one per line. A job is a hex-encoded "
+                 "transaction (omitted with -create) followed by commands, "
+                 "separated by whitespace. Jobs are processed in parallel, and "
+                 "the resulting transactions are written in order, one per "
+                 "line, with failed jobs written as \"error: \" followed by "
+                 "the error message. Blank lines are skipped. Register "
+                 "commands on the command line apply to every job.",
+                 ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-batchthreads=<n>",
+                 "Number of threads processing jobs in -batch mode (default: "
+                 "number of cores)",
+                 ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-create", "Create new, empty TX.", ArgsManager::ALLOW_ANY,
                  OptionsCategory::OPTIONS);
     gArgs.AddArg("-json", "Select JSON output", ArgsManager::ALLOW_ANY,
@@ -142,6 +165,8 @@ static int AppInitRawTx(int argc, char *argv[], Config &config) {
             "hex-encoded bitcoin transaction\n" +
             "or:     bitcoin-tx [options] -create [commands]   Create "
             "hex-encoded bitcoin transaction\n" +
+            "or:     bitcoin-tx [options] -batch=<file> [register commands]  "
+            "Create or update hex-encoded bitcoin transactions in bulk\n" +
             "\n";
         strUsage += gArgs.GetHelpMessage();
         fprintf(stdout, "%s", strUsage.c_str());
@@ -157,7 +182,7 @@ static int AppInitRawTx(int argc, char *argv[], Config &config) {
     return CONTINUE_EXECUTION;
 }
 
-static void RegisterSetJson(const std::string &key,
+static void RegisterSetJson(Registers &registers, const std::string &key,
                             const std::string &rawJson) {
     UniValue val;
     if (!val.read(rawJson)) {
@@ -168,7 +193,7 @@ static void RegisterSetJson(const std::string &key,
     registers[key] = val;
 }
 
-static void RegisterSet(const std::string &strInput) {
+static void RegisterSet(Registers &registers, const std::string &strInput) {
     // separate NAME:VALUE in string
     size_t pos = strInput.find(':');
     if ((pos == std::string::npos) || (pos == 0) ||
@@ -179,10 +204,10 @@ static void RegisterSet(const std::string &strInput) {
     std::string key = strInput.substr(0, pos);
     std::string valStr = strInput.substr(pos + 1, std::string::npos);
 
-    RegisterSetJson(key, valStr);
+    RegisterSetJson(registers, key, valStr);
 }
 
-static void RegisterLoad(const std::string &strInput) {
+static void RegisterLoad(Registers &registers, const std::string &strInput) {
     // separate NAME:FILENAME in string
     size_t pos = strInput.find(':');
     if ((pos == std::string::npos) || (pos == 0) ||
@@ -220,7 +245,7 @@ static void RegisterLoad(const std::string &strInput) {
     }
 
     // evaluate as JSON buffer register
-    RegisterSetJson(key, valStr);
+    RegisterSetJson(registers, key, valStr);
 }
 
 static Amount ExtractAndValidateValue(const std::string &strValue) {
@@ -582,7 +607,8 @@ static Amount AmountFromValue(const UniValue &value) {
     return amount;
 }
 
-static void MutateTxSign(CMutableTransaction &tx, const std::string &flagStr) {
+static void MutateTxSign(CMutableTransaction &tx, const std::string &flagStr,
+                         Registers &registers) {
     SigHashType sigHashType = SigHashType().withFork();
 
     if ((flagStr.size() > 0) && !findSigHashFlags(sigHashType, flagStr)) {
@@ -733,9 +759,14 @@ public:
 };
 
 static void MutateTx(CMutableTransaction &tx, const std::string &command,
-                     const std::string &commandVal,
-                     const CChainParams &chainParams) {
+                     const std::string &commandVal, Registers &registers,
+                     const CChainParams &chainParams, bool eccStarted = false) {
     std::unique_ptr<Secp256k1Init> ecc;
+    const auto startECC = [&] {
+        if (!eccStarted) {
+            ecc.reset(new Secp256k1Init());
+        }
+    };
 
     if (command == "nversion") {
         MutateTxVersion(tx, commandVal);
@@ -750,22 +781,22 @@ static void MutateTx(CMutableTransaction &tx, const std::string &command,
     } else if (command == "outaddr") {
         MutateTxAddOutAddr(tx, commandVal, chainParams);
     } else if (command == "outpubkey") {
-        ecc.reset(new Secp256k1Init());
+        startECC();
         MutateTxAddOutPubKey(tx, commandVal);
     } else if (command == "outmultisig") {
-        ecc.reset(new Secp256k1Init());
+        startECC();
         MutateTxAddOutMultiSig(tx, commandVal);
     } else if (command == "outscript") {
         MutateTxAddOutScript(tx, commandVal);
     } else if (command == "outdata") {
         MutateTxAddOutData(tx, commandVal);
     } else if (command == "sign") {
-        ecc.reset(new Secp256k1Init());
-        MutateTxSign(tx, commandVal);
+        startECC();
+        MutateTxSign(tx, commandVal, registers);
     } else if (command == "load") {
-        RegisterLoad(commandVal);
+        RegisterLoad(registers, commandVal);
     } else if (command == "set") {
-        RegisterSet(commandVal);
+        RegisterSet(registers, commandVal);
     } else if (command == "sort") {
         MutateTxSort(tx, commandVal);
     } else {
@@ -773,34 +804,35 @@ static void MutateTx(CMutableTransaction &tx, const std::string &command,
     }
 }
 
-static void OutputTxJSON(const Config &config, const CTransaction &tx) {
-    UniValue::Object entry = TxToUniv(config, tx, uint256());
-
-    std::string jsonOutput = UniValue::stringify(entry, 4);
-    fprintf(stdout, "%s\n", jsonOutput.c_str());
-}
-
-static void OutputTxHash(const CTransaction &tx) {
-    // the hex-encoded transaction id.
-    std::string strHexHash = tx.GetId().GetHex();
-
-    fprintf(stdout, "%s\n", strHexHash.c_str());
+/** Split a COMMAND=VALUE argument into its command and value. */
+static std::pair<std::string, std::string>
+SplitCommand(const std::string &arg) {
+    size_t eqpos = arg.find('=');
+    if (eqpos == std::string::npos) {
+        return {arg, ""};
+    }
+    return {arg.substr(0, eqpos), arg.substr(eqpos + 1)};
 }
 
-static void OutputTxHex(const CTransaction &tx) {
-    std::string strHex = EncodeHexTx(tx);
-
-    fprintf(stdout, "%s\n", strHex.c_str());
+/**
+ * Format a transaction as selected by -json and -txid. JSON output is
+ * indented by jsonIndent spaces, or on a single line if it is 0.
+ */
+static std::string FormatTx(const Config &config, const CTransaction &tx,
+                            unsigned int jsonIndent) {
+    if (gArgs.GetBoolArg("-json", false)) {
+        return UniValue::stringify(TxToUniv(config, tx, uint256()),
+                                   jsonIndent);
+    }
+    if (gArgs.GetBoolArg("-txid", false)) {
+        // the hex-encoded transaction id.
+        return tx.GetId().GetHex();
+    }
+    return EncodeHexTx(tx);
 }
 
 static void OutputTx(const Config &config, const CTransaction &tx) {
-    if (gArgs.GetBoolArg("-json", false)) {
-        OutputTxJSON(config, tx);
-    } else if (gArgs.GetBoolArg("-txid", false)) {
-        OutputTxHash(tx);
-    } else {
-        OutputTxHex(tx);
-    }
+    fprintf(stdout, "%s\n", FormatTx(config, tx, 4).c_str());
 }
 
 static std::string readStdin() {
@@ -833,6 +865,7 @@ static int CommandLineRawTx(int argc, char *argv[], const Config &config, const
         }
 
         CMutableTransaction tx;
+        Registers registers;
         int startArg;
 
         if (!fCreateBlank) {
@@ -859,17 +892,8 @@ static int CommandLineRawTx(int argc, char *argv[], const Config &config, const
         }
 
         for (int i = startArg; i < argc; i++) {
-            std::string arg = argv[i];
-            std::string key, value;
-            size_t eqpos = arg.find('=');
-            if (eqpos == std::string::npos) {
-                key = arg;
-            } else {
-                key = arg.substr(0, eqpos);
-                value = arg.substr(eqpos + 1);
-            }
-
-            MutateTx(tx, key, value, chainParams);
+            const auto [key, value] = SplitCommand(argv[i]);
+            MutateTx(tx, key, value, registers, chainParams);
         }
 
         OutputTx(config, CTransaction(tx));
@@ -888,6 +912,134 @@ static int CommandLineRawTx(int argc, char *argv[], const Config &config, const
     return nRet;
 }
 
+/**
+ * Process one -batch job: decode its transaction, or start from a blank one
+ * with -create, apply its commands with a copy of the command line registers,
+ * and return the formatted result. ECC must already be started.
+ */
+static std::string ProcessBatchJob(const std::string &job,
+                                   const Registers &defaultRegisters,
+                                   const Config &config,
+                                   const CChainParams &chainParams) {
+    std::vector<std::string> args;
+    Split(args, job, " \f\n\r\t\v", true);
+
+    CMutableTransaction tx;
+    Registers registers{defaultRegisters};
+    auto it = args.begin();
+    if (!fCreateBlank) {
+        if (!DecodeHexTx(tx, *it)) {
+            throw std::runtime_error("invalid transaction encoding");
+        }
+        ++it;
+    }
+    for (; it != args.end(); ++it) {
+        const auto [key, value] = SplitCommand(*it);
+        MutateTx(tx, key, value, registers, chainParams, true);
+    }
+
+    return FormatTx(config, CTransaction(tx), 0);
+}
+
+/**
+ * Process the jobs read from -batch in chunks of BATCH_CHUNK_SIZE, each chunk
+ * being spread over -batchthreads threads, and write the results of every
+ * chunk in input order before reading the next one.
+ */
+static int BatchRawTx(int argc, char *argv[], const Config &config,
+                      const CChainParams &chainParams) {
+    int nRet = 0;
+    try {
+        // Skip switches
+        while (argc > 1 && IsSwitchChar(argv[1][0])) {
+            argc--;
+            argv++;
+        }
+
+        // Register commands on the command line apply to every job.
+        Registers defaultRegisters;
+        for (int i = 1; i < argc; i++) {
+            const auto [key, value] = SplitCommand(argv[i]);
+            if (key == "set") {
+                RegisterSet(defaultRegisters, value);
+            } else if (key == "load") {
+                RegisterLoad(defaultRegisters, value);
+            } else {
+                throw std::runtime_error(
+                    "only register commands can be given on the command "
+                    "line with -batch");
+            }
+        }
+
+        const std::string path = gArgs.GetArg("-batch", "");
+        std::ifstream file;
+        if (path != "-") {
+            file.open(path);
+            if (!file.is_open()) {
+                throw std::runtime_error("Cannot open file " + path);
+            }
+        }
+        std::istream &input = path == "-" ? std::cin : file;
+
+        const size_t nThreads = std::max<int64_t>(
+            1, gArgs.GetArg("-batchthreads", GetNumCores()));
+        Secp256k1Init ecc;
+
+        std::vector<std::string> jobs;
+        std::vector<std::string> results;
+        std::vector<char> failed;
+        std::string line;
+        while (input) {
+            jobs.clear();
+            while (jobs.size() < BATCH_CHUNK_SIZE && std::getline(input, line)) {
+                line = TrimString(line);
+                if (!line.empty()) {
+                    jobs.push_back(std::move(line));
+                }
+            }
+            if (input.bad()) {
+                throw std::runtime_error("error reading " + path);
+            }
+
+            results.assign(jobs.size(), std::string());
+            failed.assign(jobs.size(), false);
+            std::atomic<size_t> next{0};
+            const auto worker = [&] {
+                for (size_t i = next++; i < jobs.size(); i = next++) {
+                    try {
+                        results[i] = ProcessBatchJob(jobs[i], defaultRegisters,
+                                                     config, chainParams);
+                    } catch (const std::exception &e) {
+                        results[i] = std::string("error: ") + e.what();
+                        failed[i] = true;
+                    }
+                }
+            };
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < std::min(nThreads, jobs.size()); ++i) {
+                threads.emplace_back(worker);
+            }
+            worker();
+            for (std::thread &thread : threads) {
+                thread.join();
+            }
+
+            for (size_t i = 0; i < jobs.size(); ++i) {
+                fprintf(stdout, "%s\n", results[i].c_str());
+                if (failed[i]) {
+                    nRet = EXIT_FAILURE;
+                }
+            }
+            fflush(stdout);
+        }
+    } catch (const std::exception &e) {
+        fprintf(stderr, "error: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return nRet;
+}
+
 int main(int argc, char *argv[]) {
 
     auto &config = const_cast<Config &>(GetConfig());
@@ -911,7 +1063,11 @@ int main(int argc, char *argv[]) {
 
     int ret = EXIT_FAILURE;
     try {
-        ret = CommandLineRawTx(argc, argv, config, Params());
+        if (gArgs.IsArgSet("-batch")) {
+            ret = BatchRawTx(argc, argv, config, Params());
+        } else {
+            ret = CommandLineRawTx(argc, argv, config, Params());
+        }
     } catch (const std::exception &e) {
         PrintExceptionContinue(&e, "CommandLineRawTx()");
     } catch (...) {
@@ -17,8 +17,12 @@
 #include <util/system.h>
 #include <validation.h>
 
+#include <array>
 #include <unordered_map>
 
+/** Number of short IDs computed at once when scanning for transactions. */
+static constexpr size_t SHORTID_BATCH_SIZE = 16;
+
 CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock &block)
     : nonce(GetRand(std::numeric_limits<uint64_t>::max())),
       shorttxids(block.vtx.size() - 1), prefilledtxn(1), header(block) {
@@ -26,10 +30,12 @@ CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock &block)
     // TODO: Use our mempool prior to block acceptance to predictively fill more
     // than just the coinbase.
     prefilledtxn[0] = {0, block.vtx[0]};
+    std::vector<TxHash> txhashes;
+    txhashes.reserve(shorttxids.size());
     for (size_t i = 1; i < block.vtx.size(); i++) {
-        const CTransaction &tx = *block.vtx[i];
-        shorttxids[i - 1] = GetShortID(tx.GetHash());
+        txhashes.push_back(block.vtx[i]->GetHash());
     }
+    GetShortIDs(txhashes.data(), txhashes.size(), shorttxids.data());
 }
 
 void CBlockHeaderAndShortTxIDs::FillShortTxIDSelector() {
@@ -49,6 +55,22 @@ uint64_t CBlockHeaderAndShortTxIDs::GetShortID(const TxHash &txhash) const {
     return SipHashUint256(shorttxidk0, shorttxidk1, txhash) & 0xffffffffffffL;
 }
 
+void CBlockHeaderAndShortTxIDs::GetShortIDs(const TxHash *txhashes, size_t n,
+                                            uint64_t *out) const {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const uint256 *const vals[4] = {&txhashes[i], &txhashes[i + 1],
+                                        &txhashes[i + 2], &txhashes[i + 3]};
+        SipHashUint256_4way(shorttxidk0, shorttxidk1, vals, out + i);
+        for (size_t j = i; j < i + 4; j++) {
+            out[j] &= 0xffffffffffffL;
+        }
+    }
+    for (; i < n; i++) {
+        out[i] = GetShortID(txhashes[i]);
+    }
+}
+
 ReadStatus PartiallyDownloadedBlock::InitData(
     const CBlockHeaderAndShortTxIDs &cmpctblock,
     const std::vector<std::pair<TxHash, CTransactionRef>> &extra_txns) {
@@ -130,72 +152,105 @@ ReadStatus PartiallyDownloadedBlock::InitData(
     }
 
     std::vector<bool> have_txn(txns_available.size());
+    // Short IDs are computed a batch at a time, which may hash up to
+    // SHORTID_BATCH_SIZE - 1 transactions past the early exit below.
+    std::array<TxHash, SHORTID_BATCH_SIZE> batch_hashes;
+    uint64_t batch_shortids[SHORTID_BATCH_SIZE];
     {
         LOCK(pool->cs);
-        for (auto &entry : pool->GetIndex()) {
-            uint64_t shortid = cmpctblock.GetShortID(entry.GetTx().GetHash());
+        bool done = false;
+        const auto &index = pool->GetIndex();
+        std::array<const CTxMemPoolEntry *, SHORTID_BATCH_SIZE> batch_entries;
+        for (auto it = index.begin(); !done && it != index.end();) {
+            size_t batch_size = 0;
+            for (; batch_size < SHORTID_BATCH_SIZE && it != index.end();
+                 ++batch_size, ++it) {
+                batch_entries[batch_size] = &*it;
+                batch_hashes[batch_size] = it->GetTx().GetHash();
+            }
+            cmpctblock.GetShortIDs(batch_hashes.data(), batch_size,
+                                   batch_shortids);
+
+            for (size_t i = 0; i < batch_size; i++) {
+                const CTxMemPoolEntry &entry = *batch_entries[i];
+                std::unordered_map<uint64_t, uint32_t>::iterator idit =
+                    shorttxids.find(batch_shortids[i]);
+                if (idit != shorttxids.end()) {
+                    if (!have_txn[idit->second]) {
+                        txns_available[idit->second] = entry.GetSharedTx();
+                        have_txn[idit->second] = true;
+                        mempool_count++;
+                    } else {
+                        // If we find two mempool txn that match the short
+                        // id, just request it. This should be rare enough
+                        // that the extra bandwidth doesn't matter, but eating
+                        // a round-trip due to FillBlock failure would be
+                        // annoying.
+                        if (txns_available[idit->second]) {
+                            txns_available[idit->second].reset();
+                            mempool_count--;
+                        }
+                    }
+                }
+                // Though ideally we'd continue scanning for the
+                // two-txn-match-shortid case, the performance win of an early
+                // exit here is too good to pass up and worth the extra risk.
+                if (mempool_count == shorttxids.size()) {
+                    done = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    bool done = false;
+    for (size_t start = 0; !done && start < extra_txns.size();
+         start += SHORTID_BATCH_SIZE) {
+        const size_t batch_size =
+            std::min(SHORTID_BATCH_SIZE, extra_txns.size() - start);
+        for (size_t i = 0; i < batch_size; i++) {
+            batch_hashes[i] = extra_txns[start + i].first;
+        }
+        cmpctblock.GetShortIDs(batch_hashes.data(), batch_size,
+                               batch_shortids);
+
+        for (size_t i = 0; i < batch_size; i++) {
+            const auto &extra_txn = extra_txns[start + i];
             std::unordered_map<uint64_t, uint32_t>::iterator idit =
-                shorttxids.find(shortid);
+                shorttxids.find(batch_shortids[i]);
             if (idit != shorttxids.end()) {
                 if (!have_txn[idit->second]) {
-                    txns_available[idit->second] = entry.GetSharedTx();
+                    txns_available[idit->second] = extra_txn.second;
                     have_txn[idit->second] = true;
                     mempool_count++;
+                    extra_count++;
                 } else {
-                    // If we find two mempool txn that match the short id, just
-                    // request it. This should be rare enough that the extra
-                    // bandwidth doesn't matter, but eating a round-trip due to
-                    // FillBlock failure would be annoying.
-                    if (txns_available[idit->second]) {
+                    // If we find two mempool/extra txn that match the short
+                    // id, just request it. This should be rare enough that the
+                    // extra bandwidth doesn't matter, but eating a round-trip
+                    // due to FillBlock failure would be annoying. Note that we
+                    // don't want duplication between extra_txns and mempool to
+                    // trigger this case, so we compare hashes first.
+                    if (txns_available[idit->second] &&
+                        txns_available[idit->second]->GetHash() !=
+                            extra_txn.second->GetHash()) {
                         txns_available[idit->second].reset();
                         mempool_count--;
+                        extra_count--;
                     }
                 }
             }
+
             // Though ideally we'd continue scanning for the
             // two-txn-match-shortid case, the performance win of an early exit
             // here is too good to pass up and worth the extra risk.
             if (mempool_count == shorttxids.size()) {
+                done = true;
                 break;
             }
         }
     }
 
-    for (auto &extra_txn : extra_txns) {
-        uint64_t shortid = cmpctblock.GetShortID(extra_txn.first);
-        std::unordered_map<uint64_t, uint32_t>::iterator idit =
-            shorttxids.find(shortid);
-        if (idit != shorttxids.end()) {
-            if (!have_txn[idit->second]) {
-                txns_available[idit->second] = extra_txn.second;
-                have_txn[idit->second] = true;
-                mempool_count++;
-                extra_count++;
-            } else {
-                // If we find two mempool/extra txn that match the short id,
-                // just request it. This should be rare enough that the extra
-                // bandwidth doesn't matter, but eating a round-trip due to
-                // FillBlock failure would be annoying. Note that we don't want
-                // duplication between extra_txns and mempool to trigger this
-                // case, so we compare hashes first.
-                if (txns_available[idit->second] &&
-                    txns_available[idit->second]->GetHash() !=
-                        extra_txn.second->GetHash()) {
-                    txns_available[idit->second].reset();
-                    mempool_count--;
-                    extra_count--;
-                }
-            }
-        }
-
-        // Though ideally we'd continue scanning for the two-txn-match-shortid
-        // case, the performance win of an early exit here is too good to pass
-        // up and worth the extra risk.
-        if (mempool_count == shorttxids.size()) {
-            break;
-        }
-    }
-
     LogPrint(BCLog::CMPCTBLOCK,
              "Initialized PartiallyDownloadedBlock for block %s using a "
              "cmpctblock of size %lu\n",
@@ -117,6 +117,11 @@ public:
     CBlockHeaderAndShortTxIDs(const CBlock &block);
 
     uint64_t GetShortID(const TxHash &txhash) const;
+    /**
+     * Compute the short IDs of n transactions at once, setting out[i] to
+     * GetShortID(txhashes[i]). This is faster than one at a time.
+     */
+    void GetShortIDs(const TxHash *txhashes, size_t n, uint64_t *out) const;
 
     size_t BlockTxCount() const {
         return shorttxids.size() + prefilledtxn.size();
@@ -6,6 +6,9 @@
 
 #include <chain.h>
 
+#include <algorithm>
+#include <cassert>
+
 /**
  * CChain implementation
  */
@@ -60,10 +63,37 @@ const CBlockIndex *CChain::FindFork(const CBlockIndex *pindex) const {
     if (pindex->nHeight > Height()) {
         pindex = pindex->GetAncestor(Height());
     }
-    while (pindex && !Contains(pindex)) {
-        pindex = pindex->pprev;
+    if (pindex == nullptr || Contains(pindex)) {
+        return pindex;
+    }
+
+    // Ancestors of a block in this chain are in it too, so the fork point is
+    // the highest ancestor of pindex that is in this chain. Find an ancestor
+    // in it by doubling the distance from pindex, then bisect the last step.
+    // This takes O(log(n)) skiplist walks rather than a walk along the
+    // whole branch.
+    int out_height = pindex->nHeight;
+    int in_height = -1;
+    for (int step = 1; in_height < 0; step *= 2) {
+        const int height = std::max(pindex->nHeight - step, 0);
+        if (Contains(pindex->GetAncestor(height))) {
+            in_height = height;
+        } else if (height == 0) {
+            // Different genesis blocks.
+            return nullptr;
+        } else {
+            out_height = height;
+        }
+    }
+    while (out_height - in_height > 1) {
+        const int height = in_height + (out_height - in_height) / 2;
+        if (Contains(pindex->GetAncestor(height))) {
+            in_height = height;
+        } else {
+            out_height = height;
+        }
     }
-    return pindex;
+    return vChain[in_height];
 }
 
 CBlockIndex *CChain::FindEarliestAtLeast(int64_t nTime) const {
@@ -131,6 +161,77 @@ void CBlockIndex::BuildSkip() {
     }
 }
 
+namespace {
+//! Guards the header fields of all CBlockIndex entries.
+Mutex g_header_fields_mutex;
+//! What an evicted entry's HeaderFieldsPtr points to.
+CBlockIndexHeaderFields g_evicted_header_fields;
+std::function<CBlockIndexHeaderFields(const BlockHash &)>
+    g_header_fields_loader GUARDED_BY(g_header_fields_mutex);
+} // namespace
+
+CBlockIndex::HeaderFieldsPtr::HeaderFieldsPtr(const HeaderFieldsPtr &other) {
+    LOCK(g_header_fields_mutex);
+    if (other.ptr == nullptr || other.ptr == &g_evicted_header_fields) {
+        ptr = other.ptr;
+    } else {
+        ptr = new CBlockIndexHeaderFields(*other.ptr);
+    }
+}
+
+CBlockIndex::HeaderFieldsPtr::~HeaderFieldsPtr() {
+    if (ptr != &g_evicted_header_fields) {
+        delete ptr;
+    }
+}
+
+CBlockIndexHeaderFields CBlockIndex::GetHeaderFields() const {
+    std::function<CBlockIndexHeaderFields(const BlockHash &)> loader;
+    {
+        LOCK(g_header_fields_mutex);
+        if (m_header_fields.ptr != &g_evicted_header_fields) {
+            return m_header_fields.ptr ? *m_header_fields.ptr
+                                       : CBlockIndexHeaderFields();
+        }
+        loader = g_header_fields_loader;
+    }
+    // Read outside of the lock: this is a database lookup.
+    assert(loader);
+    return loader(GetBlockHash());
+}
+
+void CBlockIndex::SetHeaderFields(const CBlockIndexHeaderFields &fields) {
+    LOCK(g_header_fields_mutex);
+    if (m_header_fields.ptr == nullptr ||
+        m_header_fields.ptr == &g_evicted_header_fields) {
+        m_header_fields.ptr = new CBlockIndexHeaderFields(fields);
+    } else {
+        *m_header_fields.ptr = fields;
+    }
+}
+
+bool CBlockIndex::EvictHeaderFields() {
+    LOCK(g_header_fields_mutex);
+    if (m_header_fields.ptr == nullptr ||
+        m_header_fields.ptr == &g_evicted_header_fields) {
+        return false;
+    }
+    delete m_header_fields.ptr;
+    m_header_fields.ptr = &g_evicted_header_fields;
+    return true;
+}
+
+bool CBlockIndex::HeaderFieldsEvicted() const {
+    LOCK(g_header_fields_mutex);
+    return m_header_fields.ptr == &g_evicted_header_fields;
+}
+
+void CBlockIndex::SetHeaderFieldsLoader(
+    std::function<CBlockIndexHeaderFields(const BlockHash &)> loader) {
+    LOCK(g_header_fields_mutex);
+    g_header_fields_loader = std::move(loader);
+}
+
 arith_uint256 GetBlockProof(const CBlockIndex &block) {
     arith_uint256 bnTarget;
     bool fNegative;
@@ -17,6 +17,7 @@
 #include <tinyformat.h>
 #include <uint256.h>
 
+#include <functional>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
@@ -43,6 +44,17 @@ static constexpr int64_t TIMESTAMP_WINDOW = MAX_FUTURE_BLOCK_TIME;
  */
 static constexpr int64_t MAX_BLOCK_TIME_GAP = 90 * 60;
 
+/**
+ * The fields of a block header that a CBlockIndex does not need for chain
+ * selection. With -lazyblockindex, those of deep blocks are evicted from memory
+ * and read back from the block tree database when needed.
+ */
+struct CBlockIndexHeaderFields {
+    int32_t nVersion = 0;
+    uint256 hashMerkleRoot = uint256();
+    uint32_t nNonce = 0;
+};
+
 /**
  * The block chain is a tree shaped structure starting with the genesis block at
  * the root, with each block potentially having multiple candidates to be the
@@ -66,6 +78,9 @@ protected:
     CBlockIndex &operator=(CBlockIndex &&) = delete;
 
 public:
+    // The fields read while walking the block tree (ancestor lookups, fork
+    // and best chain searches) come first, so that they share a cache line.
+
     //! pointer to the hash of the block, if any. Memory is owned by external
     //! code that also owns this CBlockIndex. See: class CChanState in validation.cpp.
     const BlockHash *phashBlock = nullptr;
@@ -79,6 +94,13 @@ public:
     //! height of the entry in the chain. The genesis block has height 0
     int nHeight = 0;
 
+    //! Verification status of this block. See enum BlockStatus
+    BlockStatus nStatus = BlockStatus();
+
+    //! (memory only) Total amount of work (expected number of hashes) in the
+    //! chain up to and including this block
+    arith_uint256 nChainWork = arith_uint256();
+
     //! Which # file this block is stored in (blk?????.dat)
     int nFile = 0;
 
@@ -88,10 +110,6 @@ public:
     //! Byte offset within rev?????.dat where this block's undo data is stored
     unsigned int nUndoPos = 0;
 
-    //! (memory only) Total amount of work (expected number of hashes) in the
-    //! chain up to and including this block
-    arith_uint256 nChainWork = arith_uint256();
-
     //! Number of transactions in this block.
     //! Note: in a potential headers-first mode, this number cannot be relied
     //! upon
@@ -104,15 +122,9 @@ public:
     //! necessary; won't happen before 2030
     unsigned int nChainTx = 0;
 
-    //! Verification status of this block. See enum BlockStatus
-    BlockStatus nStatus = BlockStatus();
-
-    //! block header
-    int32_t nVersion = 0;
-    uint256 hashMerkleRoot = uint256();
+    //! block header, see also GetHeaderFields()
     uint32_t nTime = 0;
     uint32_t nBits = 0;
-    uint32_t nNonce = 0;
 
     //! (memory only) Sequential id assigned to distinguish order in which
     //! blocks are received.
@@ -127,12 +139,10 @@ public:
     explicit CBlockIndex() = default;
 
     explicit CBlockIndex(const CBlockHeader &block) : CBlockIndex() {
-        nVersion = block.nVersion;
-        hashMerkleRoot = block.hashMerkleRoot;
+        SetHeaderFields({block.nVersion, block.hashMerkleRoot, block.nNonce});
         nTime = block.nTime;
         nTimeReceived = 0;
         nBits = block.nBits;
-        nNonce = block.nNonce;
     }
 
     FlatFilePos GetBlockPos() const {
@@ -153,16 +163,43 @@ public:
         return ret;
     }
 
+    /**
+     * Get the header fields not kept with the fields used for chain
+     * selection. This reads them from the block tree database if they were
+     * evicted.
+     */
+    CBlockIndexHeaderFields GetHeaderFields() const;
+
+    void SetHeaderFields(const CBlockIndexHeaderFields &fields);
+
+    /**
+     * Drop the header fields returned by GetHeaderFields() from memory. The
+     * entry must have been written to the block tree database. Returns false
+     * if they were not in memory.
+     */
+    bool EvictHeaderFields();
+
+    bool HeaderFieldsEvicted() const;
+
+    /**
+     * Set the function that GetHeaderFields() reads evicted fields with, by
+     * block hash. It must be set by the owner of the block tree database
+     * before any entry is evicted.
+     */
+    static void SetHeaderFieldsLoader(
+        std::function<CBlockIndexHeaderFields(const BlockHash &)> loader);
+
     CBlockHeader GetBlockHeader() const {
+        const CBlockIndexHeaderFields fields = GetHeaderFields();
         CBlockHeader block;
-        block.nVersion = nVersion;
+        block.nVersion = fields.nVersion;
         if (pprev) {
             block.hashPrevBlock = pprev->GetBlockHash();
         }
-        block.hashMerkleRoot = hashMerkleRoot;
+        block.hashMerkleRoot = fields.hashMerkleRoot;
         block.nTime = nTime;
         block.nBits = nBits;
-        block.nNonce = nNonce;
+        block.nNonce = fields.nNonce;
         return block;
     }
 
@@ -213,7 +250,8 @@ public:
     std::string ToString() const {
         return strprintf(
             "CBlockIndex(pprev=%p, nHeight=%d, merkle=%s, hashBlock=%s)", pprev,
-            nHeight, hashMerkleRoot.ToString(), GetBlockHash().ToString());
+            nHeight, GetHeaderFields().hashMerkleRoot.ToString(),
+            GetBlockHash().ToString());
     }
 
     //! Check whether this block index entry is valid up to the passed validity
@@ -244,6 +282,24 @@ public:
     //! Efficiently find an ancestor of this block.
     CBlockIndex *GetAncestor(int height);
     const CBlockIndex *GetAncestor(int height) const;
+
+private:
+    /**
+     * Owning pointer to the fields returned by GetHeaderFields(): null if
+     * they were never set, or a sentinel once evicted. Headers are read
+     * without cs_main, so all accesses go through a lock of their own.
+     */
+    class HeaderFieldsPtr {
+    public:
+        HeaderFieldsPtr() = default;
+        HeaderFieldsPtr(const HeaderFieldsPtr &other);
+        HeaderFieldsPtr &operator=(const HeaderFieldsPtr &) = delete;
+        ~HeaderFieldsPtr();
+
+        CBlockIndexHeaderFields *ptr = nullptr;
+    };
+
+    HeaderFieldsPtr m_header_fields;
 };
 
 // ensure that the future code that may modify the CBlockIndex preserves type safety restriction on CBlockIndex
@@ -298,11 +354,18 @@ bool AreOnTheSameFork(const CBlockIndex *pa, const CBlockIndex *pb);
 class CDiskBlockIndex : public CBlockIndex {
 public:
     BlockHash hashPrev;
+    int32_t nVersion = 0;
+    uint256 hashMerkleRoot = uint256();
+    uint32_t nNonce = 0;
 
     CDiskBlockIndex() { hashPrev = BlockHash(); }
 
     explicit CDiskBlockIndex(const CBlockIndex *pindex) : CBlockIndex(*pindex) {
         hashPrev = (pprev ? pprev->GetBlockHash() : BlockHash());
+        const CBlockIndexHeaderFields fields = pindex->GetHeaderFields();
+        nVersion = fields.nVersion;
+        hashMerkleRoot = fields.hashMerkleRoot;
+        nNonce = fields.nNonce;
     }
 
     SERIALIZE_METHODS(CDiskBlockIndex, obj) {
@@ -425,6 +488,19 @@ public:
      */
     CBlockLocator GetLocator(const CBlockIndex *pindex = nullptr) const;
 
+    /**
+     * Return the ancestor of pindex at the given height, or nullptr if there
+     * is none. This is a single lookup if pindex is in this chain, and a
+     * skiplist walk otherwise.
+     */
+    const CBlockIndex *GetAncestor(const CBlockIndex *pindex,
+                                   int height) const {
+        if (height < 0 || height > pindex->nHeight) {
+            return nullptr;
+        }
+        return Contains(pindex) ? vChain[height] : pindex->GetAncestor(height);
+    }
+
     /**
      * Find the last common block between this chain and a block index entry.
      */
@@ -64,7 +64,7 @@ static CBlock CreateGenesisBlock(const char *pszTimestamp,
 CBlock CreateGenesisBlock(uint32_t nTime, uint32_t nNonce, uint32_t nBits,
                           int32_t nVersion, const Amount genesisReward) {
     const char *pszTimestamp =
-        "Dji-Coin waxaa loo qaatay sidii lacagta qaranka Jabuuti";
+        "The Times 03/Jan/2009 Chancellor on brink of second bailout for banks";
     const CScript genesisOutputScript =
         CScript() << ParseHex("04678afdb0fe5548271967f1a67130b7105cd6a828e03909"
                               "a67962e0ea1f61deb649f6bc3f4cef38c4f35504e51ec112"
@@ -180,7 +180,7 @@ public:
         m_assumed_chain_state_size = 6;     // 4.1G
 
         genesis = CreateGenesisBlock(1231006505, 2083236893, 0x1d00ffff, 1,
-                                     100 * COIN);
+                                     50 * COIN);
         consensus.hashGenesisBlock = genesis.GetHash();
         assert(consensus.hashGenesisBlock ==
                uint256S("000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1"
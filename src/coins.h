@@ -183,6 +183,10 @@ protected:
     /* Cached dynamic memory usage for the inner Coin objects. */
     mutable size_t cachedCoinsUsage;
 
+    /* Number of coin lookups found in, and missing from, cacheCoins. */
+    mutable uint64_t cacheHits;
+    mutable uint64_t cacheMisses;
+
 public:
     CCoinsViewCache(CCoinsView *baseIn);
 
@@ -256,6 +260,11 @@ public:
     //! Calculate the size of the cache (in bytes)
     size_t DynamicMemoryUsage() const;
 
+    //! Number of coin lookups answered by this cache, and passed on to its
+    //! base, since it was created
+    uint64_t GetCacheHits() const { return cacheHits; }
+    uint64_t GetCacheMisses() const { return cacheMisses; }
+
     /**
      * Amount of bitcoins coming in to a transaction
      * Note that lightweight clients may not know anything besides the hash of
@@ -10,6 +10,7 @@
 #include <policy/policy.h>
 #include <util/noncopyable.h>
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <set>
@@ -100,8 +101,9 @@ private:
     /** The largest block size this node will generate. */
     uint64_t nGeneratedBlockSize;
 
-    /** The maximum amount of RAM to be used in the mempool before TrimToSize is called. */
-    uint64_t nMaxMemPoolSize;
+    /** The maximum amount of RAM to be used in the mempool before TrimToSize is called.
+        Atomic because the memory governor may change it while other threads read it. */
+    std::atomic<uint64_t> nMaxMemPoolSize;
 
     std::set<std::string> rejectSubVersions;
 };
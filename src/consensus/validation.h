@@ -6,8 +6,6 @@
 
 #pragma once
 
-#include <dsproof/dspid.h>
-
 #include <string>
 #include <memory>
 #include <vector>
@@ -35,10 +33,6 @@ private:
     bool corruptionPossible = false;
     std::string strDebugMessage;
 
-    //! Validation data related to DoubleSpendProof. The most common case is that *no* DSP exists. In order to minimize
-    //! the memory & CPU footprint of the DSProof facility, we wrap this hash in a tiny object for the common case.
-    DspIdPtr dspIdPtr;
-
 public:
     CValidationState() = default;
 
@@ -89,9 +83,4 @@ public:
     unsigned int GetRejectCode() const { return chRejectCode; }
     std::string GetRejectReason() const { return strRejectReason; }
     std::string GetDebugMessage() const { return strDebugMessage; }
-
-    // DoubleSpendProof getters and setters
-    bool HasDspId() const { return bool(dspIdPtr); }
-    DspId GetDspId() const { return dspIdPtr ? *dspIdPtr : DspId{}; }
-    void SetDspId(const DspId &dspId) { dspIdPtr = dspId; }
 };
@@ -4,6 +4,8 @@
 
 #include <crypto/siphash.h>
 
+#include <compat/cpuid.h>
+
 #define ROTL(x, b) (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
 
 #define SIPROUND                                                               \
@@ -174,3 +176,66 @@ uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256 &val, uint3
     SIPROUND;
     return v0 ^ v1 ^ v2 ^ v3;
 }
+
+namespace siphash_avx2 {
+void SipHashUint256_4way(uint64_t k0, uint64_t k1, const uint256 *const vals[4], uint64_t out[4]) noexcept;
+void SipHashUint256Extra_4way(uint64_t k0, uint64_t k1, const uint256 *const vals[4], const uint32_t extras[4],
+                              uint64_t out[4]) noexcept;
+} // namespace siphash_avx2
+
+namespace {
+void SipHashUint256_4way_generic(uint64_t k0, uint64_t k1, const uint256 *const vals[4], uint64_t out[4]) noexcept {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = SipHashUint256(k0, k1, *vals[i]);
+    }
+}
+
+void SipHashUint256Extra_4way_generic(uint64_t k0, uint64_t k1, const uint256 *const vals[4], const uint32_t extras[4],
+                                      uint64_t out[4]) noexcept {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = SipHashUint256Extra(k0, k1, *vals[i], extras[i]);
+    }
+}
+
+struct SipHash4wayImpl {
+    decltype(&SipHashUint256_4way_generic) hash = SipHashUint256_4way_generic;
+    decltype(&SipHashUint256Extra_4way_generic) hash_extra = SipHashUint256Extra_4way_generic;
+
+    SipHash4wayImpl() noexcept {
+#if defined(USE_ASM) && defined(HAVE_GETCPUID) && defined(ENABLE_AVX2) && !defined(BUILD_BITCOIN_INTERNAL)
+        uint32_t eax, ebx, ecx, edx;
+        GetCPUID(1, 0, eax, ebx, ecx, edx);
+        const bool have_xsave = (ecx >> 27) & 1;
+        const bool have_avx = (ecx >> 28) & 1;
+        if (!have_xsave || !have_avx) {
+            return;
+        }
+        // Check that the OS saves the YMM registers.
+        uint32_t a, d;
+        __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+        if ((a & 6) != 6) {
+            return;
+        }
+        GetCPUID(7, 0, eax, ebx, ecx, edx);
+        if ((ebx >> 5) & 1) {
+            hash = siphash_avx2::SipHashUint256_4way;
+            hash_extra = siphash_avx2::SipHashUint256Extra_4way;
+        }
+#endif
+    }
+};
+
+const SipHash4wayImpl &Get4wayImpl() noexcept {
+    static const SipHash4wayImpl impl;
+    return impl;
+}
+} // namespace
+
+void SipHashUint256_4way(uint64_t k0, uint64_t k1, const uint256 *const vals[4], uint64_t out[4]) noexcept {
+    Get4wayImpl().hash(k0, k1, vals, out);
+}
+
+void SipHashUint256Extra_4way(uint64_t k0, uint64_t k1, const uint256 *const vals[4], const uint32_t extras[4],
+                              uint64_t out[4]) noexcept {
+    Get4wayImpl().hash_extra(k0, k1, vals, extras, out);
+}
@@ -44,3 +44,16 @@ public:
  */
 uint64_t SipHashUint256(uint64_t k0, uint64_t k1, const uint256 &val) noexcept;
 uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256 &val, uint32_t extra) noexcept;
+
+/** Compute SipHashUint256 of four values at once.
+ *
+ *  out[i] is set to SipHashUint256(k0, k1, *vals[i]). On CPUs with AVX2, the
+ *  four hashes are computed in parallel, one per 64-bit lane.
+ */
+void SipHashUint256_4way(uint64_t k0, uint64_t k1, const uint256 *const vals[4], uint64_t out[4]) noexcept;
+/** Compute SipHashUint256Extra of four values at once.
+ *
+ *  out[i] is set to SipHashUint256Extra(k0, k1, *vals[i], extras[i]).
+ */
+void SipHashUint256Extra_4way(uint64_t k0, uint64_t k1, const uint256 *const vals[4], const uint32_t extras[4],
+                              uint64_t out[4]) noexcept;
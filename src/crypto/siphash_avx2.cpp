@@ -0,0 +1,126 @@
+// Copyright (c) 2026 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <uint256.h>
+
+#include <cstdint>
+#include <immintrin.h>
+
+/**
+ * SipHash-2-4 of four 256-bit values at once, with one value per 64-bit lane
+ * of an AVX2 register. The state words v0..v3 of the four hashes are each
+ * held in one register, so that every step of a SipRound advances all four
+ * hashes with one instruction.
+ */
+namespace siphash_avx2 {
+namespace {
+
+    __m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi64(x, y); }
+    __m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+    template <int b> __m256i inline RotL(__m256i x) {
+        return _mm256_or_si256(_mm256_slli_epi64(x, b),
+                               _mm256_srli_epi64(x, 64 - b));
+    }
+    template <> __m256i inline RotL<32>(__m256i x) {
+        return _mm256_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1));
+    }
+    template <> __m256i inline RotL<16>(__m256i x) {
+        const __m256i mask =
+            _mm256_setr_epi8(6, 7, 0, 1, 2, 3, 4, 5, 14, 15, 8, 9, 10, 11, 12,
+                             13, 6, 7, 0, 1, 2, 3, 4, 5, 14, 15, 8, 9, 10, 11,
+                             12, 13);
+        return _mm256_shuffle_epi8(x, mask);
+    }
+
+    struct State {
+        __m256i v0, v1, v2, v3;
+
+        State(uint64_t k0, uint64_t k1) {
+            v0 = _mm256_set1_epi64x(0x736f6d6570736575ULL ^ k0);
+            v1 = _mm256_set1_epi64x(0x646f72616e646f6dULL ^ k1);
+            v2 = _mm256_set1_epi64x(0x6c7967656e657261ULL ^ k0);
+            v3 = _mm256_set1_epi64x(0x7465646279746573ULL ^ k1);
+        }
+
+        void inline Round() {
+            v0 = Add(v0, v1);
+            v1 = RotL<13>(v1);
+            v1 = Xor(v1, v0);
+            v0 = RotL<32>(v0);
+            v2 = Add(v2, v3);
+            v3 = RotL<16>(v3);
+            v3 = Xor(v3, v2);
+            v0 = Add(v0, v3);
+            v3 = RotL<21>(v3);
+            v3 = Xor(v3, v0);
+            v2 = Add(v2, v1);
+            v1 = RotL<17>(v1);
+            v1 = Xor(v1, v2);
+            v2 = RotL<32>(v2);
+        }
+
+        void inline Compress(__m256i d) {
+            v3 = Xor(v3, d);
+            Round();
+            Round();
+            v0 = Xor(v0, d);
+        }
+
+        /** Compress the four 64-bit words of one value per lane. */
+        void inline CompressUint256(const uint256 *const vals[4]) {
+            // Transpose the 4x4 matrix of 64-bit words, so that register i
+            // holds word i of every value.
+            const __m256i a = _mm256_loadu_si256((const __m256i *)vals[0]);
+            const __m256i b = _mm256_loadu_si256((const __m256i *)vals[1]);
+            const __m256i c = _mm256_loadu_si256((const __m256i *)vals[2]);
+            const __m256i d = _mm256_loadu_si256((const __m256i *)vals[3]);
+            const __m256i ab_even = _mm256_unpacklo_epi64(a, b);
+            const __m256i ab_odd = _mm256_unpackhi_epi64(a, b);
+            const __m256i cd_even = _mm256_unpacklo_epi64(c, d);
+            const __m256i cd_odd = _mm256_unpackhi_epi64(c, d);
+            Compress(_mm256_permute2x128_si256(ab_even, cd_even, 0x20));
+            Compress(_mm256_permute2x128_si256(ab_odd, cd_odd, 0x20));
+            Compress(_mm256_permute2x128_si256(ab_even, cd_even, 0x31));
+            Compress(_mm256_permute2x128_si256(ab_odd, cd_odd, 0x31));
+        }
+
+        void inline Finalize(uint64_t out[4]) {
+            v2 = Xor(v2, _mm256_set1_epi64x(0xFF));
+            Round();
+            Round();
+            Round();
+            Round();
+            _mm256_storeu_si256((__m256i *)out, Xor(Xor(v0, v1), Xor(v2, v3)));
+        }
+    };
+
+} // namespace
+
+void SipHashUint256_4way(uint64_t k0, uint64_t k1,
+                         const uint256 *const vals[4],
+                         uint64_t out[4]) noexcept {
+    State s(k0, k1);
+    s.CompressUint256(vals);
+    s.Compress(_mm256_set1_epi64x(uint64_t(4) << 59));
+    s.Finalize(out);
+}
+
+void SipHashUint256Extra_4way(uint64_t k0, uint64_t k1,
+                              const uint256 *const vals[4],
+                              const uint32_t extras[4],
+                              uint64_t out[4]) noexcept {
+    State s(k0, k1);
+    s.CompressUint256(vals);
+    const __m256i extra = _mm256_cvtepu32_epi64(
+        _mm_loadu_si128((const __m128i *)extras));
+    s.Compress(
+        _mm256_or_si256(extra, _mm256_set1_epi64x(uint64_t(36) << 56)));
+    s.Finalize(out);
+}
+
+} // namespace siphash_avx2
+
+#endif
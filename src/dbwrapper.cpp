@@ -108,6 +108,8 @@ static leveldb::Options GetOptions(size_t nCacheSize) {
     options.write_buffer_size = nCacheSize / 4;
     options.filter_policy = leveldb::NewBloomFilterPolicy(10);
     options.compression = leveldb::kNoCompression;
+    options.max_subcompactions = gArgs.GetArg("-dbcompactionthreads",
+                                              DEFAULT_DB_COMPACTION_THREADS);
     options.info_log = new CBitcoinLevelDBLogger();
     if (leveldb::kMajorVersion > 1 ||
         (leveldb::kMajorVersion == 1 && leveldb::kMinorVersion >= 16)) {
@@ -120,13 +122,14 @@ static leveldb::Options GetOptions(size_t nCacheSize) {
 }
 
 CDBWrapper::CDBWrapper(const fs::path &path, size_t nCacheSize, bool fMemory,
-                       bool fWipe, bool obfuscate)
+                       bool fWipe, bool obfuscate, bool random_access)
     : m_name(fs::basename(path)) {
     penv = nullptr;
     readoptions.verify_checksums = true;
     iteroptions.verify_checksums = true;
     iteroptions.fill_cache = false;
     syncoptions.sync = true;
+    unloggedoptions.skip_log = true;
     options = GetOptions(nCacheSize);
     options.create_if_missing = true;
     if (fMemory) {
@@ -140,6 +143,25 @@ CDBWrapper::CDBWrapper(const fs::path &path, size_t nCacheSize, bool fMemory,
         }
         TryCreateDirectories(path);
         LogPrintf("Opening LevelDB in %s\n", path.string());
+        if (gArgs.GetBoolArg("-dbmmap", DEFAULT_DB_MMAP)) {
+            m_mmap_env = leveldb::NewMmapReadEnv(leveldb::Env::Default(),
+                                                 random_access);
+            if (m_mmap_env) {
+                penv = m_mmap_env;
+                options.env = penv;
+                // Keep every table open (and thus mapped), up to LevelDB's
+                // own limit; mapped tables do not hold a file descriptor.
+                options.max_open_files = 50000;
+                // Table blocks are checksummed by the environment the first
+                // time they are read.
+                readoptions.verify_checksums = false;
+                iteroptions.verify_checksums = false;
+            } else {
+                LogPrintf("-dbmmap is not supported on this platform, "
+                          "ignoring it for %s\n",
+                          path.string());
+            }
+        }
     }
     leveldb::Status status = leveldb::DB::Open(options, path.string(), &pdb);
     dbwrapper_private::HandleError(status);
@@ -187,13 +209,21 @@ CDBWrapper::~CDBWrapper() {
 }
 
 bool CDBWrapper::WriteBatch(CDBBatch &batch, bool fSync) {
+    return WriteBatch(batch, fSync ? syncoptions : writeoptions);
+}
+
+bool CDBWrapper::WriteBatchUnlogged(CDBBatch &batch) {
+    return WriteBatch(batch, unloggedoptions);
+}
+
+bool CDBWrapper::WriteBatch(CDBBatch &batch,
+                            const leveldb::WriteOptions &write_options) {
     const bool log_memory = LogAcceptCategory(BCLog::LEVELDB);
     double mem_before = 0;
     if (log_memory) {
         mem_before = DynamicMemoryUsage() / 1024.0 / 1024;
     }
-    leveldb::Status status =
-        pdb->Write(fSync ? syncoptions : writeoptions, &batch.batch);
+    leveldb::Status status = pdb->Write(write_options, &batch.batch);
     dbwrapper_private::HandleError(status);
     if (log_memory) {
         double mem_after = DynamicMemoryUsage() / 1024.0 / 1024;
@@ -205,6 +235,12 @@ bool CDBWrapper::WriteBatch(CDBBatch &batch, bool fSync) {
     return true;
 }
 
+bool CDBWrapper::Flush() {
+    leveldb::Status status = pdb->FlushMemTable();
+    dbwrapper_private::HandleError(status);
+    return true;
+}
+
 size_t CDBWrapper::DynamicMemoryUsage() const {
     std::string memory;
     if (!pdb->GetProperty("leveldb.approximate-memory-usage", &memory)) {
@@ -215,6 +251,14 @@ size_t CDBWrapper::DynamicMemoryUsage() const {
     return stoul(memory);
 }
 
+bool CDBWrapper::GetMmapStats(leveldb::MmapReadStats &stats) const {
+    if (!m_mmap_env) {
+        return false;
+    }
+    stats = m_mmap_env->GetStats();
+    return true;
+}
+
 // Prefixed with null character to avoid collisions with other keys
 //
 // We must use a string constructor which specifies length so that we copy past
@@ -14,6 +14,7 @@
 #include <version.h>
 
 #include <leveldb/db.h>
+#include <leveldb/env.h>
 #include <leveldb/write_batch.h>
 
 #include <memory>
@@ -21,6 +22,10 @@
 
 static const size_t DBWRAPPER_PREALLOC_KEY_SIZE = 64;
 static const size_t DBWRAPPER_PREALLOC_VALUE_SIZE = 1024;
+//! -dbmmap default
+static constexpr bool DEFAULT_DB_MMAP = false;
+//! Threads a single LevelDB compaction may be split over
+static constexpr int DEFAULT_DB_COMPACTION_THREADS = 4;
 
 class dbwrapper_error : public std::runtime_error {
 public:
@@ -182,6 +187,9 @@ private:
     //! default environment)
     leveldb::Env *penv;
 
+    //! penv if it is the -dbmmap environment, nullptr otherwise
+    leveldb::MmapReadEnv *m_mmap_env = nullptr;
+
     //! database options used
     leveldb::Options options;
 
@@ -197,6 +205,9 @@ private:
     //! options used when sync writing to the database
     leveldb::WriteOptions syncoptions;
 
+    //! options used when writing to the database without logging
+    leveldb::WriteOptions unloggedoptions;
+
     //! the database itself
     leveldb::DB *pdb;
 
@@ -214,6 +225,8 @@ private:
 
     std::vector<uint8_t> CreateObfuscateKey() const;
 
+    bool WriteBatch(CDBBatch &batch, const leveldb::WriteOptions &write_options);
+
 public:
     /**
      * @param[in] path        Location in the filesystem where leveldb data will
@@ -224,9 +237,12 @@ public:
      * @param[in] obfuscate   If true, store data obfuscated via simple XOR. If
      * false, XOR
      *                        with a zero'd byte array.
+     * @param[in] random_access If true, reads are expected to be scattered
+     *                        point lookups. Only affects the -dbmmap mode.
      */
     CDBWrapper(const fs::path &path, size_t nCacheSize, bool fMemory = false,
-               bool fWipe = false, bool obfuscate = false);
+               bool fWipe = false, bool obfuscate = false,
+               bool random_access = false);
     ~CDBWrapper();
 
     CDBWrapper(const CDBWrapper &) = delete;
@@ -288,11 +304,22 @@ public:
 
     bool WriteBatch(CDBBatch &batch, bool fSync = false);
 
+    /**
+     * Write a batch without appending it to LevelDB's log. It only becomes
+     * durable with the next Flush(); a crash before that loses it together
+     * with every later write, as if none of them had happened.
+     */
+    bool WriteBatchUnlogged(CDBBatch &batch);
+
+    /** Write the memtable to a table file, making all writes durable. */
+    bool Flush();
+
     // Get an estimate of LevelDB memory usage (in bytes).
     size_t DynamicMemoryUsage() const;
 
-    // not available for LevelDB; provide for compatibility with BDB
-    bool Flush() { return true; }
+    // Get the counters of the -dbmmap environment. Returns false if this
+    // database does not use it.
+    bool GetMmapStats(leveldb::MmapReadStats &stats) const;
 
     bool Sync() {
         CDBBatch batch(*this);
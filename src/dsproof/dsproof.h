@@ -57,10 +57,50 @@ public:
     //! Optionally, pass the spending tx for this proof, as an optimization; if
     //! no spendingTx is specified, it will be looked-up in the mempool.
     //!
+    //! This is prepareValidation() followed by verifySignatures().
+    //!
     //! Exceptions: None
     //! (implemented in dsproof_validate.cpp)
     Validity validate(const CTxMemPool &mempool, CTransactionRef spendingTx = {}) const EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    //! Everything needed to verify this proof's signatures, as gathered by
+    //! prepareValidation(). Verifying it needs no locks.
+    struct SignatureCheck {
+        CTxOut txOut;
+        TxId spendingTxId;
+        std::vector<uint8_t> pubkey;
+        uint32_t scriptFlags = 0;
+    };
+
+    //! This *must* be called with cs_main and mempool.cs already held!
+    //!
+    //! Performs the checks of validate() that need the mempool or the chain.
+    //! Returns Valid if `check` was filled in, in which case the proof is
+    //! valid if and only if verifySignatures(check) returns Valid as well.
+    //!
+    //! Exceptions: None
+    //! (implemented in dsproof_validate.cpp)
+    Validity prepareValidation(const CTxMemPool &mempool, SignatureCheck &check,
+                               CTransactionRef spendingTx = {}) const EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+    //! Verifies both spenders' signatures, returning Valid or Invalid. Needs no
+    //! locks, so callers may run it after releasing cs_main. Results are
+    //! cached by proof id, spending txid and script flags, so that the same
+    //! proof arriving from many peers is only verified once.
+    //!
+    //! Exceptions: None
+    //! (implemented in dsproof_validate.cpp)
+    Validity verifySignatures(const SignatureCheck &check) const;
+
+    //! Maximum number of entries kept in the verifySignatures() result cache
+    static constexpr size_t MaxValidationCacheSize = 20'000;
+
+    //! Empties the verifySignatures() result cache (used by tests)
+    static void ClearValidationCache();
+
+    //! Returns how many verifySignatures() calls were answered from the cache
+    static uint64_t GetValidationCacheHits();
+
     //! This *must* be called with cs_main and mempool.cs already held!
     //!
     //! Checks whether a tx is compatible with dsproofs and/or whether
@@ -9,14 +9,21 @@
 #include <chainparams.h>
 #include <coins.h>
 #include <dsproof/dsproof.h>
+#include <hash.h>
 #include <logging.h>
 #include <script/interpreter.h>
 #include <script/script.h>
 #include <script/standard.h>
+#include <sync.h>
 #include <txmempool.h>
+#include <util/saltedhashers.h>
 #include <validation.h> // for pcoinsTip
 
+#include <atomic>
+#include <deque>
+#include <optional>
 #include <stdexcept>
+#include <unordered_map>
 #include <vector>
 
 namespace {
@@ -75,9 +82,69 @@ public:
     const CTxOut &m_txout;
 
 };
+
+/// Bounded cache of verifySignatures() results. Both outcomes are cached: the
+/// result only depends on the (hashed) proof contents, the spending tx the
+/// pubkey was taken from and the script flags, all of which are in the key.
+/// Entries are evicted in insertion order.
+class ValidationCache {
+    Mutex mut;
+    std::unordered_map<uint256, bool, SaltedUint256Hasher> results GUARDED_BY(mut);
+    std::deque<uint256> insertionOrder GUARDED_BY(mut);
+    std::atomic<uint64_t> hits{0};
+
+public:
+    std::optional<bool> lookup(const uint256 &key) {
+        LOCK(mut);
+        if (auto it = results.find(key); it != results.end()) {
+            ++hits;
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+    void insert(const uint256 &key, bool valid) {
+        LOCK(mut);
+        if (!results.emplace(key, valid).second) {
+            return;
+        }
+        insertionOrder.push_back(key);
+        while (insertionOrder.size() > DoubleSpendProof::MaxValidationCacheSize) {
+            results.erase(insertionOrder.front());
+            insertionOrder.pop_front();
+        }
+    }
+
+    void clear() {
+        LOCK(mut);
+        results.clear();
+        insertionOrder.clear();
+        hits = 0;
+    }
+
+    uint64_t getHits() const { return hits; }
+};
+
+ValidationCache g_validationCache;
 } // namespace
 
+/* static */
+void DoubleSpendProof::ClearValidationCache() { g_validationCache.clear(); }
+
+/* static */
+uint64_t DoubleSpendProof::GetValidationCacheHits() { return g_validationCache.getHits(); }
+
 auto DoubleSpendProof::validate(const CTxMemPool &mempool, CTransactionRef spendingTx) const -> Validity
+{
+    SignatureCheck check;
+    const Validity result = prepareValidation(mempool, check, std::move(spendingTx));
+    if (result != Valid)
+        return result;
+    return verifySignatures(check);
+}
+
+auto DoubleSpendProof::prepareValidation(const CTxMemPool &mempool, SignatureCheck &check,
+                                         CTransactionRef spendingTx) const -> Validity
 {
     AssertLockHeld(cs_main);
     AssertLockHeld(mempool.cs);
@@ -108,8 +175,6 @@ auto DoubleSpendProof::validate(const CTxMemPool &mempool, CTransactionRef spend
             return MissingUTXO;
         }
     }
-    const CTxOut &txOut = coin.GetTxOut();
-    const CScript &prevOutScript = coin.GetTxOut().scriptPubKey;
 
     /*
      * Find the matching transaction spending this. Possibly identical to one
@@ -125,15 +190,6 @@ auto DoubleSpendProof::validate(const CTxMemPool &mempool, CTransactionRef spend
     }
     assert(bool(spendingTx));
 
-    /*
-     * TomZ: At this point (2019-07) we only support P2PKH payments.
-     *
-     * Since we have an actually spending tx, we could trivially support various other
-     * types of scripts because all we need to do is replace the signature from our 'tx'
-     * with the one that comes from the DSP.
-     */
-    const txnouttype scriptType = TX_PUBKEYHASH; // FUTURE: look at prevTx to find out script-type
-
     std::vector<uint8_t> pubkey;
     for (const auto &vin : spendingTx->vin) {
         if (vin.prevout == m_outPoint) {
@@ -150,32 +206,59 @@ auto DoubleSpendProof::validate(const CTxMemPool &mempool, CTransactionRef spend
     if (pubkey.empty())
         return Invalid;
 
+    check.txOut = coin.GetTxOut();
+    check.spendingTxId = spendingTx->GetId();
+    check.pubkey = std::move(pubkey);
+    check.scriptFlags = GetMemPoolScriptFlags(::Params().GetConsensus(), ::ChainActive().Tip());
+    return Valid;
+}
+
+auto DoubleSpendProof::verifySignatures(const SignatureCheck &check) const -> Validity
+{
+    const uint256 cacheKey = (CHashWriter(SER_GETHASH, 0) << m_hash << check.spendingTxId << check.scriptFlags)
+                                 .GetHash();
+    if (const auto cached = g_validationCache.lookup(cacheKey)) {
+        return *cached ? Valid : Invalid;
+    }
+
+    const CScript &prevOutScript = check.txOut.scriptPubKey;
+
+    /*
+     * TomZ: At this point (2019-07) we only support P2PKH payments.
+     *
+     * Since we have an actually spending tx, we could trivially support various other
+     * types of scripts because all we need to do is replace the signature from our 'tx'
+     * with the one that comes from the DSP.
+     */
+    const txnouttype scriptType = TX_PUBKEYHASH; // FUTURE: look at prevTx to find out script-type
+
     CScript inScript;
     if (scriptType == TX_PUBKEYHASH) {
         inScript << m_spender1.pushData.front();
-        inScript << pubkey;
+        inScript << check.pubkey;
     }
-    DSPSignatureChecker checker1(this, m_spender1, txOut);
+    DSPSignatureChecker checker1(this, m_spender1, check.txOut);
     ScriptError error;
     ScriptExecutionMetrics metrics; // dummy
 
-    const uint32_t scriptFlags = GetMemPoolScriptFlags(::Params().GetConsensus(), ::ChainActive().Tip());
-
-    if ( ! VerifyScript(inScript, prevOutScript, scriptFlags, checker1, metrics, &error)) {
+    if ( ! VerifyScript(inScript, prevOutScript, check.scriptFlags, checker1, metrics, &error)) {
         LogPrint(BCLog::DSPROOF, "DoubleSpendProof failed validating first tx due to %s\n", ScriptErrorString(error));
+        g_validationCache.insert(cacheKey, false);
         return Invalid;
     }
 
     inScript.clear();
     if (scriptType == TX_PUBKEYHASH) {
         inScript << m_spender2.pushData.front();
-        inScript << pubkey;
+        inScript << check.pubkey;
     }
-    DSPSignatureChecker checker2(this, m_spender2, txOut);
-    if ( ! VerifyScript(inScript, prevOutScript, scriptFlags, checker2, metrics, &error)) {
+    DSPSignatureChecker checker2(this, m_spender2, check.txOut);
+    if ( ! VerifyScript(inScript, prevOutScript, check.scriptFlags, checker2, metrics, &error)) {
         LogPrint(BCLog::DSPROOF, "DoubleSpendProof failed validating second tx due to %s\n", ScriptErrorString(error));
+        g_validationCache.insert(cacheKey, false);
         return Invalid;
     }
+    g_validationCache.insert(cacheKey, true);
     return Valid;
 }
 
@@ -0,0 +1,249 @@
+// Copyright (c) 2026 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/blockstatsindex.h>
+
+#include <chain.h>
+#include <coins.h>
+#include <undo.h>
+#include <util/system.h>
+#include <validation.h>
+#include <version.h>
+
+#include <algorithm>
+#include <limits>
+
+constexpr char DB_BLOCKSTATS = 's';
+
+std::unique_ptr<BlockStatsIndex> g_blockstatsindex;
+
+// outpoint (needed for the utxo index) + nHeight + fCoinBase
+static constexpr size_t PER_UTXO_OVERHEAD =
+    sizeof(COutPoint) + sizeof(uint32_t) + sizeof(bool);
+
+template <typename T> static T CalculateTruncatedMedian(std::vector<T> &scores) {
+    size_t size = scores.size();
+    if (size == 0) {
+        return T();
+    }
+
+    std::sort(scores.begin(), scores.end());
+    if (size % 2 == 0) {
+        return (scores[size / 2 - 1] + scores[size / 2]) / 2;
+    } else {
+        return scores[size / 2];
+    }
+}
+
+void ComputeBlockStats(const CBlock &block, const CBlockUndo *undo,
+                       BlockStats &stats) {
+    stats = BlockStats();
+    stats.block_hash = block.GetHash();
+    stats.txs = block.vtx.size();
+
+    Amount minfee = MAX_MONEY;
+    Amount minfeerate = MAX_MONEY;
+    uint64_t mintxsize = std::numeric_limits<uint64_t>::max();
+    std::vector<Amount> fee_array;
+    std::vector<std::pair<Amount, int64_t>> feerate_array;
+    std::vector<uint64_t> txsize_array;
+    txsize_array.reserve(block.vtx.size());
+    if (undo) {
+        fee_array.reserve(block.vtx.size());
+        feerate_array.reserve(block.vtx.size());
+    }
+
+    for (size_t i_tx = 0; i_tx < block.vtx.size(); ++i_tx) {
+        const auto &tx = block.vtx[i_tx];
+        stats.outs += tx->vout.size();
+        Amount tx_total_out = Amount::zero();
+        for (const CTxOut &out : tx->vout) {
+            tx_total_out += out.nValue;
+            stats.utxo_size_inc +=
+                GetSerializeSize(out, PROTOCOL_VERSION) + PER_UTXO_OVERHEAD;
+        }
+
+        if (tx->IsCoinBase()) {
+            continue;
+        }
+
+        // Don't count coinbase's fake input
+        stats.ins += tx->vin.size();
+        // Don't count coinbase reward
+        stats.total_out += tx_total_out;
+
+        const uint64_t tx_size = tx->GetTotalSize();
+        txsize_array.push_back(tx_size);
+        stats.maxtxsize = std::max(stats.maxtxsize, tx_size);
+        mintxsize = std::min(mintxsize, tx_size);
+        stats.total_size += tx_size;
+
+        if (!undo) {
+            continue;
+        }
+
+        Amount tx_total_in = Amount::zero();
+        // checked access here, guard against programming errors
+        const auto &txundo = undo->vtxundo.at(i_tx - 1);
+        for (const Coin &coin : txundo.vprevout) {
+            const CTxOut &prevoutput = coin.GetTxOut();
+
+            tx_total_in += prevoutput.nValue;
+            stats.utxo_size_inc -=
+                GetSerializeSize(prevoutput, PROTOCOL_VERSION) +
+                PER_UTXO_OVERHEAD;
+        }
+
+        const Amount txfee = tx_total_in - tx_total_out;
+        assert(MoneyRange(txfee));
+        fee_array.push_back(txfee);
+        stats.maxfee = std::max(stats.maxfee, txfee);
+        minfee = std::min(minfee, txfee);
+        stats.totalfee += txfee;
+
+        const Amount feerate = tx_size ? txfee / int64_t(tx_size)
+                                       : Amount::zero();
+        feerate_array.emplace_back(feerate, tx_size);
+        stats.maxfeerate = std::max(stats.maxfeerate, feerate);
+        minfeerate = std::min(minfeerate, feerate);
+    }
+
+    Amount feerate_percentiles[NUM_GETBLOCKSTATS_PERCENTILES] = {
+        Amount::zero()};
+    CalculatePercentilesBySize(feerate_percentiles, feerate_array,
+                               stats.total_size);
+    std::copy(std::begin(feerate_percentiles), std::end(feerate_percentiles),
+              stats.feerate_percentiles.begin());
+
+    stats.minfee = minfee == MAX_MONEY ? Amount::zero() : minfee;
+    stats.minfeerate = minfeerate == MAX_MONEY ? Amount::zero() : minfeerate;
+    stats.mintxsize = txsize_array.empty() ? 0 : mintxsize;
+    stats.medianfee = CalculateTruncatedMedian(fee_array);
+    stats.mediantxsize = CalculateTruncatedMedian(txsize_array);
+}
+
+namespace {
+
+struct DBHeightKey {
+    uint32_t height;
+
+    explicit DBHeightKey(int height_in) : height(height_in) {}
+
+    SERIALIZE_METHODS(DBHeightKey, obj) {
+        char prefix = DB_BLOCKSTATS;
+        READWRITE(prefix);
+        if (prefix != DB_BLOCKSTATS) {
+            throw std::ios_base::failure(
+                "Invalid format for block stats index DB height key");
+        }
+        READWRITE(Using<BigEndianFormatter<4>>(obj.height));
+    }
+};
+
+} // namespace
+
+/**
+ * Access to the block stats database (indexes/blockstats/)
+ *
+ * Like the txindex database, this stores a block locator of the chain the
+ * database is synced to, alongside one BlockStats entry per height.
+ */
+class BlockStatsIndex::DB : public BaseIndex::DB {
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false,
+                bool f_wipe = false);
+
+    bool ReadStats(int height, BlockStats &stats) const;
+    bool WriteStats(int height, const BlockStats &stats);
+    bool ReadStatsRange(int start_height, size_t count,
+                        std::vector<BlockStats> &stats);
+};
+
+BlockStatsIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex::DB(GetDataDir() / "indexes" / "blockstats", n_cache_size,
+                    f_memory, f_wipe) {}
+
+bool BlockStatsIndex::DB::ReadStats(int height, BlockStats &stats) const {
+    return Read(DBHeightKey(height), stats);
+}
+
+bool BlockStatsIndex::DB::WriteStats(int height, const BlockStats &stats) {
+    // A reorg simply overwrites the entry of the disconnected block at the
+    // same height; readers tell stale entries apart by their block hash.
+    return Write(DBHeightKey(height), stats);
+}
+
+bool BlockStatsIndex::DB::ReadStatsRange(int start_height, size_t count,
+                                         std::vector<BlockStats> &stats) {
+    stats.clear();
+    stats.reserve(count);
+
+    std::unique_ptr<CDBIterator> it(NewIterator());
+    it->Seek(DBHeightKey(start_height));
+    for (int height = start_height; stats.size() < count; ++height) {
+        DBHeightKey key(0);
+        if (!it->Valid() || !it->GetKey(key) ||
+            key.height != uint32_t(height)) {
+            return false;
+        }
+        BlockStats value;
+        if (!it->GetValue(value)) {
+            return error("%s: unable to read value at key (%c, %d)", __func__,
+                         DB_BLOCKSTATS, height);
+        }
+        stats.push_back(std::move(value));
+        it->Next();
+    }
+    return true;
+}
+
+BlockStatsIndex::BlockStatsIndex(size_t n_cache_size, bool f_memory,
+                                 bool f_wipe)
+    : m_db(std::make_unique<BlockStatsIndex::DB>(n_cache_size, f_memory,
+                                                 f_wipe)) {}
+
+BlockStatsIndex::~BlockStatsIndex() {}
+
+bool BlockStatsIndex::WriteBlock(const CBlock &block,
+                                 const CBlockIndex *pindex) {
+    // The genesis block has no undo data on disk, but an empty CBlockUndo is
+    // exactly what it would contain.
+    CBlockUndo undo;
+    if (pindex->nHeight > 0 && !UndoReadFromDisk(undo, pindex)) {
+        return error("%s: failed to read undo data for block %s", __func__,
+                     pindex->GetBlockHash().ToString());
+    }
+
+    BlockStats stats;
+    ComputeBlockStats(block, &undo, stats);
+    return m_db->WriteStats(pindex->nHeight, stats);
+}
+
+BaseIndex::DB &BlockStatsIndex::GetDB() const {
+    return *m_db;
+}
+
+bool BlockStatsIndex::LookupStats(const CBlockIndex *pindex,
+                                  BlockStats &stats) const {
+    return m_db->ReadStats(pindex->nHeight, stats) &&
+           stats.block_hash == pindex->GetBlockHash();
+}
+
+bool BlockStatsIndex::LookupStatsRange(
+    const std::vector<const CBlockIndex *> &blocks,
+    std::vector<BlockStats> &stats) const {
+    if (blocks.empty()) {
+        stats.clear();
+        return true;
+    }
+    if (!m_db->ReadStatsRange(blocks.front()->nHeight, blocks.size(), stats)) {
+        return false;
+    }
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        if (stats[i].block_hash != blocks[i]->GetBlockHash()) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,113 @@
+// Copyright (c) 2026 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <amount.h>
+#include <index/base.h>
+#include <primitives/blockhash.h>
+#include <rpc/blockchain.h>
+#include <serialize.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class CBlockUndo;
+
+static constexpr bool DEFAULT_BLOCKSTATSINDEX = false;
+//! Max memory allocated to the block stats index cache in MiB
+static constexpr int64_t MAX_BLOCKSTATSINDEX_CACHE = 16;
+
+/**
+ * Per-block statistics as reported by getblockstats. Only values that need
+ * the block or its undo data are stored; header-derived values (time,
+ * mediantime, subsidy) and averages are filled in when formatting.
+ */
+struct BlockStats {
+    //! Hash of the block these stats belong to, to detect reorgs.
+    BlockHash block_hash;
+    //! Number of transactions, including the coinbase.
+    uint64_t txs{0};
+    //! Inputs, excluding the coinbase's.
+    uint64_t ins{0};
+    uint64_t outs{0};
+    //! Sizes only count non-coinbase transactions; 0 if there are none.
+    uint64_t total_size{0};
+    uint64_t maxtxsize{0};
+    uint64_t mintxsize{0};
+    uint64_t mediantxsize{0};
+    int64_t utxo_size_inc{0};
+    Amount total_out{Amount::zero()};
+    Amount totalfee{Amount::zero()};
+    Amount maxfee{Amount::zero()};
+    Amount minfee{Amount::zero()};
+    Amount medianfee{Amount::zero()};
+    Amount maxfeerate{Amount::zero()};
+    Amount minfeerate{Amount::zero()};
+    std::array<Amount, NUM_GETBLOCKSTATS_PERCENTILES> feerate_percentiles{};
+
+    SERIALIZE_METHODS(BlockStats, obj) {
+        READWRITE(obj.block_hash, VARINT(obj.txs), VARINT(obj.ins),
+                  VARINT(obj.outs), VARINT(obj.total_size),
+                  VARINT(obj.maxtxsize), VARINT(obj.mintxsize),
+                  VARINT(obj.mediantxsize), obj.utxo_size_inc, obj.total_out,
+                  obj.totalfee, obj.maxfee, obj.minfee, obj.medianfee,
+                  obj.maxfeerate, obj.minfeerate);
+        for (auto &feerate : obj.feerate_percentiles) {
+            READWRITE(feerate);
+        }
+    }
+};
+
+/**
+ * Compute the statistics of a block. If undo is null, the values that depend
+ * on the spent outputs (fees, feerates and the spent part of utxo_size_inc)
+ * are left at zero.
+ */
+void ComputeBlockStats(const CBlock &block, const CBlockUndo *undo,
+                       BlockStats &stats);
+
+/**
+ * BlockStatsIndex stores the getblockstats figures of every block in the
+ * active chain, so that they can be served without reading the block and its
+ * undo data from disk. Entries are keyed by height in big-endian order, which
+ * makes ranges of heights a single sequential LevelDB scan.
+ */
+class BlockStatsIndex final : public BaseIndex {
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+protected:
+    bool WriteBlock(const CBlock &block, const CBlockIndex *pindex) override;
+
+    BaseIndex::DB &GetDB() const override;
+
+    const char *GetName() const override { return "blockstatsindex"; }
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit BlockStatsIndex(size_t n_cache_size, bool f_memory = false,
+                             bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an
+    // incomplete type.
+    virtual ~BlockStatsIndex() override;
+
+    /// Look up the stats of a block. Returns false if the block has not been
+    /// indexed (yet), or if the entry at its height belongs to another block.
+    bool LookupStats(const CBlockIndex *pindex, BlockStats &stats) const;
+
+    /// Look up the stats of consecutive blocks of the active chain, given in
+    /// ascending height order. Returns false unless all of them are indexed.
+    bool LookupStatsRange(const std::vector<const CBlockIndex *> &blocks,
+                          std::vector<BlockStats> &stats) const;
+};
+
+/// The global block stats index, used by getblockstats and REST. May be null.
+extern std::unique_ptr<BlockStatsIndex> g_blockstatsindex;
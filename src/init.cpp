@@ -28,9 +28,11 @@
 #include <hash.h>
 #include <httprpc.h>
 #include <httpserver.h>
+#include <index/blockstatsindex.h>
 #include <index/txindex.h>
 #include <interfaces/chain.h>
 #include <key.h>
+#include <memorygovernor.h>
 #include <miner.h>
 #include <net.h>
 #include <net_permissions.h>
@@ -207,6 +209,9 @@ void Interrupt() {
     if (g_txindex) {
         g_txindex->Interrupt();
     }
+    if (g_blockstatsindex) {
+        g_blockstatsindex->Interrupt();
+    }
 }
 
 void Shutdown(NodeContext &node) {
@@ -244,6 +249,9 @@ void Shutdown(NodeContext &node) {
     if (g_txindex) {
         g_txindex->Stop();
     }
+    if (g_blockstatsindex) {
+        g_blockstatsindex->Stop();
+    }
 
     StopTorControl();
 
@@ -265,6 +273,7 @@ void Shutdown(NodeContext &node) {
     g_connman.reset();
     g_banman.reset();
     g_txindex.reset();
+    g_blockstatsindex.reset();
 
     if (::g_mempool.IsLoaded() &&
         gArgs.GetArg("-persistmempool", DEFAULT_PERSIST_MEMPOOL)) {
@@ -445,6 +454,12 @@ void SetupServerArgs() {
                            "not affected. (default: %d)",
                            DEFAULT_BLOCKSONLY),
                  ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-blockstatsindex",
+                 strprintf("Maintain an index of per-block statistics, used "
+                           "by the getblockstats rpc call and the "
+                           "/rest/blockstats endpoint (default: %d)",
+                           DEFAULT_BLOCKSTATSINDEX),
+                 ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-conf=<file>",
                  strprintf("Specify configuration file. Relative paths will be "
                            "prefixed by datadir location. (default: %s)",
@@ -463,6 +478,19 @@ void SetupServerArgs() {
             "Set database cache size in megabytes (%d to %d, default: %d)",
             nMinDbCache, nMaxDbCache, nDefaultDbCache),
         ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    gArgs.AddArg(
+        "-dbcompactionthreads=<n>",
+        strprintf("Maximum number of threads a single database compaction "
+                  "is split over (1 to 64, default: %d)",
+                  DEFAULT_DB_COMPACTION_THREADS),
+        ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-dbmmap",
+                 strprintf("Read database table files through memory "
+                           "mappings, leaving their caching to the operating "
+                           "system, and verify each block's checksum only on "
+                           "its first read (default: %d)",
+                           DEFAULT_DB_MMAP),
+                 ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-debuglogfile=<file>",
                  strprintf("Specify location of debug log file. Relative paths "
                            "will be prefixed by a net-specific datadir "
@@ -510,6 +538,15 @@ void SetupServerArgs() {
                            "(default: %u)",
                            DEFAULT_FINALIZE_HEADERS_PENALTY),
                  ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-lazyblockindex",
+                 strprintf("Keep only the fields needed for chain selection "
+                           "in memory for block index entries at least %d "
+                           "blocks deep in the active chain, and read their "
+                           "other header fields from disk when needed "
+                           "(default: %d)",
+                           LAZY_BLOCK_INDEX_MIN_DEPTH,
+                           DEFAULT_LAZY_BLOCK_INDEX),
+                 ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-loadblock=<file>",
                  "Imports blocks from external blk000??.dat file on startup",
                  ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
@@ -526,6 +563,15 @@ void SetupServerArgs() {
                            "memory (default: %u)",
                            DEFAULT_MAX_ORPHAN_TRANSACTIONS),
                  ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-memorybudget=<n>",
+                 strprintf("Share <n> megabytes between the database caches, "
+                           "the in-memory UTXO set and the mempool, and move "
+                           "memory between the UTXO set and the mempool as the "
+                           "node syncs and runs. Replaces -dbcache, while "
+                           "-maxmempool still caps the mempool (0 to disable, "
+                           "default: %d)",
+                           DEFAULT_MEMORY_BUDGET),
+                 ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-mempoolexpiry=<n>",
                  strprintf("Do not keep transactions in the mempool longer "
                            "than <n> hours (default: %u)",
@@ -804,6 +850,15 @@ void SetupServerArgs() {
                   "MiB per 24h (0 for no limit, default: %d)",
                   DEFAULT_MAX_UPLOAD_TARGET),
         ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
+    gArgs.AddArg(
+        "-maxpeerblockuploadrate=<n>",
+        strprintf("Limit the rate at which full blocks are uploaded to each "
+                  "peer to <n> kB/s. Other messages, such as transaction and "
+                  "compact block relay, are always sent ahead of queued "
+                  "blocks. Peers with noban permission are exempt (0 for no "
+                  "limit, default: %d)",
+                  DEFAULT_MAX_PEER_BLOCK_UPLOAD_RATE),
+        ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
 
     g_wallet_init_interface.AddWalletOptions();
 
@@ -1716,6 +1771,10 @@ bool AppInitParameterInteraction(Config &config) {
         if (gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX)) {
             return InitError(_("Prune mode is incompatible with -txindex."));
         }
+        if (gArgs.GetBoolArg("-blockstatsindex", DEFAULT_BLOCKSTATSINDEX)) {
+            return InitError(
+                _("Prune mode is incompatible with -blockstatsindex."));
+        }
     }
 
     // -bind and -whitebind can't be set when not listening
@@ -1795,6 +1854,8 @@ bool AppInitParameterInteraction(Config &config) {
     fCheckBlockIndex = gArgs.GetBoolArg("-checkblockindex",
                                         chainparams.DefaultConsistencyChecks());
     fCheckBlockReads = gArgs.GetBoolArg("-checkblockreads", chainparams.DefaultConsistencyChecks());
+    fLazyBlockIndex =
+        gArgs.GetBoolArg("-lazyblockindex", DEFAULT_LAZY_BLOCK_INDEX);
     fCheckpointsEnabled =
         gArgs.GetBoolArg("-checkpoints", DEFAULT_CHECKPOINTS_ENABLED);
     if (fCheckpointsEnabled) {
@@ -2476,7 +2537,11 @@ bool AppInitMain(Config &config, RPCServer &rpcServer,
     bool fReindexChainState = gArgs.GetBoolArg("-reindex-chainstate", false);
 
     // cache size calculations
-    int64_t nTotalCache = (gArgs.GetArg("-dbcache", nDefaultDbCache) << 20);
+    const int64_t nMemoryBudget =
+        gArgs.GetArg("-memorybudget", DEFAULT_MEMORY_BUDGET) << 20;
+    int64_t nTotalCache = nMemoryBudget > 0
+                              ? nMemoryBudget
+                              : (gArgs.GetArg("-dbcache", nDefaultDbCache) << 20);
     // total cache cannot be less than nMinDbCache
     nTotalCache = std::max(nTotalCache, nMinDbCache << 20);
     // total cache cannot be greater than nMaxDbcache
@@ -2489,6 +2554,12 @@ bool AppInitMain(Config &config, RPCServer &rpcServer,
                                       ? nMaxTxIndexCache << 20
                                       : 0);
     nTotalCache -= nTxIndexCache;
+    int64_t nBlockStatsIndexCache = std::min(
+        nTotalCache / 8,
+        gArgs.GetBoolArg("-blockstatsindex", DEFAULT_BLOCKSTATSINDEX)
+            ? MAX_BLOCKSTATSINDEX_CACHE << 20
+            : 0);
+    nTotalCache -= nBlockStatsIndexCache;
     // use 25%-50% of the remainder for disk cache
     int64_t nCoinDBCache =
         std::min(nTotalCache / 2, (nTotalCache / 4) + (1 << 23));
@@ -2497,6 +2568,17 @@ bool AppInitMain(Config &config, RPCServer &rpcServer,
     nTotalCache -= nCoinDBCache;
     // the rest goes to in-memory cache
     nCoinCacheUsage = nTotalCache;
+    if (nMemoryBudget > 0) {
+        // the rest is shared with the mempool, and rebalanced at runtime
+        const int64_t nBudget = std::min(std::max(nMemoryBudget, nMinDbCache << 20),
+                                         nMaxDbCache << 20);
+        g_memory_governor = std::make_unique<MemoryGovernor>(
+            nBudget, nBudget - nTotalCache, config.GetMaxMemPoolSize());
+        const MemoryGovernor::Info info = g_memory_governor->GetInfo();
+        nCoinCacheUsage = info.coinsCacheSize;
+        config.SetMaxMemPoolSize(info.mempoolSize);
+        ScheduleMemoryGovernor(config, scheduler);
+    }
     int64_t nMempoolSizeMax = config.GetMaxMemPoolSize();
     LogPrintf("Cache configuration:\n");
     LogPrintf("* Using %.1fMiB for block index database\n",
@@ -2505,12 +2587,23 @@ bool AppInitMain(Config &config, RPCServer &rpcServer,
         LogPrintf("* Using %.1fMiB for transaction index database\n",
                   nTxIndexCache * (1.0 / 1024 / 1024));
     }
+    if (gArgs.GetBoolArg("-blockstatsindex", DEFAULT_BLOCKSTATSINDEX)) {
+        LogPrintf("* Using %.1fMiB for block stats index database\n",
+                  nBlockStatsIndexCache * (1.0 / 1024 / 1024));
+    }
     LogPrintf("* Using %.1fMiB for chain state database\n",
               nCoinDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1fMiB for in-memory UTXO set (plus up to %.1fMiB of "
               "unused mempool space)\n",
               nCoinCacheUsage * (1.0 / 1024 / 1024),
               nMempoolSizeMax * (1.0 / 1024 / 1024));
+    if (g_memory_governor) {
+        LogPrintf("* Rebalancing %.1fMiB between the in-memory UTXO set and "
+                  "the mempool (mempool: %.1fMiB to %.1fMiB)\n",
+                  nTotalCache * (1.0 / 1024 / 1024),
+                  g_memory_governor->GetMinMempoolSize() * (1.0 / 1024 / 1024),
+                  g_memory_governor->GetMaxMempoolSize() * (1.0 / 1024 / 1024));
+    }
 
     int64_t nStart = 0;
     bool fLoaded = false;
@@ -2715,6 +2808,11 @@ bool AppInitMain(Config &config, RPCServer &rpcServer,
         g_txindex = std::make_unique<TxIndex>(nTxIndexCache, false, fReindex);
         g_txindex->Start();
     }
+    if (gArgs.GetBoolArg("-blockstatsindex", DEFAULT_BLOCKSTATSINDEX)) {
+        g_blockstatsindex = std::make_unique<BlockStatsIndex>(
+            nBlockStatsIndexCache, false, fReindex);
+        g_blockstatsindex->Start();
+    }
 
     // Step 9: load wallet
     for (const auto &client : node.chain_clients) {
@@ -2835,6 +2933,10 @@ bool AppInitMain(Config &config, RPCServer &rpcServer,
 
     connOptions.nMaxOutboundTimeframe = nMaxOutboundTimeframe;
     connOptions.nMaxOutboundLimit = nMaxOutboundLimit;
+    connOptions.nMaxPeerBlockUploadRate =
+        std::max<int64_t>(0, gArgs.GetArg("-maxpeerblockuploadrate",
+                                          DEFAULT_MAX_PEER_BLOCK_UPLOAD_RATE)) *
+        1000;
     connOptions.m_peer_connect_timeout = peer_connect_timeout;
 
     for (const std::string &bind_arg : gArgs.GetArgs("-bind")) {
@@ -308,6 +308,22 @@ namespace {
             }
             return result;
         }
+        bool getWalletTxs(TxId &start, size_t max_count,
+                          std::vector<WalletTx> &result) override {
+            auto locked_chain = m_wallet.chain().lock();
+            LOCK(m_wallet.cs_wallet);
+            auto it = m_wallet.mapWallet.lower_bound(start);
+            for (; it != m_wallet.mapWallet.end() && max_count > 0;
+                 ++it, --max_count) {
+                result.emplace_back(
+                    MakeWalletTx(*locked_chain, m_wallet, it->second));
+            }
+            if (it == m_wallet.mapWallet.end()) {
+                return false;
+            }
+            start = it->first;
+            return true;
+        }
         bool tryGetTxStatus(const TxId &txid,
                             interfaces::WalletTxStatus &tx_status,
                             int &num_blocks, int64_t &block_time) override {
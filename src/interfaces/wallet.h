@@ -169,6 +169,12 @@ public:
     //! Get list of all wallet transactions.
     virtual std::vector<WalletTx> getWalletTxs() = 0;
 
+    //! Get up to max_count wallet transactions in txid order, starting with
+    //! txid start, and append them to result. Returns whether more
+    //! transactions follow, in which case start is set to the next txid.
+    virtual bool getWalletTxs(TxId &start, size_t max_count,
+                              std::vector<WalletTx> &result) = 0;
+
     //! Try to get updated status for a particular transaction, if possible
     //! without blocking.
     virtual bool tryGetTxStatus(const TxId &txid, WalletTxStatus &tx_status,
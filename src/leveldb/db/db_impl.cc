@@ -9,6 +9,7 @@
 #include <string>
 #include <stdint.h>
 #include <stdio.h>
+#include <thread>
 #include <vector>
 #include "db/builder.h"
 #include "db/db_iter.h"
@@ -42,6 +43,7 @@ struct DBImpl::Writer {
   Status status;
   WriteBatch* batch;
   bool sync;
+  bool skip_log;
   bool done;
   port::CondVar cv;
 
@@ -57,6 +59,9 @@ struct DBImpl::CompactionState {
   // we can drop all entries for the same key with sequence numbers < S.
   SequenceNumber smallest_snapshot;
 
+  // Position of this compaction (or subcompaction) in the key space.
+  Compaction::KeyState key_state;
+
   // Files produced by compaction
   struct Output {
     uint64_t number;
@@ -98,6 +103,7 @@ Options SanitizeOptions(const std::string& dbname,
   ClipToRange(&result.write_buffer_size, 64<<10,                      1<<30);
   ClipToRange(&result.max_file_size,     1<<20,                       1<<30);
   ClipToRange(&result.block_size,        1<<10,                       4<<20);
+  ClipToRange(&result.max_subcompactions, 1,                          64);
   if (result.info_log == NULL) {
     // Open a log file in the same directory as the db
     src.env->CreateDir(dbname);  // In case it does not exist
@@ -619,6 +625,10 @@ void DBImpl::TEST_CompactRange(int level, const Slice* begin,const Slice* end) {
 }
 
 Status DBImpl::TEST_CompactMemTable() {
+  return FlushMemTable();
+}
+
+Status DBImpl::FlushMemTable() {
   // NULL batch means just wait for earlier writes to be done
   Status s = Write(WriteOptions(), NULL);
   if (s.ok()) {
@@ -884,30 +894,63 @@ Status DBImpl::InstallCompactionResults(CompactionState* compact) {
   return versions_->LogAndApply(compact->compaction->edit(), &mutex_);
 }
 
-Status DBImpl::DoCompactionWork(CompactionState* compact) {
-  const uint64_t start_micros = env_->NowMicros();
-  int64_t imm_micros = 0;  // Micros spent doing imm_ compactions
+void DBImpl::GetSubcompactionBoundaries(
+    Compaction* c, std::vector<std::string>* boundaries) {
+  boundaries->clear();
+  if (options_.max_subcompactions < 2) {
+    return;
+  }
 
-  Log(options_.info_log,  "Compacting %d@%d + %d@%d files",
-      compact->compaction->num_input_files(0),
-      compact->compaction->level(),
-      compact->compaction->num_input_files(1),
-      compact->compaction->level() + 1);
+  // Every input file ends at some user key; the data before that key is
+  // roughly the size of the files ending at or before it.
+  std::vector<std::pair<std::string, uint64_t> > ends;
+  uint64_t total_bytes = 0;
+  for (int which = 0; which < 2; which++) {
+    for (int i = 0; i < c->num_input_files(which); i++) {
+      const FileMetaData* f = c->input(which, i);
+      ends.push_back(std::make_pair(f->largest.user_key().ToString(),
+                                    f->file_size));
+      total_bytes += f->file_size;
+    }
+  }
 
-  assert(versions_->NumLevelFiles(compact->compaction->level()) > 0);
-  assert(compact->builder == NULL);
-  assert(compact->outfile == NULL);
-  if (snapshots_.empty()) {
-    compact->smallest_snapshot = versions_->LastSequence();
-  } else {
-    compact->smallest_snapshot = snapshots_.oldest()->number_;
+  // Only split if each range is large enough to fill an output file.
+  const uint64_t ranges = std::min<uint64_t>(
+      options_.max_subcompactions, total_bytes / c->MaxOutputFileSize());
+  if (ranges < 2) {
+    return;
   }
 
-  // Release mutex while we're actually doing the compaction work
-  mutex_.Unlock();
+  const Comparator* ucmp = user_comparator();
+  std::sort(ends.begin(), ends.end(),
+            [ucmp](const std::pair<std::string, uint64_t>& a,
+                   const std::pair<std::string, uint64_t>& b) {
+              return ucmp->Compare(a.first, b.first) < 0;
+            });
+  uint64_t sum = 0;
+  // The last file end is the end of the inputs, which is not a boundary.
+  for (size_t i = 0; i + 1 < ends.size(); i++) {
+    sum += ends[i].second;
+    if (sum >= total_bytes * (boundaries->size() + 1) / ranges &&
+        (boundaries->empty() ||
+         ucmp->Compare(ends[i].first, boundaries->back()) > 0)) {
+      boundaries->push_back(ends[i].first);
+      if (boundaries->size() + 1 == ranges) {
+        break;
+      }
+    }
+  }
+}
 
+Status DBImpl::DoCompactionRange(CompactionState* compact, const Slice* begin,
+                                 const Slice* end, int64_t* imm_micros) {
   Iterator* input = versions_->MakeInputIterator(compact->compaction);
-  input->SeekToFirst();
+  if (begin == NULL) {
+    input->SeekToFirst();
+  } else {
+    InternalKey start(*begin, kMaxSequenceNumber, kValueTypeForSeek);
+    input->Seek(start.Encode());
+  }
   Status status;
   ParsedInternalKey ikey;
   std::string current_user_key;
@@ -915,7 +958,7 @@ Status DBImpl::DoCompactionWork(CompactionState* compact) {
   SequenceNumber last_sequence_for_key = kMaxSequenceNumber;
   for (; input->Valid() && !shutting_down_.Acquire_Load(); ) {
     // Prioritize immutable compaction work
-    if (has_imm_.NoBarrier_Load() != NULL) {
+    if (imm_micros != NULL && has_imm_.NoBarrier_Load() != NULL) {
       const uint64_t imm_start = env_->NowMicros();
       mutex_.Lock();
       if (imm_ != NULL) {
@@ -923,11 +966,16 @@ Status DBImpl::DoCompactionWork(CompactionState* compact) {
         bg_cv_.SignalAll();  // Wakeup MakeRoomForWrite() if necessary
       }
       mutex_.Unlock();
-      imm_micros += (env_->NowMicros() - imm_start);
+      *imm_micros += (env_->NowMicros() - imm_start);
     }
 
     Slice key = input->key();
-    if (compact->compaction->ShouldStopBefore(key) &&
+    if (end != NULL && ParseInternalKey(key, &ikey) &&
+        user_comparator()->Compare(ikey.user_key, *end) >= 0) {
+      // The rest belongs to the next range
+      break;
+    }
+    if (compact->compaction->ShouldStopBefore(key, &compact->key_state) &&
         compact->builder != NULL) {
       status = FinishCompactionOutputFile(compact, input);
       if (!status.ok()) {
@@ -957,7 +1005,8 @@ Status DBImpl::DoCompactionWork(CompactionState* compact) {
         drop = true;    // (A)
       } else if (ikey.type == kTypeDeletion &&
                  ikey.sequence <= compact->smallest_snapshot &&
-                 compact->compaction->IsBaseLevelForKey(ikey.user_key)) {
+                 compact->compaction->IsBaseLevelForKey(ikey.user_key,
+                                                        &compact->key_state)) {
         // For this user key:
         // (1) there is no data in higher levels
         // (2) data in lower levels will have larger sequence numbers
@@ -970,15 +1019,6 @@ Status DBImpl::DoCompactionWork(CompactionState* compact) {
 
       last_sequence_for_key = ikey.sequence;
     }
-#if 0
-    Log(options_.info_log,
-        "  Compact: %s, seq %d, type: %d %d, drop: %d, is_base: %d, "
-        "%d smallest_snapshot: %d",
-        ikey.user_key.ToString().c_str(),
-        (int)ikey.sequence, ikey.type, kTypeValue, drop,
-        compact->compaction->IsBaseLevelForKey(ikey.user_key),
-        (int)last_sequence_for_key, (int)compact->smallest_snapshot);
-#endif
 
     if (!drop) {
       // Open output file if necessary
@@ -1017,7 +1057,78 @@ Status DBImpl::DoCompactionWork(CompactionState* compact) {
     status = input->status();
   }
   delete input;
-  input = NULL;
+  return status;
+}
+
+Status DBImpl::DoCompactionWork(CompactionState* compact) {
+  const uint64_t start_micros = env_->NowMicros();
+  int64_t imm_micros = 0;  // Micros spent doing imm_ compactions
+
+  std::vector<std::string> boundaries;
+  GetSubcompactionBoundaries(compact->compaction, &boundaries);
+
+  Log(options_.info_log,  "Compacting %d@%d + %d@%d files in %d range(s)",
+      compact->compaction->num_input_files(0),
+      compact->compaction->level(),
+      compact->compaction->num_input_files(1),
+      compact->compaction->level() + 1,
+      static_cast<int>(boundaries.size() + 1));
+
+  assert(versions_->NumLevelFiles(compact->compaction->level()) > 0);
+  assert(compact->builder == NULL);
+  assert(compact->outfile == NULL);
+  if (snapshots_.empty()) {
+    compact->smallest_snapshot = versions_->LastSequence();
+  } else {
+    compact->smallest_snapshot = snapshots_.oldest()->number_;
+  }
+
+  // Release mutex while we're actually doing the compaction work
+  mutex_.Unlock();
+
+  Status status;
+  if (boundaries.empty()) {
+    status = DoCompactionRange(compact, NULL, NULL, &imm_micros);
+  } else {
+    // Range i covers [boundaries[i-1], boundaries[i]).  This thread merges
+    // the first range, and so remains the one that flushes imm_; the other
+    // ranges each get their own thread and output files.
+    std::vector<Slice> bounds(boundaries.begin(), boundaries.end());
+    std::vector<CompactionState*> subs;
+    std::vector<Status> sub_status(bounds.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < bounds.size(); i++) {
+      CompactionState* sub = new CompactionState(compact->compaction);
+      sub->smallest_snapshot = compact->smallest_snapshot;
+      subs.push_back(sub);
+      const Slice* sub_end = (i + 1 < bounds.size() ? &bounds[i + 1] : NULL);
+      threads.emplace_back([this, sub, &bounds, i, sub_end, &sub_status]() {
+        sub_status[i] = DoCompactionRange(sub, &bounds[i], sub_end, NULL);
+      });
+    }
+    status = DoCompactionRange(compact, NULL, &bounds[0], &imm_micros);
+    for (size_t i = 0; i < threads.size(); i++) {
+      threads[i].join();
+    }
+
+    // Collect the outputs of all ranges, in key order, so that
+    // CleanupCompaction() sees every file of a failed compaction.
+    for (size_t i = 0; i < subs.size(); i++) {
+      CompactionState* sub = subs[i];
+      if (status.ok()) {
+        status = sub_status[i];
+      }
+      if (sub->builder != NULL) {
+        sub->builder->Abandon();
+        delete sub->builder;
+      }
+      delete sub->outfile;
+      compact->outputs.insert(compact->outputs.end(), sub->outputs.begin(),
+                              sub->outputs.end());
+      compact->total_bytes += sub->total_bytes;
+      delete sub;
+    }
+  }
 
   CompactionStats stats;
   stats.micros = env_->NowMicros() - start_micros - imm_micros;
@@ -1195,6 +1306,7 @@ Status DBImpl::Write(const WriteOptions& options, WriteBatch* my_batch) {
   Writer w(&mutex_);
   w.batch = my_batch;
   w.sync = options.sync;
+  w.skip_log = options.skip_log;
   w.done = false;
 
   MutexLock l(&mutex_);
@@ -1221,7 +1333,9 @@ Status DBImpl::Write(const WriteOptions& options, WriteBatch* my_batch) {
     // into mem_.
     {
       mutex_.Unlock();
-      status = log_->AddRecord(WriteBatchInternal::Contents(updates));
+      if (!options.skip_log) {
+        status = log_->AddRecord(WriteBatchInternal::Contents(updates));
+      }
       bool sync_error = false;
       if (status.ok() && options.sync) {
         status = logfile_->Sync();
@@ -1292,6 +1406,11 @@ WriteBatch* DBImpl::BuildBatchGroup(Writer** last_writer) {
       break;
     }
 
+    if (w->skip_log != first->skip_log) {
+      // Logged and unlogged writes cannot share a log record.
+      break;
+    }
+
     if (w->batch != NULL) {
       size += WriteBatchInternal::ByteSize(w->batch);
       if (size > max_size) {
@@ -1485,6 +1604,10 @@ Status DB::Delete(const WriteOptions& opt, const Slice& key) {
   return Write(opt, &batch);
 }
 
+Status DB::FlushMemTable() {
+  return Status::OK();
+}
+
 DB::~DB() { }
 
 Status DB::Open(const Options& options, const std::string& dbname,
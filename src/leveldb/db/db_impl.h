@@ -7,6 +7,8 @@
 
 #include <deque>
 #include <set>
+#include <string>
+#include <vector>
 #include "db/dbformat.h"
 #include "db/log_writer.h"
 #include "db/snapshot.h"
@@ -17,6 +19,7 @@
 
 namespace leveldb {
 
+class Compaction;
 class MemTable;
 class TableCache;
 class Version;
@@ -41,6 +44,7 @@ class DBImpl : public DB {
   virtual bool GetProperty(const Slice& property, std::string* value);
   virtual void GetApproximateSizes(const Range* range, int n, uint64_t* sizes);
   virtual void CompactRange(const Slice* begin, const Slice* end);
+  virtual Status FlushMemTable();
 
   // Extra methods (for testing) that are not in the public DB interface
 
@@ -113,6 +117,19 @@ class DBImpl : public DB {
   Status DoCompactionWork(CompactionState* compact)
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  // Pick user keys that split the inputs of *c into up to
+  // options_.max_subcompactions ranges of similar size.  Leaves *boundaries
+  // empty if the compaction is too small to be worth splitting.
+  void GetSubcompactionBoundaries(Compaction* c,
+                                  std::vector<std::string>* boundaries);
+
+  // Merge the compaction inputs with user keys in [*begin,*end) into
+  // compact->outputs.  NULL means the start or end of the inputs.  Only the
+  // background thread itself may flush the immutable memtable meanwhile,
+  // which is signalled by non-NULL imm_micros.
+  Status DoCompactionRange(CompactionState* compact, const Slice* begin,
+                           const Slice* end, int64_t* imm_micros);
+
   Status OpenCompactionOutputFile(CompactionState* compact);
   Status FinishCompactionOutputFile(CompactionState* compact, Iterator* input);
   Status InstallCompactionResults(CompactionState* compact)
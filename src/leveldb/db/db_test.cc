@@ -1006,6 +1006,72 @@ TEST(DBTest, CompactionsGenerateMultipleFiles) {
   }
 }
 
+TEST(DBTest, SubcompactionsGenerateDisjointFiles) {
+  Options options = CurrentOptions();
+  options.write_buffer_size = 100000000;        // Large write buffer
+  options.max_subcompactions = 4;
+  Reopen(&options);
+
+  Random rnd(301);
+
+  // Write 16MB (160 values, each 100K) and move it to level-1, which gives
+  // the next compaction enough file boundaries to split at.
+  for (int i = 0; i < 160; i++) {
+    ASSERT_OK(Put(Key(i), RandomString(&rnd, 100000)));
+  }
+  Reopen(&options);
+  dbfull()->TEST_CompactRange(0, NULL, NULL);
+  ASSERT_GT(NumTableFilesAtLevel(1), 4);
+
+  // Overwrite or delete every key, then merge level-0 into level-1 again.
+  std::vector<std::string> values;
+  for (int i = 0; i < 160; i++) {
+    values.push_back(RandomString(&rnd, 100000));
+    if (i % 3 == 0) {
+      ASSERT_OK(Delete(Key(i)));
+    } else {
+      ASSERT_OK(Put(Key(i), values[i]));
+    }
+  }
+  Reopen(&options);
+  ASSERT_EQ(NumTableFilesAtLevel(0), 1);
+  dbfull()->TEST_CompactRange(0, NULL, NULL);
+
+  ASSERT_EQ(NumTableFilesAtLevel(0), 0);
+  ASSERT_GT(NumTableFilesAtLevel(1), 4);
+  for (int i = 0; i < 160; i++) {
+    ASSERT_EQ(Get(Key(i)), i % 3 == 0 ? "NOT_FOUND" : values[i]);
+  }
+  Iterator* iter = db_->NewIterator(ReadOptions());
+  int count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    count++;
+  }
+  delete iter;
+  ASSERT_EQ(count, 160 - 54);
+}
+
+TEST(DBTest, SkipLogWrites) {
+  ASSERT_OK(Put("foo", "v1"));
+  WriteOptions unlogged;
+  unlogged.skip_log = true;
+  ASSERT_OK(db_->Put(unlogged, "bar", "v2"));
+  ASSERT_EQ("v2", Get("bar"));
+
+  // Unlogged writes are lost on reopening unless flushed first.
+  Reopen();
+  ASSERT_EQ("v1", Get("foo"));
+  ASSERT_EQ("NOT_FOUND", Get("bar"));
+
+  ASSERT_OK(db_->Put(unlogged, "bar", "v3"));
+  ASSERT_OK(db_->FlushMemTable());
+  ASSERT_OK(Put("baz", "v4"));
+  Reopen();
+  ASSERT_EQ("v1", Get("foo"));
+  ASSERT_EQ("v3", Get("bar"));
+  ASSERT_EQ("v4", Get("baz"));
+}
+
 TEST(DBTest, RepeatedWritesToSameKey) {
   Options options = CurrentOptions();
   options.env = env_;
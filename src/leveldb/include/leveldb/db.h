@@ -142,6 +142,11 @@ class DB {
   //    db->CompactRange(NULL, NULL);
   virtual void CompactRange(const Slice* begin, const Slice* end) = 0;
 
+  // Write the contents of the memtable to a table file and wait until that
+  // is done, so that all previous writes, including those made with
+  // WriteOptions::skip_log, are durable.
+  virtual Status FlushMemTable();
+
  private:
   // No copying allowed
   DB(const DB&);
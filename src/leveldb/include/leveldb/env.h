@@ -355,6 +355,35 @@ class EnvWrapper : public Env {
   Env* target_;
 };
 
+// Counters of an environment returned by NewMmapReadEnv().
+struct MmapReadStats {
+  uint64_t mapped_files;       // Files currently mapped
+  uint64_t mapped_bytes;       // Total size of those mappings
+  uint64_t verified_blocks;    // Table blocks checksummed on their first read
+  uint64_t checksum_failures;  // Table blocks that failed that check
+};
+
+// An Env that reads files through mmap(), see NewMmapReadEnv().
+class MmapReadEnv : public EnvWrapper {
+ public:
+  explicit MmapReadEnv(Env* t) : EnvWrapper(t) { }
+  virtual ~MmapReadEnv();
+
+  virtual MmapReadStats GetStats() const = 0;
+};
+
+// Returns a new environment that serves every random-access file through
+// mmap(), however many are open, and delegates all other calls to base_env.
+// Table data read this way is not copied into the block cache. The checksum
+// of each table block is verified the first time it is read, so callers may
+// turn off ReadOptions::verify_checksums. If random_access is true, the
+// kernel is advised not to read ahead around accesses to the mappings.
+//
+// Returns NULL on platforms where this is not supported (non-POSIX, or
+// pointers narrower than 64 bits). The caller must delete the result when it
+// is no longer needed. *base_env must remain live while the result is in use.
+MmapReadEnv* NewMmapReadEnv(Env* base_env, bool random_access);
+
 }  // namespace leveldb
 
 #endif  // STORAGE_LEVELDB_INCLUDE_ENV_H_
@@ -124,6 +124,15 @@ struct Options {
   // Default: 2MB
   size_t max_file_size;
 
+  // Maximum number of threads a single compaction may be split over.  A
+  // large compaction (such as level-0 files that span the whole key space
+  // being merged into level-1) is divided into disjoint key ranges that are
+  // merged concurrently, which drains level-0 faster and so reduces the time
+  // writes are stalled on it.  Values below 2 disable splitting.
+  //
+  // Default: 1
+  int max_subcompactions;
+
   // Compress blocks using the specified compression algorithm.  This
   // parameter can be changed dynamically.
   //
@@ -203,8 +212,18 @@ struct WriteOptions {
   // Default: false
   bool sync;
 
+  // If true, the write is not appended to the log file, and only becomes
+  // durable once the memtable holding it has been written to a table file,
+  // e.g. by DB::FlushMemTable().  If the process crashes before that, the
+  // write is lost along with all later writes, so the database recovers to
+  // the state before it.  This roughly halves the I/O of bulk loads.
+  //
+  // Default: false
+  bool skip_log;
+
   WriteOptions()
-      : sync(false) {
+      : sync(false),
+        skip_log(false) {
   }
 };
 
@@ -6,8 +6,9 @@
 // four bytes at a time.
 //
 // In a separate source file to allow this accelerated CRC32C function to be
-// compiled with the appropriate compiler flags to enable x86 SSE 4.2
-// instructions.
+// compiled with the appropriate compiler flags to enable x86 SSE 4.2 or ARMv8
+// CRC instructions. Whether the CPU running the program supports them is
+// checked at runtime by HasAcceleratedCRC32C().
 
 #include <stdint.h>
 #include <string.h>
@@ -21,22 +22,38 @@
 #include <nmmintrin.h>
 #endif
 
+#define CRC32C_U8(crc, v) _mm_crc32_u8((crc), (v))
+#define CRC32C_U32(crc, v) _mm_crc32_u32((crc), (v))
+#define CRC32C_U64(crc, v) _mm_crc32_u64((crc), (v))
+
+#elif defined(LEVELDB_PLATFORM_POSIX_ARMV8_CRC)
+
+#include <arm_acle.h>
+
+// ARMv8 has the same CRC32C instructions, in the same widths, as SSE 4.2.
+#define CRC32C_U8(crc, v) __crc32cb((crc), (v))
+#define CRC32C_U32(crc, v) __crc32cw((crc), (v))
+#define CRC32C_U64(crc, v) __crc32cd((uint32_t)(crc), (v))
+
 #endif  // defined(LEVELDB_PLATFORM_POSIX_SSE)
 
 namespace leveldb {
 namespace port {
 
-#if defined(LEVELDB_PLATFORM_POSIX_SSE)
+#if defined(LEVELDB_PLATFORM_POSIX_SSE) || \
+    defined(LEVELDB_PLATFORM_POSIX_ARMV8_CRC)
 
 // Used to fetch a naturally-aligned 32-bit word in little endian byte-order
 static inline uint32_t LE_LOAD32(const uint8_t *p) {
-  // SSE is x86 only, so ensured that |p| is always little-endian.
+  // Both SSE and the ARMv8 CRC path are little-endian only, so |p| is always
+  // little-endian.
   uint32_t word;
   memcpy(&word, p, sizeof(word));
   return word;
 }
 
-#if defined(_M_X64) || defined(__x86_64__)  // LE_LOAD64 is only used on x64.
+#if defined(_M_X64) || defined(__x86_64__) || defined(__aarch64__)
+// LE_LOAD64 is only used on 64-bit targets.
 
 // Used to fetch a naturally-aligned 64-bit word in little endian byte-order
 static inline uint64_t LE_LOAD64(const uint8_t *p) {
@@ -45,14 +62,16 @@ static inline uint64_t LE_LOAD64(const uint8_t *p) {
   return dword;
 }
 
-#endif  // defined(_M_X64) || defined(__x86_64__)
+#endif  // defined(_M_X64) || defined(__x86_64__) || defined(__aarch64__)
 
-#endif  // defined(LEVELDB_PLATFORM_POSIX_SSE)
+#endif  // defined(LEVELDB_PLATFORM_POSIX_SSE) ||
+        // defined(LEVELDB_PLATFORM_POSIX_ARMV8_CRC)
 
 // For further improvements see Intel publication at:
 // http://download.intel.com/design/intarch/papers/323405.pdf
 uint32_t AcceleratedCRC32C(uint32_t crc, const char* buf, size_t size) {
-#if !defined(LEVELDB_PLATFORM_POSIX_SSE)
+#if !defined(LEVELDB_PLATFORM_POSIX_SSE) && \
+    !defined(LEVELDB_PLATFORM_POSIX_ARMV8_CRC)
   return 0;
 #else
 
@@ -61,14 +80,14 @@ uint32_t AcceleratedCRC32C(uint32_t crc, const char* buf, size_t size) {
   uint32_t l = crc ^ 0xffffffffu;
 
 #define STEP1 do {                              \
-    l = _mm_crc32_u8(l, *p++);                  \
+    l = CRC32C_U8(l, *p++);                     \
 } while (0)
 #define STEP4 do {                              \
-    l = _mm_crc32_u32(l, LE_LOAD32(p));         \
+    l = CRC32C_U32(l, LE_LOAD32(p));            \
     p += 4;                                     \
 } while (0)
 #define STEP8 do {                              \
-    l = _mm_crc32_u64(l, LE_LOAD64(p));         \
+    l = CRC32C_U64(l, LE_LOAD64(p));            \
     p += 8;                                     \
 } while (0)
 
@@ -78,8 +97,8 @@ uint32_t AcceleratedCRC32C(uint32_t crc, const char* buf, size_t size) {
       STEP1;
     }
 
-    // _mm_crc32_u64 is only available on x64.
-#if defined(_M_X64) || defined(__x86_64__)
+    // CRC32C_U64 is only available on 64-bit targets.
+#if defined(_M_X64) || defined(__x86_64__) || defined(__aarch64__)
     // Process 8 bytes at a time
     while ((e-p) >= 8) {
       STEP8;
@@ -88,12 +107,12 @@ uint32_t AcceleratedCRC32C(uint32_t crc, const char* buf, size_t size) {
     if ((e-p) >= 4) {
       STEP4;
     }
-#else  // !(defined(_M_X64) || defined(__x86_64__))
+#else  // !(defined(_M_X64) || defined(__x86_64__) || defined(__aarch64__))
     // Process 4 bytes at a time
     while ((e-p) >= 4) {
       STEP4;
     }
-#endif  // defined(_M_X64) || defined(__x86_64__)
+#endif  // defined(_M_X64) || defined(__x86_64__) || defined(__aarch64__)
   }
   // Process the last few bytes
   while (p != e) {
@@ -103,7 +122,8 @@ uint32_t AcceleratedCRC32C(uint32_t crc, const char* buf, size_t size) {
 #undef STEP4
 #undef STEP1
   return l ^ 0xffffffffu;
-#endif  // defined(LEVELDB_PLATFORM_POSIX_SSE)
+#endif  // !defined(LEVELDB_PLATFORM_POSIX_SSE) &&
+        // !defined(LEVELDB_PLATFORM_POSIX_ARMV8_CRC)
 }
 
 }  // namespace port
@@ -97,4 +97,7 @@ Status ReadFileToString(Env* env, const std::string& fname, std::string* data) {
 EnvWrapper::~EnvWrapper() {
 }
 
+MmapReadEnv::~MmapReadEnv() {
+}
+
 }  // namespace leveldb
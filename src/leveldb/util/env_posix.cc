@@ -17,12 +17,16 @@
 #include <sys/types.h>
 #include <time.h>
 #include <unistd.h>
+#include <atomic>
 #include <deque>
 #include <limits>
 #include <set>
 #include "leveldb/env.h"
 #include "leveldb/slice.h"
 #include "port/port.h"
+#include "table/format.h"
+#include "util/coding.h"
+#include "util/crc32c.h"
 #include "util/logging.h"
 #include "util/mutexlock.h"
 #include "util/posix_logger.h"
@@ -214,6 +218,90 @@ class PosixMmapReadableFile: public RandomAccessFile {
   virtual std::string GetName() const { return filename_; }
 };
 
+// Counters shared by an MmapReadEnv and the files it opened.
+struct MmapReadCounters {
+  std::atomic<uint64_t> mapped_files;
+  std::atomic<uint64_t> mapped_bytes;
+  std::atomic<uint64_t> verified_blocks;
+  std::atomic<uint64_t> checksum_failures;
+
+  MmapReadCounters()
+      : mapped_files(0), mapped_bytes(0), verified_blocks(0),
+        checksum_failures(0) { }
+};
+
+// mmap() based random-access without a Limiter. For table files, the
+// checksum of every block is verified the first time the block is read.
+class PosixVerifyingMmapReadableFile: public RandomAccessFile {
+ private:
+  std::string filename_;
+  const char* mmapped_region_;
+  size_t length_;
+  bool is_table_;
+  MmapReadCounters* counters_;
+  mutable port::Mutex mu_;
+  mutable std::set<uint64_t> verified_offsets_;  // Guarded by mu_
+
+  static bool IsTableFile(const std::string& fname) {
+    const size_t dot = fname.rfind('.');
+    if (dot == std::string::npos) {
+      return false;
+    }
+    const std::string suffix = fname.substr(dot);
+    return suffix == ".ldb" || suffix == ".sst";
+  }
+
+ public:
+  // base[0,length-1] contains the mmapped contents of the file.
+  PosixVerifyingMmapReadableFile(const std::string& fname, void* base,
+                                 size_t length, MmapReadCounters* counters)
+      : filename_(fname), mmapped_region_(reinterpret_cast<char*>(base)),
+        length_(length), is_table_(IsTableFile(fname)), counters_(counters) {
+    counters_->mapped_files++;
+    counters_->mapped_bytes += length_;
+  }
+
+  virtual ~PosixVerifyingMmapReadableFile() {
+    munmap(const_cast<char*>(mmapped_region_), length_);
+    counters_->mapped_files--;
+    counters_->mapped_bytes -= length_;
+  }
+
+  virtual Status Read(uint64_t offset, size_t n, Slice* result,
+                      char* scratch) const {
+    if (offset + n > length_) {
+      *result = Slice();
+      return IOError(filename_, EINVAL);
+    }
+    const char* data = mmapped_region_ + offset;
+    // Tables are only read block by block, each block followed by its
+    // trailer, except for the footer at the very end of the file.
+    if (is_table_ && offset + n < length_ && n >= kBlockTrailerSize) {
+      bool verified;
+      {
+        MutexLock l(&mu_);
+        verified = verified_offsets_.count(offset) != 0;
+      }
+      if (!verified) {
+        const size_t block_size = n - kBlockTrailerSize;
+        const uint32_t crc = crc32c::Unmask(DecodeFixed32(data + block_size + 1));
+        if (crc32c::Value(data, block_size + 1) != crc) {
+          counters_->checksum_failures++;
+          *result = Slice();
+          return Status::Corruption("block checksum mismatch", filename_);
+        }
+        counters_->verified_blocks++;
+        MutexLock l(&mu_);
+        verified_offsets_.insert(offset);
+      }
+    }
+    *result = Slice(data, n);
+    return Status::OK();
+  }
+
+  virtual std::string GetName() const { return filename_; }
+};
+
 class PosixWritableFile : public WritableFile {
  private:
   std::string filename_;
@@ -682,6 +770,65 @@ void PosixEnv::StartThread(void (*function)(void* arg), void* arg) {
 
 }  // namespace
 
+namespace {
+
+class PosixMmapReadEnv : public MmapReadEnv {
+ public:
+  PosixMmapReadEnv(Env* base_env, bool random_access)
+      : MmapReadEnv(base_env), random_access_(random_access) { }
+
+  virtual Status NewRandomAccessFile(const std::string& fname,
+                                     RandomAccessFile** result) {
+    *result = NULL;
+    uint64_t size;
+    Status s = GetFileSize(fname, &size);
+    if (!s.ok() || size == 0) {
+      // Empty files cannot be mapped
+      return s.ok() ? target()->NewRandomAccessFile(fname, result) : s;
+    }
+    int fd = open(fname.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return IOError(fname, errno);
+    }
+    void* base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+      s = IOError(fname, errno);
+    } else {
+      if (random_access_) {
+        // Advisory only, failure is harmless
+        posix_madvise(base, size, POSIX_MADV_RANDOM);
+      }
+      *result = new PosixVerifyingMmapReadableFile(fname, base, size,
+                                                   &counters_);
+    }
+    close(fd);
+    return s;
+  }
+
+  virtual MmapReadStats GetStats() const {
+    MmapReadStats stats;
+    stats.mapped_files = counters_.mapped_files;
+    stats.mapped_bytes = counters_.mapped_bytes;
+    stats.verified_blocks = counters_.verified_blocks;
+    stats.checksum_failures = counters_.checksum_failures;
+    return stats;
+  }
+
+ private:
+  const bool random_access_;
+  MmapReadCounters counters_;
+};
+
+}  // namespace
+
+MmapReadEnv* NewMmapReadEnv(Env* base_env, bool random_access) {
+  // Mapping every table needs a large address space
+  if (sizeof(void*) < 8) {
+    return NULL;
+  }
+  return new PosixMmapReadEnv(base_env, random_access);
+}
+
 static pthread_once_t once = PTHREAD_ONCE_INIT;
 static Env* default_env;
 static void InitDefaultEnv() { default_env = new PosixEnv; }
@@ -897,6 +897,10 @@ Env* Env::Default() {
   return default_env;
 }
 
+MmapReadEnv* NewMmapReadEnv(Env* base_env, bool random_access) {
+  return NULL;
+}
+
 }  // namespace leveldb
 
 #endif // defined(LEVELDB_PLATFORM_WINDOWS)
@@ -0,0 +1,127 @@
+// Copyright (c) 2026 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <memorygovernor.h>
+
+#include <coins.h>
+#include <config.h>
+#include <logging.h>
+#include <scheduler.h>
+#include <txmempool.h>
+#include <util/system.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <algorithm>
+
+std::unique_ptr<MemoryGovernor> g_memory_governor;
+
+MemoryGovernor::MemoryGovernor(size_t budget, size_t levelDBCache,
+                               size_t maxMempoolSizeIn)
+    : shared(budget - std::min(budget, levelDBCache)),
+      minMempoolSize(std::min(maxMempoolSizeIn, shared / 16)),
+      maxMempoolSize(std::min(maxMempoolSizeIn, shared / 4 * 3)),
+      step(std::max<size_t>(shared / 16, 1)) {
+    // Start as if synced, so that a node restarting with a full mempool does
+    // not trim it before the first rebalance.
+    LOCK(cs);
+    info.budget = budget;
+    info.levelDBCache = budget - shared;
+    info.mempoolSize = maxMempoolSize;
+    info.coinsCacheSize = shared - maxMempoolSize;
+    info.initialBlockDownload = false;
+    info.adjustments = 0;
+    info.reason = "initial split";
+    info.time = GetTime();
+}
+
+MemoryGovernor::Info MemoryGovernor::Rebalance(const Sample &sample,
+                                               int64_t now) {
+    LOCK(cs);
+    // The counters start over when the UTXO cache is recreated.
+    const bool reset =
+        sample.cacheHits < lastHits || sample.cacheMisses < lastMisses;
+    const uint64_t hits = sample.cacheHits - (reset ? 0 : lastHits);
+    const uint64_t misses = sample.cacheMisses - (reset ? 0 : lastMisses);
+    lastHits = sample.cacheHits;
+    lastMisses = sample.cacheMisses;
+    info.hitRate.reset();
+    if (hits + misses >= MIN_LOOKUPS) {
+        info.hitRate = double(hits) / double(hits + misses);
+    }
+
+    size_t mempoolSize = info.mempoolSize;
+    std::string reason;
+    if (sample.initialBlockDownload) {
+        mempoolSize = minMempoolSize;
+        reason = "initial block download: mempool at its minimum";
+    } else if (info.initialBlockDownload) {
+        mempoolSize = maxMempoolSize;
+        reason = "synced: mempool back to its maximum";
+    } else if (info.hitRate && *info.hitRate < LOW_HIT_RATE &&
+               sample.mempoolUsage < mempoolSize / 2) {
+        mempoolSize = std::max(minMempoolSize, mempoolSize - std::min(mempoolSize, step));
+        reason = "low UTXO cache hit rate and under-used mempool: memory "
+                 "moved to the UTXO cache";
+    } else if ((!info.hitRate || *info.hitRate > HIGH_HIT_RATE) &&
+               sample.mempoolUsage >= mempoolSize / 10 * 9) {
+        mempoolSize = std::min(maxMempoolSize, mempoolSize + step);
+        reason = "nearly full mempool and high UTXO cache hit rate: memory "
+                 "moved to the mempool";
+    }
+    info.initialBlockDownload = sample.initialBlockDownload;
+
+    if (mempoolSize != info.mempoolSize) {
+        info.mempoolSize = mempoolSize;
+        info.coinsCacheSize = shared - mempoolSize;
+        ++info.adjustments;
+        info.reason = std::move(reason);
+        info.time = now;
+        LogPrint(BCLog::COINDB,
+                 "Memory governor: %.1fMiB for the UTXO cache, %.1fMiB for "
+                 "the mempool (%s)\n",
+                 info.coinsCacheSize * (1.0 / 1024 / 1024),
+                 info.mempoolSize * (1.0 / 1024 / 1024), info.reason);
+    }
+    return info;
+}
+
+MemoryGovernor::Info MemoryGovernor::GetInfo() const {
+    LOCK(cs);
+    return info;
+}
+
+void MemoryGovernor::Update(Config &config) {
+    Sample sample;
+    {
+        LOCK(cs_main);
+        if (!pcoinsTip) {
+            return;
+        }
+        sample.initialBlockDownload = ::IsInitialBlockDownload();
+        sample.cacheHits = pcoinsTip->GetCacheHits();
+        sample.cacheMisses = pcoinsTip->GetCacheMisses();
+    }
+    sample.mempoolUsage = g_mempool.DynamicMemoryUsage();
+    const Info newInfo = Rebalance(sample, GetTime());
+
+    LOCK(cs_main);
+    nCoinCacheUsage = newInfo.coinsCacheSize;
+    const bool shrunk = newInfo.mempoolSize < config.GetMaxMemPoolSize();
+    config.SetMaxMemPoolSize(newInfo.mempoolSize);
+    if (shrunk) {
+        g_mempool.LimitSize(newInfo.mempoolSize,
+                            gArgs.GetArg("-mempoolexpiry",
+                                         DEFAULT_MEMPOOL_EXPIRY) * 60 * 60);
+    }
+}
+
+void ScheduleMemoryGovernor(Config &config, CScheduler &scheduler) {
+    scheduler.scheduleEvery(
+        [&config] {
+            g_memory_governor->Update(config);
+            return true;
+        },
+        MEMORY_GOVERNOR_INTERVAL * 1000);
+}
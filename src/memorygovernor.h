@@ -0,0 +1,113 @@
+// Copyright (c) 2026 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <sync.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+class CScheduler;
+class Config;
+
+//! Default for -memorybudget, in MiB. 0 keeps the static split of -dbcache
+//! and -maxmempool.
+static constexpr int64_t DEFAULT_MEMORY_BUDGET = 0;
+//! How often the memory governor rebalances its budget, in seconds
+static constexpr int64_t MEMORY_GOVERNOR_INTERVAL = 10;
+
+/**
+ * Splits one memory budget between the in-memory UTXO cache and the mempool,
+ * and moves memory between them as the node runs.
+ *
+ * During initial block download the mempool is held at its minimum and the
+ * rest of the budget goes to the UTXO cache. Once synced, the mempool gets
+ * back up to its maximum, and memory then moves in steps towards the mempool
+ * while it is nearly full and the UTXO cache hit rate is high, or towards the
+ * UTXO cache while its hit rate is low and the mempool is under-used.
+ *
+ * The LevelDB caches are sized from the budget at startup, and stay fixed
+ * since LevelDB cannot resize them once a database is open.
+ */
+class MemoryGovernor {
+public:
+    //! What the governor observes of the node at each rebalance
+    struct Sample {
+        bool initialBlockDownload;
+        //! Cumulative number of lookups answered by, and missing from, the
+        //! UTXO cache
+        uint64_t cacheHits;
+        uint64_t cacheMisses;
+        size_t mempoolUsage;
+    };
+
+    //! The split of the budget, and the latest decision of the governor
+    struct Info {
+        //! Whole budget, and the part of it left to the LevelDB caches
+        size_t budget;
+        size_t levelDBCache;
+        size_t coinsCacheSize;
+        size_t mempoolSize;
+        bool initialBlockDownload;
+        //! UTXO cache hit rate since the previous rebalance, if there were
+        //! enough lookups to measure it
+        std::optional<double> hitRate;
+        //! Number of times the split changed
+        uint64_t adjustments;
+        std::string reason;
+        //! Time of the latest change of the split
+        int64_t time;
+    };
+
+    //! Minimum number of UTXO cache lookups for a hit rate to be measured
+    static constexpr uint64_t MIN_LOOKUPS = 1000;
+    //! Hit rates above which memory may move to the mempool, and below which
+    //! it may move to the UTXO cache
+    static constexpr double HIGH_HIT_RATE = 0.99;
+    static constexpr double LOW_HIT_RATE = 0.95;
+
+    /**
+     * budget is the whole budget, of which levelDBCache is left to the
+     * LevelDB caches. The mempool gets at most maxMempoolSize, and at most
+     * three quarters of what is left.
+     */
+    MemoryGovernor(size_t budget, size_t levelDBCache, size_t maxMempoolSize);
+
+    //! Update the split from a new sample, and return it
+    Info Rebalance(const Sample &sample, int64_t now);
+
+    Info GetInfo() const;
+
+    size_t GetMinMempoolSize() const { return minMempoolSize; }
+    size_t GetMaxMempoolSize() const { return maxMempoolSize; }
+
+    /**
+     * Sample the node, rebalance, and apply the split to the UTXO cache limit
+     * and to the mempool cap, trimming the mempool if its cap shrank.
+     */
+    void Update(Config &config);
+
+private:
+    //! Memory shared between the UTXO cache and the mempool
+    const size_t shared;
+    const size_t minMempoolSize;
+    const size_t maxMempoolSize;
+    //! Amount of memory moved at each rebalance once synced
+    const size_t step;
+
+    mutable Mutex cs;
+    Info info GUARDED_BY(cs);
+    uint64_t lastHits GUARDED_BY(cs){0};
+    uint64_t lastMisses GUARDED_BY(cs){0};
+};
+
+//! Set by init.cpp when -memorybudget is enabled
+extern std::unique_ptr<MemoryGovernor> g_memory_governor;
+
+//! Rebalance the budget of g_memory_governor every MEMORY_GOVERNOR_INTERVAL
+void ScheduleMemoryGovernor(Config &config, CScheduler &scheduler);
@@ -506,7 +506,7 @@ void CNode::SetAddrLocal(const CService &addrLocalIn) {
     }
 }
 
-void CNode::copyStats(CNodeStats &stats, const std::vector<bool> &m_asmap) {
+void CNode::copyStats(CNodeStats &stats, const ASMap &m_asmap) {
     stats.nodeid = this->GetId();
     stats.nServices = nServices;
     stats.addr = addr;
@@ -589,8 +589,8 @@ bool CNode::ReceiveMsgBytes(const Config &config, const char *pch,
     while (nBytes > 0) {
         // Get current incomplete message, or create a new one.
         if (vRecvMsg.empty() || vRecvMsg.back().complete()) {
-            vRecvMsg.push_back(CNetMessage(config.GetChainParams().NetMagic(),
-                                           SER_NETWORK, INIT_PROTO_VERSION));
+            vRecvMsg.emplace_back(config.GetChainParams().NetMagic(),
+                                  SER_NETWORK, INIT_PROTO_VERSION);
         }
 
         CNetMessage &msg = vRecvMsg.back();
@@ -700,10 +700,28 @@ int CNetMessage::readData(const char *pch, uint32_t nBytes) {
     unsigned int nRemaining = hdr.nMessageSize - nDataPos;
     unsigned int nCopy = std::min(nRemaining, nBytes);
 
+    if (nDataPos == 0 && hdr.nMessageSize >= MIN_POOLED_RECV_BUFFER &&
+        vRecv.capacity() < hdr.nMessageSize) {
+        // The header tells us how large the payload will be. An idle pooled
+        // buffer is already allocated, so sizing it for the whole message
+        // up front costs the peer nothing it could abuse.
+        CSerializeData buf;
+        if (GetRecvBufferPool().Acquire(hdr.nMessageSize, buf)) {
+            vRecv.swap_buffer(buf);
+        }
+    }
+
     if (vRecv.size() < nDataPos + nCopy) {
         // Allocate up to 256 KiB ahead, but never more than the total message
-        // size.
-        vRecv.resize(std::min(hdr.nMessageSize, nDataPos + nCopy + 256 * 1024));
+        // size. Without a pooled buffer, grow geometrically so a large block
+        // reallocates O(log n) times rather than once per 256 KiB.
+        const size_t target =
+            std::min<size_t>(hdr.nMessageSize, nDataPos + nCopy + 256 * 1024);
+        if (vRecv.capacity() < target) {
+            vRecv.reserve(std::min<size_t>(
+                hdr.nMessageSize, std::max(target, 2 * vRecv.capacity())));
+        }
+        vRecv.resize(target);
     }
 
     hasher.Write({UInt8Cast(pch), nCopy});
@@ -713,6 +731,66 @@ int CNetMessage::readData(const char *pch, uint32_t nBytes) {
     return nCopy;
 }
 
+CNetMessage::~CNetMessage() {
+    if (vRecv.capacity() < MIN_POOLED_RECV_BUFFER) {
+        return;
+    }
+    CSerializeData buf;
+    vRecv.swap_buffer(buf);
+    GetRecvBufferPool().Release(std::move(buf));
+}
+
+size_t RecvBufferPool::ClassOf(size_t capacity) {
+    size_t cls = 0;
+    while (cls + 1 < NUM_CLASSES &&
+           capacity >= (MIN_POOLED_RECV_BUFFER << (cls + 1))) {
+        ++cls;
+    }
+    return cls;
+}
+
+bool RecvBufferPool::Acquire(size_t min_capacity, CSerializeData &buf) {
+    LOCK(m_mutex);
+    for (size_t cls = ClassOf(min_capacity); cls < NUM_CLASSES; ++cls) {
+        auto &bucket = m_classes[cls];
+        for (auto it = bucket.begin(); it != bucket.end(); ++it) {
+            if (it->capacity() < min_capacity) {
+                continue;
+            }
+            m_idle_bytes -= it->capacity();
+            buf.swap(*it);
+            bucket.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void RecvBufferPool::Release(CSerializeData &&buf) {
+    const size_t capacity = buf.capacity();
+    if (capacity < MIN_POOLED_RECV_BUFFER) {
+        return;
+    }
+    buf.clear();
+    LOCK(m_mutex);
+    if (m_idle_bytes + capacity > m_max_bytes) {
+        // Dropped; freed (and wiped) by the caller's destructor.
+        return;
+    }
+    m_idle_bytes += capacity;
+    m_classes[ClassOf(capacity)].push_back(std::move(buf));
+}
+
+size_t RecvBufferPool::GetIdleBytes() const {
+    LOCK(m_mutex);
+    return m_idle_bytes;
+}
+
+RecvBufferPool &GetRecvBufferPool() {
+    static RecvBufferPool pool;
+    return pool;
+}
+
 const uint256 &CNetMessage::GetMessageHash() const {
     assert(complete());
     if (data_hash.IsNull()) {
@@ -721,13 +799,102 @@ const uint256 &CNetMessage::GetMessageHash() const {
     return data_hash;
 }
 
+SendClass GetSendClass(const std::string &msg_type) {
+    if (msg_type == NetMsgType::CMPCTBLOCK ||
+        msg_type == NetMsgType::BLOCKTXN || msg_type == NetMsgType::HEADERS ||
+        msg_type == NetMsgType::TX) {
+        return SendClass::RELAY;
+    }
+    if (msg_type == NetMsgType::BLOCK) {
+        return SendClass::BLOCK;
+    }
+    return SendClass::OTHER;
+}
+
+std::string GetSendClassName(SendClass sendClass) {
+    switch (sendClass) {
+        case SendClass::RELAY:
+            return "relay";
+        case SendClass::BLOCK:
+            return "block";
+        case SendClass::OTHER:
+        case SendClass::COUNT:
+            break;
+    }
+    return "other";
+}
+
+int SocketSendQueued(SOCKET hSocket,
+                     const std::deque<std::vector<uint8_t>> &queue,
+                     size_t offset) {
+    assert(!queue.empty() && queue.front().size() > offset);
+#ifdef WIN32
+    return send(hSocket,
+                reinterpret_cast<const char *>(queue.front().data()) + offset,
+                queue.front().size() - offset, MSG_NOSIGNAL | MSG_DONTWAIT);
+#else
+    std::array<iovec, MAX_SEND_IOVECS> iov;
+    size_t nIov = 0;
+    for (auto it = queue.begin(); it != queue.end() && nIov < iov.size();
+         ++it, offset = 0) {
+        iov[nIov].iov_base = const_cast<uint8_t *>(it->data()) + offset;
+        iov[nIov].iov_len = it->size() - offset;
+        ++nIov;
+    }
+
+    msghdr msg{};
+    msg.msg_iov = iov.data();
+    msg.msg_iovlen = nIov;
+
+    int flags = MSG_NOSIGNAL | MSG_DONTWAIT;
+#ifdef MSG_MORE
+    if (nIov < queue.size()) {
+        // The rest of the queue follows right away in the same send cycle.
+        flags |= MSG_MORE;
+    }
+#endif
+    return sendmsg(hSocket, &msg, flags);
+#endif
+}
+
+/**
+ * Whether a queued BLOCK message may be sent to this peer now, according to
+ * its share of -maxpeerblockuploadrate. Peers with PF_NOBAN are exempt.
+ */
+bool CConnman::CanSendBlockData(CNode *pnode) const
+    EXCLUSIVE_LOCKS_REQUIRED(pnode->cs_vSend) {
+    if (pnode->vSendMsgBlock.empty()) {
+        return false;
+    }
+    if (nMaxPeerBlockUploadRate == 0 || pnode->HasPermission(PF_NOBAN)) {
+        return true;
+    }
+    pnode->m_block_upload_bucket.Refill(nMaxPeerBlockUploadRate,
+                                        GetTimeMicros());
+    return pnode->m_block_upload_bucket.HasTokens();
+}
+
 size_t CConnman::SocketSendData(CNode *pnode) const
     EXCLUSIVE_LOCKS_REQUIRED(pnode->cs_vSend) {
     size_t nSentSize = 0;
-    size_t nMsgCount = 0;
 
-    for (const auto &data : pnode->vSendMsg) {
-        assert(data.size() > pnode->nSendOffset);
+    while (true) {
+        if (pnode->vSendMsg.empty()) {
+            // Everything else has been sent, so move on to the next queued
+            // full block, if its rate limit allows.
+            if (!CanSendBlockData(pnode)) {
+                break;
+            }
+            assert(pnode->vSendMsgBlock.size() >= 2);
+            for (int i = 0; i < 2; ++i) {
+                pnode->m_block_upload_bucket.Consume(
+                    pnode->vSendMsgBlock.front().size());
+                pnode->vSendMsg.push_back(
+                    std::move(pnode->vSendMsgBlock.front()));
+                pnode->vSendMsgBlock.pop_front();
+            }
+        }
+
         int nBytes = 0;
 
         {
@@ -736,11 +903,8 @@ size_t CConnman::SocketSendData(CNode *pnode) const
                 break;
             }
 
-            nBytes = send(pnode->hSocket,
-                          reinterpret_cast<const char *>(data.data()) +
-                              pnode->nSendOffset,
-                          data.size() - pnode->nSendOffset,
-                          MSG_NOSIGNAL | MSG_DONTWAIT);
+            nBytes = SocketSendQueued(pnode->hSocket, pnode->vSendMsg,
+                                      pnode->nSendOffset);
         }
 
         if (nBytes == 0) {
@@ -763,23 +927,30 @@ size_t CConnman::SocketSendData(CNode *pnode) const
         assert(nBytes > 0);
         pnode->nLastSend = GetSystemTimeInSeconds();
         pnode->nSendBytes += nBytes;
-        pnode->nSendOffset += nBytes;
         nSentSize += nBytes;
-        if (pnode->nSendOffset != data.size()) {
+
+        // Drop the entries that have been sent completely.
+        size_t nLeft = nBytes;
+        while (nLeft > 0) {
+            const size_t nEntrySize = pnode->vSendMsg.front().size();
+            if (pnode->nSendOffset + nLeft < nEntrySize) {
+                pnode->nSendOffset += nLeft;
+                break;
+            }
+            nLeft -= nEntrySize - pnode->nSendOffset;
+            pnode->nSendOffset = 0;
+            pnode->nSendSize -= nEntrySize;
+            pnode->vSendMsg.pop_front();
+        }
+        pnode->fPauseSend = pnode->nSendSize > nSendBufferMaxSize;
+
+        if (pnode->nSendOffset != 0) {
             // could not send full message; stop sending more
             break;
         }
-
-        pnode->nSendOffset = 0;
-        pnode->nSendSize -= data.size();
-        pnode->fPauseSend = pnode->nSendSize > nSendBufferMaxSize;
-        nMsgCount++;
     }
 
-    pnode->vSendMsg.erase(pnode->vSendMsg.begin(),
-                          pnode->vSendMsg.begin() + nMsgCount);
-
-    if (pnode->vSendMsg.empty()) {
+    if (pnode->vSendMsg.empty() && pnode->vSendMsgBlock.empty()) {
         assert(pnode->nSendOffset == 0);
         assert(pnode->nSendSize == 0);
     }
@@ -1232,7 +1403,8 @@ bool CConnman::GenerateSelectSet(std::set<SOCKET> &recv_set, std::set<SOCKET> &s
             bool select_send;
             {
                 LOCK(pnode->cs_vSend);
-                select_send = !pnode->vSendMsg.empty();
+                select_send = !pnode->vSendMsg.empty() ||
+                              CanSendBlockData(pnode);
             }
 
             LOCK(pnode->cs_hSocket);
@@ -2363,6 +2535,7 @@ bool CConnman::Start(CScheduler &scheduler, const Options &connOptions) {
     {
         LOCK(cs_totalBytesSent);
         nTotalBytesSent = 0;
+        nTotalBytesSentPerClass.fill(0);
         nMaxOutboundTotalBytesSentInCycle = 0;
         nMaxOutboundCycleStartTime = 0;
     }
@@ -2837,6 +3010,12 @@ uint64_t CConnman::GetTotalBytesRecv() {
     return nTotalBytesRecv;
 }
 
+std::array<uint64_t, size_t(SendClass::COUNT)>
+CConnman::GetTotalBytesSentPerClass() {
+    LOCK(cs_totalBytesSent);
+    return nTotalBytesSentPerClass;
+}
+
 uint64_t CConnman::GetTotalBytesSent() {
     LOCK(cs_totalBytesSent);
     return nTotalBytesSent;
@@ -2909,6 +3088,10 @@ void CConnman::PushMessage(CNode *pnode, CSerializedNetMsg &&msg) {
 
     CVectorWriter{SER_NETWORK, INIT_PROTO_VERSION, serializedHeader, 0, hdr};
 
+    const SendClass sendClass = GetSendClass(msg.m_type);
+    WITH_LOCK(cs_totalBytesSent,
+              nTotalBytesSentPerClass[size_t(sendClass)] += nTotalSize);
+
     size_t nBytesSent = 0;
     {
         LOCK(pnode->cs_vSend);
@@ -2921,9 +3104,16 @@ void CConnman::PushMessage(CNode *pnode, CSerializedNetMsg &&msg) {
         if (pnode->nSendSize > nSendBufferMaxSize) {
             pnode->fPauseSend = true;
         }
-        pnode->vSendMsg.push_back(std::move(serializedHeader));
-        if (nMessageSize) {
-            pnode->vSendMsg.push_back(std::move(msg.data));
+        if (sendClass == SendClass::BLOCK) {
+            // Full blocks queue up behind everything else, see
+            // SocketSendData(). Note that a BLOCK always has a payload.
+            pnode->vSendMsgBlock.push_back(std::move(serializedHeader));
+            pnode->vSendMsgBlock.push_back(std::move(msg.data));
+        } else {
+            pnode->vSendMsg.push_back(std::move(serializedHeader));
+            if (nMessageSize) {
+                pnode->vSendMsg.push_back(std::move(msg.data));
+            }
         }
 
         // If write queue empty, attempt "optimistic write"
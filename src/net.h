@@ -27,6 +27,8 @@
 #include <threadinterrupt.h>
 #include <uint256.h>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -91,6 +93,14 @@ static const unsigned int DEFAULT_MAX_PEER_CONNECTIONS = 125;
 static const uint64_t DEFAULT_MAX_UPLOAD_TARGET = 0;
 /** The default timeframe for -maxuploadtarget. 1 day. */
 static const uint64_t MAX_UPLOAD_TIMEFRAME = 60 * 60 * 24;
+/** The default for -maxpeerblockuploadrate, in kB/s. 0 = Unlimited */
+static const uint64_t DEFAULT_MAX_PEER_BLOCK_UPLOAD_RATE = 0;
+/** Maximum number of queued entries written to a socket in one send call */
+static const size_t MAX_SEND_IOVECS = 64;
+/** Smallest receive buffer worth recycling through the RecvBufferPool */
+static const size_t MIN_POOLED_RECV_BUFFER = 256 * 1024;
+/** Upper bound on the total capacity kept idle in the RecvBufferPool */
+static const size_t MAX_RECV_BUFFER_POOL_BYTES = 64 * 1024 * 1024;
 /** Default for blocks only*/
 static const bool DEFAULT_BLOCKSONLY = false;
 /** -peertimeout default */
@@ -122,6 +132,70 @@ struct CSerializedNetMsg {
     std::string m_type;
 };
 
+/**
+ * Classes of outgoing messages, used to prioritize uploads and for network
+ * usage accounting.
+ */
+enum class SendClass : uint8_t {
+    //! Latency critical relay: CMPCTBLOCK, BLOCKTXN, HEADERS and TX
+    RELAY = 0,
+    //! Full blocks, only sent once nothing else is queued for the peer
+    BLOCK,
+    //! Everything else
+    OTHER,
+    //! Number of classes
+    COUNT,
+};
+
+/**
+ * Write as much of the queued data to the socket as it will take in a single
+ * gathering send call, starting `offset` bytes into the first entry and
+ * covering up to MAX_SEND_IOVECS entries (just the first entry on Windows).
+ * Returns the result of the send call.
+ */
+int SocketSendQueued(SOCKET hSocket,
+                     const std::deque<std::vector<uint8_t>> &queue,
+                     size_t offset);
+
+SendClass GetSendClass(const std::string &msg_type);
+std::string GetSendClassName(SendClass sendClass);
+
+/**
+ * Simple token bucket rate limiter. Tokens accrue at a given rate per second,
+ * up to one second's worth. Consumers may take more tokens than available so
+ * that messages never need to be split up; the bucket then stays empty until
+ * that debt has been paid off.
+ */
+class TokenBucket {
+    int64_t m_tokens{0};
+    int64_t m_last_refill_micros{0};
+
+public:
+    //! Add the tokens accrued at `rate` per second since the last refill.
+    void Refill(uint64_t rate, int64_t now_micros) {
+        if (m_last_refill_micros == 0) {
+            m_tokens = rate;
+            m_last_refill_micros = now_micros;
+            return;
+        }
+        // Cap the elapsed time to avoid overflow; an hour is plenty to pay
+        // off any debt at sane rates.
+        const int64_t elapsed = std::min<int64_t>(
+            now_micros - m_last_refill_micros, 3600 * 1000000LL);
+        const int64_t accrued = int64_t(rate) * elapsed / 1000000;
+        if (accrued <= 0) {
+            // Keep the fractional tokens for the next refill.
+            return;
+        }
+        m_tokens = std::min<int64_t>(rate, m_tokens + accrued);
+        m_last_refill_micros = now_micros;
+    }
+
+    bool HasTokens() const { return m_tokens > 0; }
+
+    void Consume(uint64_t n) { m_tokens -= int64_t(n); }
+};
+
 class NetEventsInterface;
 class CConnman {
 public:
@@ -146,6 +220,7 @@ public:
         unsigned int nReceiveFloodSize = 0;
         uint64_t nMaxOutboundTimeframe = 0;
         uint64_t nMaxOutboundLimit = 0;
+        uint64_t nMaxPeerBlockUploadRate = 0;
         int64_t m_peer_connect_timeout = DEFAULT_PEER_CONNECT_TIMEOUT;
         std::vector<std::string> vSeedNodes;
         std::vector<NetWhitelistPermissions> vWhitelistedRange;
@@ -173,6 +248,7 @@ public:
         nSendBufferMaxSize = connOptions.nSendBufferMaxSize;
         nReceiveFloodSize = connOptions.nReceiveFloodSize;
         m_peer_connect_timeout = connOptions.m_peer_connect_timeout;
+        nMaxPeerBlockUploadRate = connOptions.nMaxPeerBlockUploadRate;
         {
             LOCK(cs_totalBytesSent);
             nMaxOutboundTimeframe = connOptions.nMaxOutboundTimeframe;
@@ -321,6 +397,8 @@ public:
 
     uint64_t GetTotalBytesRecv();
     uint64_t GetTotalBytesSent();
+    //! Bytes sent per SendClass, counted when the messages are queued
+    std::array<uint64_t, size_t(SendClass::COUNT)> GetTotalBytesSentPerClass();
 
     void SetBestHeight(int height);
     int GetBestHeight() const;
@@ -339,7 +417,7 @@ public:
      */
     int64_t PoissonNextSendInbound(int64_t now, int average_interval_ms);
 
-    void SetAsmap(std::vector<bool> asmap) { addrman.m_asmap = std::move(asmap); }
+    void SetAsmap(std::vector<bool> asmap) { addrman.m_asmap = ASMap(std::move(asmap)); }
 
 private:
     struct ListenSocket {
@@ -394,6 +472,8 @@ private:
     NodeId GetNewNodeId();
 
     size_t SocketSendData(CNode *pnode) const;
+    bool CanSendBlockData(CNode *pnode) const
+        EXCLUSIVE_LOCKS_REQUIRED(pnode->cs_vSend);
     void DumpAddresses();
 
     // Network stats
@@ -410,6 +490,8 @@ private:
     RecursiveMutex cs_totalBytesSent;
     uint64_t nTotalBytesRecv GUARDED_BY(cs_totalBytesRecv);
     uint64_t nTotalBytesSent GUARDED_BY(cs_totalBytesSent);
+    std::array<uint64_t, size_t(SendClass::COUNT)>
+        nTotalBytesSentPerClass GUARDED_BY(cs_totalBytesSent){};
 
     // outbound limit & stats
     uint64_t nMaxOutboundTotalBytesSentInCycle GUARDED_BY(cs_totalBytesSent);
@@ -420,6 +502,9 @@ private:
     // P2P timeout in seconds
     int64_t m_peer_connect_timeout;
 
+    // Per-peer upload rate limit for full blocks in bytes/s (0 = unlimited)
+    uint64_t nMaxPeerBlockUploadRate{0};
+
     // Whitelisted ranges. Any node connecting from these is automatically
     // whitelisted (as well as those connecting to whitelisted binds).
     std::vector<NetWhitelistPermissions> vWhitelistedRange;
@@ -637,6 +722,41 @@ struct CNodeStats {
     uint32_t m_mapped_as;
 };
 
+/**
+ * Process-wide pool of message receive buffers, bucketed by power-of-two
+ * capacity. Large messages (blocks in particular) reuse a previously
+ * allocated buffer instead of growing a fresh one from scratch.
+ */
+class RecvBufferPool {
+public:
+    explicit RecvBufferPool(size_t max_bytes = MAX_RECV_BUFFER_POOL_BYTES)
+        : m_max_bytes(max_bytes) {}
+
+    /**
+     * Hand out an idle buffer with capacity of at least min_capacity.
+     * Returns false (leaving buf untouched) if none is available.
+     */
+    bool Acquire(size_t min_capacity, CSerializeData &buf);
+    /** Take ownership of buf's storage if it is worth keeping. */
+    void Release(CSerializeData &&buf);
+
+    size_t GetIdleBytes() const;
+
+private:
+    /** Class i holds capacities in [MIN_POOLED_RECV_BUFFER << i, << i+1). */
+    static size_t ClassOf(size_t capacity);
+
+    static constexpr size_t NUM_CLASSES = 16;
+
+    mutable Mutex m_mutex;
+    const size_t m_max_bytes;
+    size_t m_idle_bytes GUARDED_BY(m_mutex){0};
+    std::array<std::vector<CSerializeData>, NUM_CLASSES>
+        m_classes GUARDED_BY(m_mutex);
+};
+
+RecvBufferPool &GetRecvBufferPool();
+
 class CNetMessage {
 private:
     mutable CHash256 hasher;
@@ -670,6 +790,11 @@ public:
         nTime = 0;
     }
 
+    CNetMessage(CNetMessage &&) = default;
+    CNetMessage &operator=(CNetMessage &&) = default;
+    /** Returns the payload buffer to the RecvBufferPool. */
+    ~CNetMessage();
+
     bool complete() const {
         if (!in_data) {
             return false;
@@ -697,12 +822,17 @@ public:
     // socket
     std::atomic<ServiceFlags> nServices{NODE_NONE};
     SOCKET hSocket GUARDED_BY(cs_hSocket);
-    // Total size of all vSendMsg entries.
+    // Total size of all vSendMsg and vSendMsgBlock entries.
     size_t nSendSize{0};
     // Offset inside the first vSendMsg already sent.
     size_t nSendOffset{0};
     uint64_t nSendBytes GUARDED_BY(cs_vSend){0};
     std::deque<std::vector<uint8_t>> vSendMsg GUARDED_BY(cs_vSend);
+    // Queued BLOCK messages, as pairs of header and payload entries. These
+    // are moved to vSendMsg one message at a time, once vSendMsg is empty.
+    std::deque<std::vector<uint8_t>> vSendMsgBlock GUARDED_BY(cs_vSend);
+    // Rate limiter for vSendMsgBlock, see -maxpeerblockuploadrate.
+    TokenBucket m_block_upload_bucket GUARDED_BY(cs_vSend);
     mutable RecursiveMutex cs_vSend;
     RecursiveMutex cs_hSocket;
     RecursiveMutex cs_vRecv;
@@ -949,7 +1079,7 @@ public:
 
     void CloseSocketDisconnect();
 
-    void copyStats(CNodeStats &stats, const std::vector<bool> &m_asmap);
+    void copyStats(CNodeStats &stats, const ASMap &m_asmap);
 
     ServiceFlags GetLocalServices() const { return nLocalServices; }
 
@@ -53,6 +53,8 @@ bool TryParsePermissionFlags(const std::string str, NetPermissionFlags &output,
                 NetPermissions::AddFlag(flags, PF_RELAY);
             } else if (permission == "addr") {
                 NetPermissions::AddFlag(flags, PF_ADDR);
+            } else if (permission == "earlyrelay") {
+                NetPermissions::AddFlag(flags, PF_EARLYRELAY);
             } else if (permission.length() == 0) {
                 // Allow empty entries
             } else {
@@ -89,6 +91,9 @@ std::vector<std::string> NetPermissions::ToStrings(NetPermissionFlags flags) {
     if (NetPermissions::HasFlag(flags, PF_ADDR)) {
         strings.push_back("addr");
     }
+    if (NetPermissions::HasFlag(flags, PF_EARLYRELAY)) {
+        strings.push_back("earlyrelay");
+    }
     return strings;
 }
 
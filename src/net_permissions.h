@@ -25,6 +25,9 @@ enum NetPermissionFlags {
     PF_MEMPOOL = (1U << 5),
     // Can request addrs without hitting a privacy-preserving cache
     PF_ADDR = (1U << 7),
+    // Gets new blocks pushed in full as soon as their header and merkle root
+    // check out, before script validation. Opt-in only: not implied by "all"
+    PF_EARLYRELAY = (1U << 8),
 
     // True if the user did not specifically set fine grained permissions
     PF_ISIMPLICIT = (1U << 31),
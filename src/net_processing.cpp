@@ -1268,9 +1268,17 @@ static std::shared_ptr<const CBlockHeaderAndShortTxIDs>
     most_recent_compact_block GUARDED_BY(cs_most_recent_block);
 static uint256 most_recent_block_hash GUARDED_BY(cs_most_recent_block);
 
+/**
+ * Hash of the last block pushed to PF_EARLYRELAY peers before it was fully
+ * validated. Should that block turn out invalid, its source is punished even
+ * if it would otherwise be exempt (e.g. because it came as a compact block).
+ */
+static uint256 most_recent_early_relay_hash GUARDED_BY(cs_main);
+
 /**
  * Maintain state about the best-seen block and fast-announce a compact block
- * to compatible peers.
+ * to compatible peers. Peers with the PF_EARLYRELAY permission which do not
+ * get a compact block get the full block instead.
  */
 void PeerLogicValidation::NewPoWValidBlock(
     const CBlockIndex *pindex, const std::shared_ptr<const CBlock> &pblock) {
@@ -1295,19 +1303,23 @@ void PeerLogicValidation::NewPoWValidBlock(
         most_recent_compact_block = pcmpctblock;
     }
 
-    connman->ForEachNode([this, &pcmpctblock, pindex, &msgMaker,
+    connman->ForEachNode([this, &pcmpctblock, &pblock, pindex, &msgMaker,
                           &hashBlock](CNode *pnode) {
         AssertLockHeld(cs_main);
 
         // TODO: Avoid the repeated-serialization here
-        if (pnode->nVersion < INVALID_CB_NO_BAN_VERSION || pnode->fDisconnect) {
+        const bool fEarlyRelay = pnode->HasPermission(PF_EARLYRELAY);
+        if ((pnode->nVersion < INVALID_CB_NO_BAN_VERSION && !fEarlyRelay) ||
+            pnode->fDisconnect) {
             return;
         }
         ProcessBlockAvailability(pnode->GetId());
         CNodeState &state = *State(pnode->GetId());
         // If the peer has, or we announced to them the previous block already,
         // but we don't think they have this one, go ahead and announce it.
-        if (state.fPreferHeaderAndIDs && !PeerHasHeader(&state, pindex) &&
+        if (state.fPreferHeaderAndIDs &&
+            pnode->nVersion >= INVALID_CB_NO_BAN_VERSION &&
+            !PeerHasHeader(&state, pindex) &&
             PeerHasHeader(&state, pindex->pprev)) {
             LogPrint(BCLog::NET, "%s sending header-and-ids %s to peer=%d\n",
                      "PeerLogicValidation::NewPoWValidBlock",
@@ -1315,6 +1327,17 @@ void PeerLogicValidation::NewPoWValidBlock(
             connman->PushMessage(
                 pnode, msgMaker.Make(NetMsgType::CMPCTBLOCK, *pcmpctblock));
             state.pindexBestHeaderSent = pindex;
+        } else if (fEarlyRelay && !PeerHasHeader(&state, pindex)) {
+            // The peer opted into getting new blocks before we have fully
+            // validated them, so push the block itself right away rather than
+            // waiting for ConnectTip() and the subsequent announcement.
+            LogPrint(BCLog::NET, "%s sending early block %s to peer=%d\n",
+                     "PeerLogicValidation::NewPoWValidBlock",
+                     hashBlock.ToString(), pnode->GetId());
+            connman->PushMessage(pnode,
+                                 msgMaker.Make(NetMsgType::BLOCK, *pblock));
+            state.pindexBestHeaderSent = pindex;
+            most_recent_early_relay_hash = hashBlock;
         }
     });
 }
@@ -1375,6 +1398,14 @@ void PeerLogicValidation::BlockChecked(const CBlock &block,
 
     int nDoS = 0;
     if (state.IsInvalid(nDoS)) {
+        // We already pushed this block to our early relay peers, which may
+        // not be as forgiving about it as we are.
+        const bool fEarlyRelayed = hash == most_recent_early_relay_hash;
+        if (fEarlyRelayed) {
+            LogPrintf("Block %s was relayed early but failed validation: %s\n",
+                      hash.ToString(), FormatStateMessage(state));
+            most_recent_early_relay_hash.SetNull();
+        }
         // Don't send reject message with code 0 or an internal reject code.
         if (it != mapBlockSource.end() && State(it->second.first) &&
             state.GetRejectCode() > 0 &&
@@ -1384,7 +1415,7 @@ void PeerLogicValidation::BlockChecked(const CBlock &block,
                 state.GetRejectReason().substr(0, MAX_REJECT_MESSAGE_LENGTH),
                 hash};
             State(it->second.first)->rejects.push_back(reject);
-            if (nDoS > 0 && it->second.second) {
+            if (nDoS > 0 && (it->second.second || fEarlyRelayed)) {
                 Misbehaving(it->second.first, nDoS, state.GetRejectReason());
             }
         }
@@ -3842,6 +3873,18 @@ static bool ProcessMessage(const Config &config, CNode *pfrom,
         const auto bannablePeerId = pfrom->HasPermission(PF_NOBAN) ? -1 : pfrom->GetId();
         try {
             vRecv >> dsp;
+            {
+                // Run the expensive signature checks without holding cs_main or
+                // pool.cs. The result is cached, so the authoritative validate()
+                // below only repeats the cheap mempool lookups.
+                DoubleSpendProof::SignatureCheck check;
+                const auto prepared = [&] {
+                    LOCK2(cs_main, g_mempool.cs);
+                    return dsp.prepareValidation(g_mempool, check);
+                }();
+                if (prepared == DoubleSpendProof::Valid)
+                    dsp.verifySignatures(check);
+            }
             // NOTE: We must hold cs_main and pool.cs here to get a "transactional"
             // and consistent view of the mempool while we perform the validation
             // operation & add operations.
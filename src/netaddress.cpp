@@ -652,35 +652,22 @@ uint8_t CNetAddr::GetNetClass() const {
     return m_net;
 }
 
-uint32_t CNetAddr::GetMappedAS(const std::vector<bool> &asmap) const {
+uint32_t CNetAddr::GetMappedAS(const ASMap &asmap) const {
     if (uint8_t net_class;
-            asmap.size() == 0 || ((net_class = GetNetClass()) != NET_IPV4 && net_class != NET_IPV6)) {
+            asmap.empty() || ((net_class = GetNetClass()) != NET_IPV4 && net_class != NET_IPV6)) {
         return 0; // Indicates not found, safe because AS0 is reserved per RFC7607.
     }
-    std::vector<bool> ip_bits(128);
+    std::array<uint8_t, ADDR_IPV6_SIZE> ip;
     if (HasLinkedIPv4()) {
         // For lookup, treat as if it was just an IPv4 address (IPV4_IN_IPV6_PREFIX + IPv4 bits)
-        for (int8_t byte_i = 0; byte_i < 12; ++byte_i) {
-            for (uint8_t bit_i = 0; bit_i < 8; ++bit_i) {
-                ip_bits[byte_i * 8 + bit_i] = (IPV4_IN_IPV6_PREFIX[byte_i] >> (7 - bit_i)) & 1;
-            }
-        }
-        uint32_t ipv4 = GetLinkedIPv4();
-        for (int i = 0; i < 32; ++i) {
-            ip_bits[96 + i] = (ipv4 >> (31 - i)) & 1;
-        }
+        std::copy(IPV4_IN_IPV6_PREFIX.begin(), IPV4_IN_IPV6_PREFIX.end(), ip.begin());
+        WriteBE32(ip.data() + IPV4_IN_IPV6_PREFIX.size(), GetLinkedIPv4());
     } else {
         // Use all 128 bits of the IPv6 address otherwise
         assert(IsIPv6());
-        for (int8_t byte_i = 0; byte_i < 16; ++byte_i) {
-            uint8_t cur_byte = m_addr[byte_i];
-            for (uint8_t bit_i = 0; bit_i < 8; ++bit_i) {
-                ip_bits[byte_i * 8 + bit_i] = (cur_byte >> (7 - bit_i)) & 1;
-            }
-        }
+        std::copy(m_addr.begin(), m_addr.end(), ip.begin());
     }
-    uint32_t mapped_as = Interpret(asmap, ip_bits);
-    return mapped_as;
+    return asmap.Lookup(ReadBE64(ip.data()), ReadBE64(ip.data() + 8));
 }
 
 /**
@@ -693,7 +680,7 @@ uint32_t CNetAddr::GetMappedAS(const std::vector<bool> &asmap) const {
  * @note No two connections will be attempted to addresses with the same network
  *       group.
  */
-std::vector<uint8_t> CNetAddr::GetGroup(const std::vector<bool> &asmap) const {
+std::vector<uint8_t> CNetAddr::GetGroup(const ASMap &asmap) const {
     std::vector<uint8_t> vchRet;
     // If non-empty asmap is supplied and the address is IPv4/IPv6,
     // return ASN to be used for bucketing.
@@ -117,6 +117,8 @@ inline constexpr size_t ADDR_CJDNS_SIZE = 16;
 /// Size of "internal" (NET_INTERNAL) address (in bytes).
 inline constexpr size_t ADDR_INTERNAL_SIZE = 10;
 
+class ASMap;
+
 /**
  * Network address.
  */
@@ -220,9 +222,9 @@ public:
     // The AS on the BGP path to the node we use to diversify
     // peers in AddrMan bucketing based on the AS infrastructure.
     // The ip->AS mapping depends on how asmap is constructed.
-    uint32_t GetMappedAS(const std::vector<bool> &asmap) const;
+    uint32_t GetMappedAS(const ASMap &asmap) const;
 
-    std::vector<uint8_t> GetGroup(const std::vector<bool> &asmap) const;
+    std::vector<uint8_t> GetGroup(const ASMap &asmap) const;
     // This will return the address as a serialized V1 vector (size: 16 bytes).
     std::vector<uint8_t> GetAddrBytes() const;
     int GetReachabilityFrom(const CNetAddr *paddrPartner = nullptr) const;
@@ -6,14 +6,116 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <iterator>
+#include <memory>
 #include <type_traits>
 
+/**
+ * Heap allocation counters, shared by all prevector instantiations (see
+ * getmemoryinfo). A spill is a prevector outgrowing its direct storage and
+ * moving to the heap. Spills are counted by size class of the heap buffer:
+ * class i counts buffers of at most (32 << i) bytes, and the last class all
+ * larger ones.
+ */
+namespace prevector_stats {
+static constexpr size_t NUM_SIZE_CLASSES = 8;
+
+inline std::atomic<uint64_t> spills[NUM_SIZE_CLASSES];
+//! Resizes of buffers that were already on the heap.
+inline std::atomic<uint64_t> reallocs{0};
+//! Spills served from prevector_pool instead of malloc.
+inline std::atomic<uint64_t> pool_hits{0};
+
+constexpr size_t SizeClass(size_t bytes) {
+    size_t size_class = 0;
+    while (size_class + 1 < NUM_SIZE_CLASSES &&
+           bytes > (size_t(32) << size_class)) {
+        ++size_class;
+    }
+    return size_class;
+}
+
+//! Largest buffer size counted in a size class, or 0 for the last one.
+constexpr size_t SizeClassLimit(size_t size_class) {
+    return size_class + 1 < NUM_SIZE_CLASSES ? size_t(32) << size_class : 0;
+}
+} // namespace prevector_stats
+
+/**
+ * Per-thread cache of freed prevector heap buffers of up to MAX_BYTES bytes.
+ * Prevectors that spill and are destroyed in quick succession, such as the
+ * scripts of transactions being deserialized, then mostly skip malloc and
+ * free. Buffers are binned by their size in GRANULE byte units, rounded down,
+ * and handed out as buffers of exactly that rounded size.
+ */
+namespace prevector_pool {
+static constexpr size_t GRANULE = 16;
+static constexpr size_t MAX_BYTES = 256;
+static constexpr size_t BIN_DEPTH = 64;
+
+struct ThreadCache {
+    struct Bin {
+        char *buffers[BIN_DEPTH];
+        size_t count = 0;
+    };
+    Bin bins[MAX_BYTES / GRANULE + 1];
+
+    ~ThreadCache();
+};
+
+//! Set once this thread's cache is destroyed, as buffers can still be freed
+//! by thread_local and static objects destroyed after it.
+inline thread_local bool destroyed = false;
+inline thread_local std::unique_ptr<ThreadCache> cache;
+
+inline ThreadCache::~ThreadCache() {
+    destroyed = true;
+    for (Bin &bin : bins) {
+        for (size_t i = 0; i < bin.count; ++i) {
+            free(bin.buffers[i]);
+        }
+    }
+}
+
+/**
+ * Allocate a buffer of at least bytes bytes; bytes is updated to the size of
+ * the buffer returned.
+ */
+inline char *Allocate(size_t &bytes) {
+    if (bytes <= MAX_BYTES && cache) {
+        const size_t bin_bytes = (bytes + GRANULE - 1) / GRANULE * GRANULE;
+        ThreadCache::Bin &bin = cache->bins[bin_bytes / GRANULE];
+        if (bin.count > 0) {
+            prevector_stats::pool_hits.fetch_add(1, std::memory_order_relaxed);
+            bytes = bin_bytes;
+            return bin.buffers[--bin.count];
+        }
+    }
+    return static_cast<char *>(malloc(bytes));
+}
+
+//! Free a buffer of (at least) bytes bytes.
+inline void Free(char *buffer, size_t bytes) {
+    if (bytes >= GRANULE && bytes <= MAX_BYTES && !destroyed) {
+        if (!cache) {
+            cache = std::make_unique<ThreadCache>();
+        }
+        ThreadCache::Bin &bin = cache->bins[bytes / GRANULE];
+        if (bin.count < BIN_DEPTH) {
+            bin.buffers[bin.count++] = buffer;
+            return;
+        }
+    }
+    free(buffer);
+}
+} // namespace prevector_pool
+
 /**
  * Implements a drop-in replacement for std::vector<T> which stores up to N
  * elements directly (without heap allocation). The types Size and Diff are used
@@ -276,7 +378,8 @@ private:
                 T *src = indirect;
                 T *dst = direct_ptr(0);
                 memcpy(dst, src, size() * sizeof(T));
-                free(indirect);
+                prevector_pool::Free(reinterpret_cast<char *>(indirect),
+                                     sizeof(T) * _union.capacity);
                 _size -= N + 1;
             }
         } else {
@@ -290,15 +393,19 @@ private:
                     _union.indirect, ((size_t)sizeof(T)) * new_capacity));
                 assert(_union.indirect);
                 _union.capacity = new_capacity;
+                prevector_stats::reallocs.fetch_add(1,
+                                                    std::memory_order_relaxed);
             } else {
-                char *new_indirect = static_cast<char *>(
-                    malloc(((size_t)sizeof(T)) * new_capacity));
+                size_t bytes = sizeof(T) * new_capacity;
+                prevector_stats::spills[prevector_stats::SizeClass(bytes)]
+                    .fetch_add(1, std::memory_order_relaxed);
+                char *new_indirect = prevector_pool::Allocate(bytes);
                 assert(new_indirect);
                 T *src = direct_ptr(0);
                 T *dst = reinterpret_cast<T *>(new_indirect);
                 memcpy(dst, src, size() * sizeof(T));
                 _union.indirect = new_indirect;
-                _union.capacity = new_capacity;
+                _union.capacity = bytes / sizeof(T);
                 _size += N + 1;
             }
         }
@@ -556,7 +663,7 @@ public:
             clear();
         }
         if (!is_direct()) {
-            free(_union.indirect);
+            prevector_pool::Free(_union.indirect, sizeof(T) * _union.capacity);
             _union.indirect = nullptr;
         }
     }
@@ -5,6 +5,11 @@
 
 #include <psbt.h>
 #include <util/strencodings.h>
+#include <util/system.h>
+
+#include <algorithm>
+#include <exception>
+#include <thread>
 
 PartiallySignedTransaction::PartiallySignedTransaction(const CTransaction &txIn)
     : tx(txIn) {
@@ -144,7 +149,8 @@ bool PSBTInputSigned(PSBTInput &input) {
 
 bool SignPSBTInput(const SigningProvider &provider,
                    PartiallySignedTransaction &psbt, int index, const uint32_t scriptFlags,
-                   SigHashType sighash, const ScriptExecutionContextOpt &optContext) {
+                   SigHashType sighash, const ScriptExecutionContextOpt &optContext,
+                   const PrecomputedTransactionData *txdata) {
     PSBTInput &input = psbt.inputs.at(index);
     const CMutableTransaction &tx = *psbt.tx;
 
@@ -177,10 +183,72 @@ bool SignPSBTInput(const SigningProvider &provider,
         tmp.emplace(unsigned(index), utxo, tx);
         pcontext = &*tmp;
     }
-    TransactionSignatureCreator creator(*pcontext, sighash);
+    TransactionSignatureCreator creator(*pcontext, sighash, txdata);
 
     bool sig_complete = ProduceSignature(provider, creator, utxo.scriptPubKey, sigdata, scriptFlags);
     input.FromSignatureData(sigdata);
 
     return sig_complete;
 }
+
+//! Below this many inputs per thread, starting worker threads costs more than
+//! signing the inputs on the calling thread.
+static constexpr size_t MIN_INPUTS_PER_SIGN_THREAD = 16;
+
+bool SignPSBTInputs(const SigningProvider &provider,
+                    PartiallySignedTransaction &psbt, uint32_t scriptFlags,
+                    SigHashType sighash, const std::vector<ScriptExecutionContext> &contexts) {
+    const CMutableTransaction &tx = *psbt.tx;
+    const size_t count = tx.vin.size();
+    assert(contexts.empty() || contexts.size() == count);
+    if (count == 0) {
+        return true;
+    }
+
+    // Signing only changes psbt.inputs, so the midstate of the unsigned
+    // transaction is valid for all inputs. A limited context does not give
+    // the hash of all utxos, in which case SignatureHash falls back to the
+    // context exactly as it does without a midstate.
+    const PrecomputedTransactionData txdata =
+        contexts.empty() ? PrecomputedTransactionData(ScriptExecutionContext(0, psbt.inputs[0].utxo, tx))
+                         : PrecomputedTransactionData(contexts[0]);
+
+    std::vector<char> complete(count);
+    auto sign = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            complete[i] = SignPSBTInput(provider, psbt, i, scriptFlags, sighash,
+                                        contexts.empty() ? ScriptExecutionContextOpt{} : contexts[i], &txdata);
+        }
+    };
+
+    const size_t nThreads = std::min<size_t>(std::max(GetNumCores(), 1), count / MIN_INPUTS_PER_SIGN_THREAD);
+    if (nThreads <= 1) {
+        sign(0, count);
+    } else {
+        // Exceptions are rethrown on the calling thread once all threads are done.
+        const size_t perThread = (count + nThreads - 1) / nThreads;
+        std::vector<std::exception_ptr> errors(nThreads);
+        auto signRange = [&](size_t thread) {
+            try {
+                sign(thread * perThread, std::min(count, (thread + 1) * perThread));
+            } catch (...) {
+                errors[thread] = std::current_exception();
+            }
+        };
+        std::vector<std::thread> threads;
+        for (size_t thread = 1; thread * perThread < count; ++thread) {
+            threads.emplace_back(signRange, thread);
+        }
+        signRange(0);
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+        for (const std::exception_ptr &error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    return std::all_of(complete.begin(), complete.end(), [](char c) { return c; });
+}
@@ -475,10 +475,24 @@ bool PSBTInputSigned(PSBTInput &input);
 
 /**
  * Signs a PSBTInput, verifying that all provided data matches what is being
- * signed.
+ * signed. If given, txdata must have been populated from a context of the
+ * same kind as the one used for signing, see TransactionSignatureCreator.
  */
 bool SignPSBTInput(const SigningProvider &provider,
                    PartiallySignedTransaction &psbt, int index,
                    uint32_t scriptFlags,
                    SigHashType sighash = SigHashType(),
-                   const ScriptExecutionContextOpt &context = {});
+                   const ScriptExecutionContextOpt &context = {},
+                   const PrecomputedTransactionData *txdata = nullptr);
+
+/**
+ * Signs all the inputs of a PSBT, as SignPSBTInput does, with one signature
+ * hash midstate shared by all inputs. Inputs of large transactions are signed
+ * on several threads, so provider must be safe to use concurrently. Each
+ * input is signed with its context in contexts if given, or with a limited
+ * context otherwise. Returns whether all inputs are signed.
+ */
+bool SignPSBTInputs(const SigningProvider &provider,
+                    PartiallySignedTransaction &psbt, uint32_t scriptFlags,
+                    SigHashType sighash = SigHashType(),
+                    const std::vector<ScriptExecutionContext> &contexts = {});
@@ -30,9 +30,6 @@
 
 #include <cstdint>
 
-static int64_t nLastHeaderTipUpdateNotification = 0;
-static int64_t nLastBlockTipUpdateNotification = 0;
-
 ClientModel::ClientModel(interfaces::Node &node, OptionsModel *_optionsModel,
                          QObject *parent)
     : QObject(parent), m_node(node), optionsModel(_optionsModel),
@@ -202,37 +199,34 @@ static void BannedListChanged(ClientModel *clientmodel) {
                               Qt::QueuedConnection);
 }
 
-static void BlockTipChanged(ClientModel *clientmodel, bool initialSync,
-                            int height, int64_t blockTime, BlockHash blockHash,
-                            double verificationProgress, bool fHeader) {
-    // lock free async UI updates in case we have a new block tip
-    // during initial sync, only update the UI if the last update
-    // was > 250ms (MODEL_UPDATE_DELAY) ago
-    int64_t now = 0;
-    if (initialSync) {
-        now = GetTimeMillis();
-    }
-
-    int64_t &nLastUpdateNotification = fHeader
-                                           ? nLastHeaderTipUpdateNotification
-                                           : nLastBlockTipUpdateNotification;
-
+void BlockTipChanged(ClientModel *clientmodel, bool initialSync, int height,
+                     int64_t blockTime, BlockHash blockHash,
+                     double verificationProgress, bool fHeader) {
     if (fHeader) {
         // cache best headers time and height to reduce future cs_main locks
         clientmodel->cachedBestHeaderHeight = height;
         clientmodel->cachedBestHeaderTime = blockTime;
     }
-    // if we are in-sync, update the UI regardless of last update time
-    if (!initialSync || now - nLastUpdateNotification > MODEL_UPDATE_DELAY) {
-        // pass an async signal to the UI thread
-        QMetaObject::invokeMethod(
-            clientmodel, "numBlocksChanged", Qt::QueuedConnection,
-            Q_ARG(int, height),
-            Q_ARG(QDateTime, GUIUtil::dateTimeFromTime(blockTime)),
-            Q_ARG(QString, QString::fromStdString(blockHash.ToString())),
-            Q_ARG(double, verificationProgress), Q_ARG(bool, fHeader));
-        nLastUpdateNotification = now;
+
+    // lock free async UI updates in case we have a new block tip: only keep
+    // the latest tip, and queue a delivery to the UI thread unless one is
+    // already pending
+    {
+        LOCK(clientmodel->m_tip_mutex);
+        (fHeader ? clientmodel->m_pending_header_tip
+                 : clientmodel->m_pending_block_tip) =
+            ClientModel::Tip{height, blockTime, blockHash,
+                             verificationProgress};
+        if (clientmodel->m_tip_delivery_scheduled) {
+            return;
+        }
+        clientmodel->m_tip_delivery_scheduled = true;
     }
+    // during initial sync, only update the UI every 250ms
+    // (MODEL_UPDATE_DELAY), with the latest tip at that time
+    QMetaObject::invokeMethod(clientmodel, "scheduleTipDelivery",
+                              Qt::QueuedConnection,
+                              Q_ARG(int, initialSync ? MODEL_UPDATE_DELAY : 0));
 }
 
 static void NotifyDspDetected(ClientModel *clientmodel, const TxId txId, const DspId dspId) {
@@ -240,6 +234,36 @@ static void NotifyDspDetected(ClientModel *clientmodel, const TxId txId, const D
                             Qt::QueuedConnection, Q_ARG(const TxId, txId), Q_ARG(const DspId, dspId));
 }
 
+void ClientModel::scheduleTipDelivery(int delay) {
+    if (delay > 0) {
+        QTimer::singleShot(delay, this, &ClientModel::deliverPendingTips);
+    } else {
+        deliverPendingTips();
+    }
+}
+
+void ClientModel::deliverPendingTips() {
+    std::optional<Tip> block_tip, header_tip;
+    {
+        LOCK(m_tip_mutex);
+        block_tip.swap(m_pending_block_tip);
+        header_tip.swap(m_pending_header_tip);
+        m_tip_delivery_scheduled = false;
+    }
+    auto emitTip = [this](const Tip &tip, bool header) {
+        Q_EMIT numBlocksChanged(
+            tip.height, GUIUtil::dateTimeFromTime(tip.blockTime),
+            QString::fromStdString(tip.blockHash.ToString()),
+            tip.verificationProgress, header);
+    };
+    if (block_tip) {
+        emitTip(*block_tip, false);
+    }
+    if (header_tip) {
+        emitTip(*header_tip, true);
+    }
+}
+
 void ClientModel::subscribeToCoreSignals() {
     // Connect signals to client
     m_handler_show_progress = m_node.handleShowProgress(std::bind(
@@ -7,13 +7,17 @@
 #pragma once
 
 #include <dsproof/dspid.h>
+#include <primitives/blockhash.h>
 #include <primitives/txid.h>
+#include <sync.h>
 
 #include <QDateTime>
 #include <QObject>
 
 #include <atomic>
+#include <cstdint>
 #include <memory>
+#include <optional>
 
 class BanTableModel;
 class OptionsModel;
@@ -94,9 +98,29 @@ private:
 
     QTimer *pollTimer;
 
+    //! A block or header tip notified by the core
+    struct Tip {
+        int height;
+        int64_t blockTime;
+        BlockHash blockHash;
+        double verificationProgress;
+    };
+    //! Latest block and header tips not yet delivered to the GUI. Later tips
+    //! replace earlier ones, so that the validation thread never waits for
+    //! the GUI and at most one delivery is queued at any time.
+    Mutex m_tip_mutex;
+    std::optional<Tip> m_pending_block_tip GUARDED_BY(m_tip_mutex);
+    std::optional<Tip> m_pending_header_tip GUARDED_BY(m_tip_mutex);
+    bool m_tip_delivery_scheduled GUARDED_BY(m_tip_mutex){false};
+
     void subscribeToCoreSignals();
     void unsubscribeFromCoreSignals();
 
+    friend void BlockTipChanged(ClientModel *clientmodel, bool initialSync,
+                                int height, int64_t blockTime,
+                                BlockHash blockHash,
+                                double verificationProgress, bool fHeader);
+
 Q_SIGNALS:
     void numConnectionsChanged(int count);
     void numBlocksChanged(int count, const QDateTime &blockDate, const QString &blockHash, double nVerificationProgress, bool header);
@@ -120,4 +144,8 @@ public Q_SLOTS:
     void updateNetworkActive(bool networkActive);
     void updateAlert();
     void updateBanlist();
+    /** Deliver the pending tips after delay milliseconds. */
+    void scheduleTipDelivery(int delay);
+    /** Emit numBlocksChanged for the pending tips. */
+    void deliverPendingTips();
 };
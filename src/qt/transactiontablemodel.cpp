@@ -23,6 +23,10 @@
 #include <validation.h>
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
 
 #include <QColor>
 #include <QDateTime>
@@ -54,12 +58,33 @@ struct TxLessThan {
     }
 };
 
+//! Number of wallet transactions loaded at a time
+static const size_t LOAD_PAGE_SIZE = 1000;
+//! Maximum number of queued transaction notifications applied one by one;
+//! any older ones are applied in one go without notifying the views
+static const size_t MAX_NOTIFIED_QUEUED_TRANSACTIONS = 10;
+
+// Transaction notification from the core, queued until applied to the model
+struct TransactionNotification {
+public:
+    TransactionNotification() {}
+    TransactionNotification(TxId _txid, ChangeType _status,
+                            bool _showTransaction)
+        : txid(_txid), status(_status), showTransaction(_showTransaction) {}
+
+    TxId txid;
+    ChangeType status;
+    bool showTransaction;
+};
+
 // Private implementation
 class TransactionTablePriv {
 public:
     explicit TransactionTablePriv(TransactionTableModel *_parent)
         : parent(_parent) {}
 
+    ~TransactionTablePriv() { stopLoading(); }
+
     TransactionTableModel *parent;
 
     /* Local cache of wallet.
@@ -68,27 +93,194 @@ public:
      */
     QList<TransactionRecord> cachedWallet;
 
+    /** Whether the background loader has not yet finished (GUI thread) */
+    bool loading = false;
+    std::thread loaderThread;
+    std::atomic<bool> loaderInterrupt{false};
+
+    Mutex cs_loaded;
+    /** Records loaded in the background, not yet added to cachedWallet */
+    QList<TransactionRecord> loadedRecords GUARDED_BY(cs_loaded);
+    bool loadedAll GUARDED_BY(cs_loaded) = false;
+
+    Mutex cs_queue;
+    /** Transaction notifications not yet applied to cachedWallet */
+    std::vector<TransactionNotification>
+        queuedNotifications GUARDED_BY(cs_queue);
+    /** Hold back queued notifications, e.g. during a rescan */
+    bool holdNotifications GUARDED_BY(cs_queue) = false;
+    /** Whether processQueuedTransactions() is already pending */
+    bool processingScheduled GUARDED_BY(cs_queue) = false;
+
+    static QList<TransactionRecord>
+    decomposeTransactions(const std::vector<interfaces::WalletTx> &wtxs) {
+        QList<TransactionRecord> records;
+        for (const auto &wtx : wtxs) {
+            if (TransactionRecord::showTransaction()) {
+                records.append(TransactionRecord::decomposeTransaction(wtx));
+            }
+        }
+        return records;
+    }
+
     /**
-     * Query entire wallet anew from core.
+     * Query entire wallet anew from core. The first page of transactions is
+     * decomposed right away, and any further ones on a background thread, so
+     * that opening a large wallet neither blocks the GUI nor holds the wallet
+     * lock for long.
      */
     void refreshWallet(interfaces::Wallet &wallet) {
         qDebug() << "TransactionTablePriv::refreshWallet";
-        cachedWallet.clear();
-        for (const auto &wtx : wallet.getWalletTxs()) {
-            if (TransactionRecord::showTransaction()) {
-                cachedWallet.append(
-                    TransactionRecord::decomposeTransaction(wtx));
+        TxId start;
+        std::vector<interfaces::WalletTx> wtxs;
+        const bool more = wallet.getWalletTxs(start, LOAD_PAGE_SIZE, wtxs);
+        cachedWallet = decomposeTransactions(wtxs);
+        if (!more) {
+            return;
+        }
+
+        loading = true;
+        loaderThread = std::thread(
+            &TraceThread<std::function<void()>>, "txtableload",
+            [this, &wallet, start]() mutable {
+                bool more = true;
+                while (more && !loaderInterrupt) {
+                    std::vector<interfaces::WalletTx> page;
+                    more = wallet.getWalletTxs(start, LOAD_PAGE_SIZE, page);
+                    QList<TransactionRecord> records =
+                        decomposeTransactions(page);
+                    {
+                        LOCK(cs_loaded);
+                        loadedRecords.append(records);
+                        loadedAll = !more;
+                    }
+                    QMetaObject::invokeMethod(parent, "addLoadedTransactions",
+                                              Qt::QueuedConnection);
+                }
+            });
+    }
+
+    /** Interrupt and wait for the background loader, if any. */
+    void stopLoading() {
+        loaderInterrupt = true;
+        if (loaderThread.joinable()) {
+            loaderThread.join();
+        }
+    }
+
+    /** Append the records loaded in the background to the model. */
+    void addLoadedTransactions(interfaces::Wallet &wallet) {
+        QList<TransactionRecord> records;
+        bool done;
+        {
+            LOCK(cs_loaded);
+            records.swap(loadedRecords);
+            done = loadedAll;
+        }
+        if (!records.isEmpty()) {
+            // Pages come in txid order after the ones already loaded, and
+            // notifications are held back until all are loaded, so appending
+            // keeps cachedWallet sorted. Do not show a notification for every
+            // page.
+            parent->setProcessingQueuedTransactions(true);
+            parent->beginInsertRows(QModelIndex(), cachedWallet.size(),
+                                    cachedWallet.size() + records.size() - 1);
+            cachedWallet.append(records);
+            parent->endInsertRows();
+            parent->setProcessingQueuedTransactions(false);
+        }
+        if (done && loading) {
+            loading = false;
+            stopLoading();
+            processQueuedTransactions(wallet);
+        }
+    }
+
+    /**
+     * Queue a transaction notification from the core, and schedule a single
+     * update of the model for all notifications queued in the meantime.
+     */
+    void notifyTransactionChanged(const TxId &txid, ChangeType status) {
+        // Determine whether to show transaction or not (determine this here so
+        // that no relocking is needed in GUI thread)
+        bool showTransaction = TransactionRecord::showTransaction();
+        {
+            LOCK(cs_queue);
+            queuedNotifications.emplace_back(txid, status, showTransaction);
+            if (holdNotifications || processingScheduled) {
+                return;
+            }
+            processingScheduled = true;
+        }
+        QMetaObject::invokeMethod(parent, "processQueuedTransactions",
+                                  Qt::QueuedConnection);
+    }
+
+    void showProgress(const std::string &title, int nProgress) {
+        {
+            LOCK(cs_queue);
+            if (nProgress == 0) {
+                holdNotifications = true;
             }
+            if (nProgress != 100) {
+                return;
+            }
+            holdNotifications = false;
+            if (queuedNotifications.empty() || processingScheduled) {
+                return;
+            }
+            processingScheduled = true;
+        }
+        QMetaObject::invokeMethod(parent, "processQueuedTransactions",
+                                  Qt::QueuedConnection);
+    }
+
+    /**
+     * Apply the queued transaction notifications. All but the last few are
+     * applied without per-row signals and followed by a single model reset,
+     * which prevents balloon spam and keeps the views from re-sorting for
+     * every transaction during a rescan or initial block download.
+     */
+    void processQueuedTransactions(interfaces::Wallet &wallet) {
+        std::vector<TransactionNotification> notifications;
+        {
+            LOCK(cs_queue);
+            processingScheduled = false;
+            if (loading || holdNotifications) {
+                return;
+            }
+            notifications.swap(queuedNotifications);
+        }
+
+        const size_t nBatched =
+            notifications.size() > MAX_NOTIFIED_QUEUED_TRANSACTIONS
+                ? notifications.size() - MAX_NOTIFIED_QUEUED_TRANSACTIONS
+                : 0;
+        if (nBatched > 0) {
+            parent->setProcessingQueuedTransactions(true);
+            parent->beginResetModel();
+            for (size_t i = 0; i < nBatched; ++i) {
+                const TransactionNotification &n = notifications[i];
+                updateWallet(wallet, n.txid, n.status, n.showTransaction,
+                             false);
+            }
+            parent->endResetModel();
+            parent->setProcessingQueuedTransactions(false);
+        }
+        for (size_t i = nBatched; i < notifications.size(); ++i) {
+            const TransactionNotification &n = notifications[i];
+            updateWallet(wallet, n.txid, n.status, n.showTransaction);
         }
     }
 
     /**
      * Update our model of the wallet incrementally, to synchronize our model of
      * the wallet with that of the core.
-     * Call with transaction that was added, removed or changed.
+     * Call with transaction that was added, removed or changed. Unless
+     * notifyViews is set, the caller is responsible for resetting the model.
      */
     void updateWallet(interfaces::Wallet &wallet, const TxId &txid, int status,
-                      bool showTransaction) {
+                      bool showTransaction, bool notifyViews = true) {
         qDebug() << "TransactionTablePriv::updateWallet: " +
                         QString::fromStdString(txid.ToString()) + " " +
                         QString::number(status);
@@ -141,15 +333,19 @@ public:
                         TransactionRecord::decomposeTransaction(wtx);
                     /* only if something to insert */
                     if (!toInsert.isEmpty()) {
-                        parent->beginInsertRows(QModelIndex(), lowerIndex,
-                                                lowerIndex + toInsert.size() -
-                                                    1);
+                        if (notifyViews) {
+                            parent->beginInsertRows(QModelIndex(), lowerIndex,
+                                                    lowerIndex +
+                                                        toInsert.size() - 1);
+                        }
                         int insert_idx = lowerIndex;
                         for (const TransactionRecord &rec : toInsert) {
                             cachedWallet.insert(insert_idx, rec);
                             insert_idx += 1;
                         }
-                        parent->endInsertRows();
+                        if (notifyViews) {
+                            parent->endInsertRows();
+                        }
                     }
                 }
                 break;
@@ -161,10 +357,14 @@ public:
                     break;
                 }
                 // Removed -- remove entire transaction from table
-                parent->beginRemoveRows(QModelIndex(), lowerIndex,
-                                        upperIndex - 1);
+                if (notifyViews) {
+                    parent->beginRemoveRows(QModelIndex(), lowerIndex,
+                                            upperIndex - 1);
+                }
                 cachedWallet.erase(lower, upper);
-                parent->endRemoveRows();
+                if (notifyViews) {
+                    parent->endRemoveRows();
+                }
                 break;
             case CT_UPDATED:
                 // Miscellaneous updates
@@ -173,9 +373,11 @@ public:
                 QList<TransactionRecord> toUpdate =
                     TransactionRecord::decomposeTransaction(wtx);
                 cachedWallet.replace(lowerIndex, toUpdate.first());
-                const auto index1 = parent->createIndex(lowerIndex, 0, index(wallet, lowerIndex));
-                const auto index2 = parent->createIndex(lowerIndex, parent->columns.size() - 1, index(wallet, lowerIndex));
-                Q_EMIT parent->dataChanged(index1, index2);
+                if (notifyViews) {
+                    const auto index1 = parent->createIndex(lowerIndex, 0, index(wallet, lowerIndex));
+                    const auto index2 = parent->createIndex(lowerIndex, parent->columns.size() - 1, index(wallet, lowerIndex));
+                    Q_EMIT parent->dataChanged(index1, index2);
+                }
 
                 break;
         }
@@ -255,9 +457,28 @@ void TransactionTableModel::updateTransaction(const QString &hash, int status,
     TxId updated;
     updated.SetHex(hash.toStdString());
 
+    if (priv->loading) {
+        // Applied once all records are loaded, to keep them sorted
+        LOCK(priv->cs_queue);
+        priv->queuedNotifications.emplace_back(
+            updated, static_cast<ChangeType>(status), showTransaction);
+        return;
+    }
     priv->updateWallet(walletModel->wallet(), updated, status, showTransaction);
 }
 
+void TransactionTableModel::processQueuedTransactions() {
+    priv->processQueuedTransactions(walletModel->wallet());
+}
+
+void TransactionTableModel::addLoadedTransactions() {
+    priv->addLoadedTransactions(walletModel->wallet());
+}
+
+void TransactionTableModel::stopLoading() {
+    priv->stopLoading();
+}
+
 void TransactionTableModel::updateConfirmations() {
     // Blocks came in since last poll.
     // Invalidate status (number of confirmations) and (possibly) description
@@ -700,87 +921,15 @@ void TransactionTableModel::updateDisplayUnit() {
     Q_EMIT dataChanged(index(0, Amount), index(priv->size() - 1, Amount));
 }
 
-// queue notifications to show a non freezing progress dialog e.g. for rescan
-struct TransactionNotification {
-public:
-    TransactionNotification() {}
-    TransactionNotification(TxId _txid, ChangeType _status,
-                            bool _showTransaction)
-        : txid(_txid), status(_status), showTransaction(_showTransaction) {}
-
-    void invoke(QObject *ttm) {
-        QString strHash = QString::fromStdString(txid.GetHex());
-        qDebug() << "NotifyTransactionChanged: " + strHash +
-                        " status= " + QString::number(status);
-        QMetaObject::invokeMethod(ttm, "updateTransaction",
-                                  Qt::QueuedConnection, Q_ARG(QString, strHash),
-                                  Q_ARG(int, status),
-                                  Q_ARG(bool, showTransaction));
-    }
-
-private:
-    TxId txid;
-    ChangeType status;
-    bool showTransaction;
-};
-
-static bool fQueueNotifications = false;
-static std::vector<TransactionNotification> vQueueNotifications;
-
-static void NotifyTransactionChanged(TransactionTableModel *ttm,
-                                     const TxId &txid, ChangeType status) {
-    // Find transaction in wallet
-    // Determine whether to show transaction or not (determine this here so that
-    // no relocking is needed in GUI thread)
-    bool showTransaction = TransactionRecord::showTransaction();
-
-    TransactionNotification notification(txid, status, showTransaction);
-
-    if (fQueueNotifications) {
-        vQueueNotifications.push_back(notification);
-        return;
-    }
-    notification.invoke(ttm);
-}
-
-static void ShowProgress(TransactionTableModel *ttm, const std::string &title,
-                         int nProgress) {
-    if (nProgress == 0) {
-        fQueueNotifications = true;
-    }
-
-    if (nProgress == 100) {
-        fQueueNotifications = false;
-        if (vQueueNotifications.size() > 10) {
-            // prevent balloon spam, show maximum 10 balloons
-            QMetaObject::invokeMethod(ttm, "setProcessingQueuedTransactions",
-                                      Qt::QueuedConnection, Q_ARG(bool, true));
-        }
-
-        for (size_t i = 0; i < vQueueNotifications.size(); ++i) {
-            if (vQueueNotifications.size() - i <= 10) {
-                QMetaObject::invokeMethod(
-                    ttm, "setProcessingQueuedTransactions",
-                    Qt::QueuedConnection, Q_ARG(bool, false));
-            }
-
-            vQueueNotifications[i].invoke(ttm);
-        }
-
-        // clear
-        std::vector<TransactionNotification>().swap(vQueueNotifications);
-    }
-}
-
 void TransactionTableModel::subscribeToCoreSignals() {
     // Connect signals to wallet
     m_handler_transaction_changed =
         walletModel->wallet().handleTransactionChanged(
-            std::bind(NotifyTransactionChanged, this, std::placeholders::_1,
-                      std::placeholders::_2));
-    m_handler_show_progress =
-        walletModel->wallet().handleShowProgress(std::bind(
-            ShowProgress, this, std::placeholders::_1, std::placeholders::_2));
+            std::bind(&TransactionTablePriv::notifyTransactionChanged, priv,
+                      std::placeholders::_1, std::placeholders::_2));
+    m_handler_show_progress = walletModel->wallet().handleShowProgress(
+        std::bind(&TransactionTablePriv::showProgress, priv,
+                  std::placeholders::_1, std::placeholders::_2));
 }
 
 void TransactionTableModel::unsubscribeFromCoreSignals() {
@@ -90,6 +90,11 @@ public:
     bool processingQueuedTransactions() const {
         return fProcessingQueuedTransactions;
     }
+    /**
+     * Stop loading transactions in the background. Must be called before the
+     * wallet interface is destroyed.
+     */
+    void stopLoading();
 
 private:
     WalletModel *walletModel;
@@ -138,6 +143,14 @@ public Q_SLOTS:
     void setProcessingQueuedTransactions(bool value) {
         fProcessingQueuedTransactions = value;
     }
+    /**
+     * Apply the transaction notifications queued since the last call.
+     */
+    void processQueuedTransactions();
+    /**
+     * Add the transactions loaded in the background since the last call.
+     */
+    void addLoadedTransactions();
 
     friend class TransactionTablePriv;
 };
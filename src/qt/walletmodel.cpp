@@ -53,6 +53,8 @@ WalletModel::WalletModel(std::unique_ptr<interfaces::Wallet> wallet,
 
 WalletModel::~WalletModel() {
     unsubscribeFromCoreSignals();
+    // The transaction table is destroyed after m_wallet, as a child object
+    transactionTableModel->stopLoading();
 }
 
 void WalletModel::updateStatus() {
@@ -394,8 +396,9 @@ static void NotifyTransactionChanged(WalletModel *walletmodel, const TxId &hash,
                                      ChangeType status) {
     Q_UNUSED(hash);
     Q_UNUSED(status);
-    QMetaObject::invokeMethod(walletmodel, "updateTransaction",
-                              Qt::QueuedConnection);
+    // Only sets a flag for the next balance poll, so there is no need to
+    // queue a call to the GUI thread for every transaction
+    walletmodel->updateTransaction();
 }
 
 static void ShowProgress(WalletModel *walletmodel, const std::string &title,
@@ -20,6 +20,7 @@
 
 #include <QObject>
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <vector>
@@ -245,7 +246,8 @@ private:
     interfaces::Node &m_node;
 
     bool fHaveWatchOnly;
-    bool fForceCheckBalanceChanged{false};
+    //! Set from the core threads by updateTransaction()
+    std::atomic<bool> fForceCheckBalanceChanged{false};
 
     // Wallet has an options model for wallet-specific options (transaction fee,
     // for example)
@@ -301,7 +303,7 @@ Q_SIGNALS:
 public Q_SLOTS:
     /** Wallet status might have changed. */
     void updateStatus();
-    /** New transaction, or transaction changed status. */
+    /** New transaction, or transaction changed status. Thread safe. */
     void updateTransaction();
     /** New, updated or removed address book entry. */
     void updateAddressBook(const QString &address, const QString &label,
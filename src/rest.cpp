@@ -10,6 +10,7 @@
 #include <config.h>
 #include <core_io.h>
 #include <httpserver.h>
+#include <index/blockstatsindex.h>
 #include <index/txindex.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
@@ -27,6 +28,8 @@
 
 // Allow a max of 15 outpoints to be queried at once.
 static const size_t MAX_GETUTXOS_OUTPOINTS = 15;
+// Allow a max of 2000 blocks' stats to be queried at once.
+static const long MAX_REST_BLOCKSTATS_RESULTS = 2000;
 
 enum class RetFormat {
     UNDEF,
@@ -204,6 +207,81 @@ static bool rest_headers(const std::any& context, Config &config, HTTPRequest *r
     }
 }
 
+static bool rest_blockstats(const std::any& context, Config &config, HTTPRequest *req,
+                            const std::string &strURIPart) {
+    if (!CheckWarmup(req)) {
+        return false;
+    }
+
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+    std::vector<std::string> path;
+    Split(path, param, "/");
+
+    if (path.size() != 2) {
+        return RESTERR(req, HTTP_BAD_REQUEST,
+                       "No block count specified. Use "
+                       "/rest/blockstats/<count>/<hash>.json.");
+    }
+
+    if (!g_blockstatsindex) {
+        return RESTERR(req, HTTP_BAD_REQUEST,
+                       "Block stats index is not enabled (use -blockstatsindex)");
+    }
+
+    long count = strtol(path[0].c_str(), nullptr, 10);
+    if (count < 1 || count > MAX_REST_BLOCKSTATS_RESULTS) {
+        return RESTERR(req, HTTP_BAD_REQUEST,
+                       "Block count out of range: " + path[0]);
+    }
+
+    std::string hashStr = path[1];
+    uint256 rawHash;
+    if (!ParseHashStr(hashStr, rawHash)) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
+    }
+
+    const BlockHash hash(rawHash);
+
+    std::vector<const CBlockIndex *> blocks;
+    blocks.reserve(count);
+    {
+        LOCK(cs_main);
+        const CBlockIndex *pindex = LookupBlockIndex(hash);
+        while (pindex != nullptr && ::ChainActive().Contains(pindex)) {
+            blocks.push_back(pindex);
+            if (blocks.size() == size_t(count)) {
+                break;
+            }
+            pindex = ::ChainActive().Next(pindex);
+        }
+    }
+
+    std::vector<BlockStats> stats;
+    if (!g_blockstatsindex->LookupStatsRange(blocks, stats)) {
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE,
+                       "Block stats index has not indexed these blocks yet");
+    }
+
+    switch (rf) {
+        case RetFormat::JSON: {
+            UniValue::Array jsonStats;
+            jsonStats.reserve(blocks.size());
+            for (size_t i = 0; i < blocks.size(); ++i) {
+                jsonStats.emplace_back(blockStatsToJSON(blocks[i], stats[i]));
+            }
+            std::string strJSON = UniValue::stringify(jsonStats) + "\n";
+            req->WriteHeader("Content-Type", "application/json");
+            req->WriteReply(HTTP_OK, strJSON);
+            return true;
+        }
+        default: {
+            return RESTERR(req, HTTP_NOT_FOUND,
+                           "output format not found (available: json)");
+        }
+    }
+}
+
 static bool rest_block(const Config &config, HTTPRequest *req,
                        const std::string &strURIPart, TxVerbosity tx_verbosity) {
     if (!CheckWarmup(req)) {
@@ -670,6 +748,7 @@ static const struct {
     {"/rest/mempool/info", rest_mempool_info},
     {"/rest/mempool/contents", rest_mempool_contents},
     {"/rest/headers/", rest_headers},
+    {"/rest/blockstats/", rest_blockstats},
     {"/rest/getutxos", rest_getutxos},
 };
 
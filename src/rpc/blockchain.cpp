@@ -15,6 +15,7 @@
 #include <consensus/validation.h>
 #include <core_io.h>
 #include <hash.h>
+#include <index/blockstatsindex.h>
 #include <index/txindex.h>
 #include <key_io.h>
 #include <policy/policy.h>
@@ -28,6 +29,7 @@
 #include <txdb.h>
 #include <txmempool.h>
 #include <undo.h>
+#include <util/saltedhashers.h>
 #include <util/strencodings.h>
 #include <util/system.h>
 #include <validation.h>
@@ -41,6 +43,7 @@
 #include <mutex>
 #include <optional>
 #include <string_view>
+#include <unordered_set>
 
 struct CUpdatedBlock {
     uint256 hash;
@@ -88,17 +91,18 @@ UniValue::Object blockheaderToJSON(const CBlockIndex *tip, const CBlockIndex *bl
     int confirmations = ComputeNextBlockAndDepth(tip, blockindex, pnext);
     bool previousblockhash = blockindex->pprev;
     bool nextblockhash = pnext;
+    const CBlockIndexHeaderFields header = blockindex->GetHeaderFields();
     UniValue::Object result;
     result.reserve(13 + previousblockhash + nextblockhash);
     result.emplace_back("hash", blockindex->GetBlockHash().GetHex());
     result.emplace_back("confirmations", confirmations);
     result.emplace_back("height", blockindex->nHeight);
-    result.emplace_back("version", blockindex->nVersion);
-    result.emplace_back("versionHex", strprintf("%08x", blockindex->nVersion));
-    result.emplace_back("merkleroot", blockindex->hashMerkleRoot.GetHex());
+    result.emplace_back("version", header.nVersion);
+    result.emplace_back("versionHex", strprintf("%08x", header.nVersion));
+    result.emplace_back("merkleroot", header.hashMerkleRoot.GetHex());
     result.emplace_back("time", blockindex->nTime);
     result.emplace_back("mediantime", blockindex->GetMedianTimePast());
-    result.emplace_back("nonce", blockindex->nNonce);
+    result.emplace_back("nonce", header.nNonce);
     result.emplace_back("bits", strprintf("%08x", blockindex->nBits));
     result.emplace_back("difficulty", GetDifficulty(blockindex));
     result.emplace_back("chainwork", blockindex->nChainWork.GetHex());
@@ -1600,6 +1604,72 @@ UniValue::Object MempoolInfoToJSON(const Config &config, const CTxMemPool &pool)
     return ret;
 }
 
+static UniValue::Object DBInfoToJSON(const CDBWrapper &db) {
+    UniValue::Object ret;
+    ret.reserve(3);
+    ret.emplace_back("usage", db.DynamicMemoryUsage());
+    ret.emplace_back("estimatedsize",
+                     db.EstimateSize(uint8_t(0x00), uint8_t(0xff)));
+    leveldb::MmapReadStats stats;
+    if (db.GetMmapStats(stats)) {
+        UniValue::Object mmap;
+        mmap.reserve(4);
+        mmap.emplace_back("mappedfiles", stats.mapped_files);
+        mmap.emplace_back("mappedbytes", stats.mapped_bytes);
+        mmap.emplace_back("verifiedblocks", stats.verified_blocks);
+        mmap.emplace_back("checksumfailures", stats.checksum_failures);
+        ret.emplace_back("mmap", std::move(mmap));
+    }
+    return ret;
+}
+
+static UniValue getdbinfo(const Config &config,
+                          const JSONRPCRequest &request) {
+    if (request.fHelp || request.params.size() != 0) {
+        throw std::runtime_error(
+            RPCHelpMan{"getdbinfo",
+                "\nReturns details on the LevelDB databases of the chainstate "
+                "and the block index.\n", {}}
+                .ToString() +
+            "\nResult:\n"
+            "{\n"
+            "  \"chainstate\": {               (object) The UTXO database\n"
+            "    \"usage\": xxxxx,              (numeric) Approximate memory "
+            "used by LevelDB itself, in bytes\n"
+            "    \"estimatedsize\": xxxxx,      (numeric) Approximate size on "
+            "disk, in bytes\n"
+            "    \"mmap\": {                    (object) Only present with "
+            "-dbmmap\n"
+            "      \"mappedfiles\": xxxxx,      (numeric) Table files "
+            "currently memory mapped\n"
+            "      \"mappedbytes\": xxxxx,      (numeric) Total size of those "
+            "mappings\n"
+            "      \"verifiedblocks\": xxxxx,   (numeric) Table blocks whose "
+            "checksum was verified on first read\n"
+            "      \"checksumfailures\": xxxxx  (numeric) Table blocks that "
+            "failed that verification\n"
+            "    }\n"
+            "  },\n"
+            "  \"blockindex\": {...}           (object) The block index "
+            "database, same fields as chainstate\n"
+            "}\n"
+            "\nExamples:\n" +
+            HelpExampleCli("getdbinfo", "") +
+            HelpExampleRpc("getdbinfo", ""));
+    }
+
+    LOCK(cs_main);
+    UniValue::Object ret;
+    ret.reserve(2);
+    if (pcoinsdbview) {
+        ret.emplace_back("chainstate", DBInfoToJSON(pcoinsdbview->GetDB()));
+    }
+    if (pblocktree) {
+        ret.emplace_back("blockindex", DBInfoToJSON(*pblocktree));
+    }
+    return ret;
+}
+
 static UniValue getmempoolinfo(const Config &config,
                                const JSONRPCRequest &request) {
     if (request.fHelp || request.params.size() != 0) {
@@ -1960,21 +2030,6 @@ static UniValue getchaintxstats(const Config &config,
     return ret;
 }
 
-template <typename T>
-static T CalculateTruncatedMedian(std::vector<T> &scores) {
-    size_t size = scores.size();
-    if (size == 0) {
-        return T();
-    }
-
-    std::sort(scores.begin(), scores.end());
-    if (size % 2 == 0) {
-        return (scores[size / 2 - 1] + scores[size / 2]) / 2;
-    } else {
-        return scores[size / 2];
-    }
-}
-
 void CalculatePercentilesBySize(Amount result[NUM_GETBLOCKSTATS_PERCENTILES], std::vector<std::pair<Amount, int64_t>>& scores, int64_t total_size)
 {
     if (scores.empty()) {
@@ -2013,10 +2068,6 @@ static inline bool SetHasKeys(const std::set<T> &set, const Tk &key,
     return (set.count(key) != 0) || SetHasKeys(set, args...);
 }
 
-// outpoint (needed for the utxo index) + nHeight + fCoinBase
-static constexpr size_t PER_UTXO_OVERHEAD =
-    sizeof(COutPoint) + sizeof(uint32_t) + sizeof(bool);
-
 /// Lock-free -- will throw if undo rev??.dat file not found or was pruned, etc.
 /// Guaranteed to return a valid undo or fail.
 static CBlockUndo ReadUndoChecked(const CBlockIndex *pblockindex) {
@@ -2054,6 +2105,52 @@ static CBlockUndo ReadUndoChecked(const CBlockIndex *pblockindex) {
     return undo;
 }
 
+UniValue::Object blockStatsToJSON(const CBlockIndex *pindex, const BlockStats &stats) {
+    UniValue::Array feerates_res;
+    feerates_res.reserve(NUM_GETBLOCKSTATS_PERCENTILES);
+    for (const Amount &feerate : stats.feerate_percentiles) {
+        feerates_res.push_back(ValueFromAmount(feerate));
+    }
+
+    const int64_t total_size = stats.total_size;
+    UniValue::Object ret;
+    ret.reserve(25); // not critical but be sure to update this reserve size if adding/removing entries below.
+    ret.emplace_back("avgfee",
+                   ValueFromAmount((stats.txs > 1)
+                                       ? stats.totalfee / int(stats.txs - 1)
+                                       : Amount::zero()));
+    ret.emplace_back("avgfeerate",
+                   ValueFromAmount((total_size > 0) ? stats.totalfee / total_size
+                                                    : Amount::zero()));
+    ret.emplace_back("avgtxsize", (stats.txs > 1)
+                                    ? stats.total_size / (stats.txs - 1)
+                                    : 0);
+    ret.emplace_back("blockhash", pindex->GetBlockHash().GetHex());
+    ret.emplace_back("feerate_percentiles", std::move(feerates_res));
+    ret.emplace_back("height", pindex->nHeight);
+    ret.emplace_back("ins", stats.ins);
+    ret.emplace_back("maxfee", ValueFromAmount(stats.maxfee));
+    ret.emplace_back("maxfeerate", ValueFromAmount(stats.maxfeerate));
+    ret.emplace_back("maxtxsize", stats.maxtxsize);
+    ret.emplace_back("medianfee", ValueFromAmount(stats.medianfee));
+    ret.emplace_back("mediantime", pindex->GetMedianTimePast());
+    ret.emplace_back("mediantxsize", stats.mediantxsize);
+    ret.emplace_back("minfee", ValueFromAmount(stats.minfee));
+    ret.emplace_back("minfeerate", ValueFromAmount(stats.minfeerate));
+    ret.emplace_back("mintxsize", stats.mintxsize);
+    ret.emplace_back("outs", stats.outs);
+    ret.emplace_back("subsidy", ValueFromAmount(GetBlockSubsidy(
+                                  pindex->nHeight, Params().GetConsensus())));
+    ret.emplace_back("time", pindex->GetBlockTime());
+    ret.emplace_back("total_out", ValueFromAmount(stats.total_out));
+    ret.emplace_back("total_size", stats.total_size);
+    ret.emplace_back("totalfee", ValueFromAmount(stats.totalfee));
+    ret.emplace_back("txs", stats.txs);
+    ret.emplace_back("utxo_increase", int64_t(stats.outs) - int64_t(stats.ins));
+    ret.emplace_back("utxo_size_inc", stats.utxo_size_inc);
+    return ret;
+}
+
 static UniValue getblockstats(const Config &config,
                               const JSONRPCRequest &request) {
     if (request.fHelp || request.params.size() < 1 ||
@@ -2062,7 +2159,8 @@ static UniValue getblockstats(const Config &config,
             RPCHelpMan{"getblockstats",
                 "\nCompute per block statistics for a given window. All amounts are in "
                 + CURRENCY_UNIT + ".\n"
-                "It won't work for some heights with pruning.\n",
+                "It won't work for some heights with pruning.\n"
+                "With -blockstatsindex, stats of indexed blocks are served without reading the block from disk.\n",
                 {
                     {"hash_or_height", RPCArg::Type::NUM, /* opt */ false, /* default_val */ "", "The block hash or height of the target block", "", {"", "string or numeric"}},
                     {"stats", RPCArg::Type::ARR, /* opt */ true, /* default_val */ "", "Values to plot, by default all values (see result below)",
@@ -2177,160 +2275,30 @@ static UniValue getblockstats(const Config &config,
         }
     }
 
-    const CBlock block = ReadBlockChecked(config, pindex);
-
     // Calculate everything if nothing selected (default)
     const bool do_all = stats.size() == 0;
-    const bool do_mediantxsize = do_all || stats.count("mediantxsize") != 0;
-    const bool do_medianfee = do_all || stats.count("medianfee") != 0;
-    const bool do_feerate_percentiles = do_all || stats.count("feerate_percentiles") != 0;
     const bool loop_inputs =
-        do_all || do_medianfee || do_feerate_percentiles ||
-        SetHasKeys(stats, "utxo_size_inc", "totalfee", "avgfee", "avgfeerate",
-                   "minfee", "maxfee", "minfeerate", "maxfeerate");
-    const bool loop_outputs = do_all || loop_inputs || stats.count("total_out");
-    const bool do_calculate_size =
-        do_mediantxsize || loop_inputs ||
-        SetHasKeys(stats, "total_size", "avgtxsize", "mintxsize", "maxtxsize");
-
-    const int64_t excessiveBlockSize = config.GetExcessiveBlockSize();
-    Amount maxfee = Amount::zero();
-    Amount maxfeerate = Amount::zero();
-    Amount minfee = MAX_MONEY;
-    Amount minfeerate = MAX_MONEY;
-    Amount total_out = Amount::zero();
-    Amount totalfee = Amount::zero();
-    int64_t inputs = 0;
-    int64_t maxtxsize = 0;
-    int64_t mintxsize = excessiveBlockSize;
-    int64_t outputs = 0;
-    int64_t total_size = 0;
-    int64_t utxo_size_inc = 0;
-    std::vector<Amount> fee_array;
-    std::vector<std::pair<Amount, int64_t>> feerate_array;
-    std::vector<int64_t> txsize_array;
-
-    // read the undo file so we can calculate fees -- but only if loop_inputs is true
-    // (since if it's false we won't need this data and we shouldn't spend time deserializing it)
-    const CBlockUndo &&blockUndo = loop_inputs ? ReadUndoChecked(pindex) : CBlockUndo{};
-
-    // Reserve for the above vectors only if we use them
-    if (do_mediantxsize) txsize_array.reserve(block.vtx.size());
-    if (do_medianfee) fee_array.reserve(block.vtx.size());
-    if (do_feerate_percentiles) feerate_array.reserve(block.vtx.size());
-
-    for (size_t i_tx = 0; i_tx < block.vtx.size(); ++i_tx) {
-        const auto &tx = block.vtx[i_tx];
-        outputs += tx->vout.size();
-        Amount tx_total_out = Amount::zero();
-        if (loop_outputs) {
-            for (const CTxOut &out : tx->vout) {
-                tx_total_out += out.nValue;
-                utxo_size_inc +=
-                    GetSerializeSize(out, PROTOCOL_VERSION) + PER_UTXO_OVERHEAD;
-            }
-        }
-
-        if (tx->IsCoinBase()) {
-            continue;
-        }
-
-        // Don't count coinbase's fake input
-        inputs += tx->vin.size();
-        // Don't count coinbase reward
-        total_out += tx_total_out;
-
-        int64_t tx_size = 0;
-        if (do_calculate_size) {
-            tx_size = tx->GetTotalSize();
-            if (do_mediantxsize) {
-                txsize_array.push_back(tx_size);
-            }
-            maxtxsize = std::max(maxtxsize, tx_size);
-            mintxsize = std::min(mintxsize, tx_size);
-            total_size += tx_size;
-        }
-
+        do_all || SetHasKeys(stats, "medianfee", "feerate_percentiles",
+                             "utxo_size_inc", "totalfee", "avgfee",
+                             "avgfeerate", "minfee", "maxfee", "minfeerate",
+                             "maxfeerate");
+
+    // Serve from the block stats index if it has this block, otherwise read
+    // the block -- and the undo file, but only if loop_inputs is true (since
+    // if it's false we won't need this data and we shouldn't spend time
+    // deserializing it).
+    BlockStats blockstats;
+    if (!g_blockstatsindex || !g_blockstatsindex->LookupStats(pindex, blockstats)) {
+        const CBlock block = ReadBlockChecked(config, pindex);
         if (loop_inputs) {
-            Amount tx_total_in = Amount::zero();
-            const auto &txundo = blockUndo.vtxundo.at(i_tx - 1); // checked access here, guard against programming errors
-            // We use the block undo info to find the inputs to this tx and use that information to calculate fees
-            for (const Coin &coin : txundo.vprevout) {
-                const CTxOut &prevoutput = coin.GetTxOut();
-
-                tx_total_in += prevoutput.nValue;
-                utxo_size_inc -=
-                    GetSerializeSize(prevoutput, PROTOCOL_VERSION) +
-                    PER_UTXO_OVERHEAD;
-            }
-
-            Amount txfee = tx_total_in - tx_total_out;
-            assert(MoneyRange(txfee));
-            if (do_medianfee) {
-                fee_array.push_back(txfee);
-            }
-            maxfee = std::max(maxfee, txfee);
-            minfee = std::min(minfee, txfee);
-            totalfee += txfee;
-
-            Amount feerate = tx_size ? txfee / tx_size : Amount::zero();
-            if (do_feerate_percentiles) {
-                feerate_array.emplace_back(feerate, tx_size);
-            }
-            maxfeerate = std::max(maxfeerate, feerate);
-            minfeerate = std::min(minfeerate, feerate);
+            const CBlockUndo blockUndo = ReadUndoChecked(pindex);
+            ComputeBlockStats(block, &blockUndo, blockstats);
+        } else {
+            ComputeBlockStats(block, nullptr, blockstats);
         }
     }
 
-    Amount feerate_percentiles[NUM_GETBLOCKSTATS_PERCENTILES] = { Amount::zero() };
-    CalculatePercentilesBySize(feerate_percentiles, feerate_array, total_size);
-
-    UniValue::Array feerates_res;
-    feerates_res.reserve(NUM_GETBLOCKSTATS_PERCENTILES);
-    for (int64_t i = 0; i < NUM_GETBLOCKSTATS_PERCENTILES; i++) {
-        feerates_res.push_back(ValueFromAmount(feerate_percentiles[i]));
-    }
-
-    UniValue::Object ret;
-    ret.reserve(25); // not critical but be sure to update this reserve size if adding/removing entries below.
-    ret.emplace_back("avgfee",
-                   ValueFromAmount((block.vtx.size() > 1)
-                                       ? totalfee / int((block.vtx.size() - 1))
-                                       : Amount::zero()));
-    ret.emplace_back("avgfeerate",
-                   ValueFromAmount((total_size > 0) ? totalfee / total_size
-                                                    : Amount::zero()));
-    ret.emplace_back("avgtxsize", (block.vtx.size() > 1)
-                                    ? total_size / (block.vtx.size() - 1)
-                                    : 0);
-    ret.emplace_back("blockhash", pindex->GetBlockHash().GetHex());
-    ret.emplace_back("feerate_percentiles", std::move(feerates_res));
-    ret.emplace_back("height", pindex->nHeight);
-    ret.emplace_back("ins", inputs);
-    ret.emplace_back("maxfee", ValueFromAmount(maxfee));
-    ret.emplace_back("maxfeerate", ValueFromAmount(maxfeerate));
-    ret.emplace_back("maxtxsize", maxtxsize);
-    ret.emplace_back("medianfee",
-                   ValueFromAmount(CalculateTruncatedMedian(fee_array)));
-    ret.emplace_back("mediantime", pindex->GetMedianTimePast());
-    ret.emplace_back("mediantxsize", CalculateTruncatedMedian(txsize_array));
-    ret.emplace_back(
-        "minfee",
-        ValueFromAmount((minfee == MAX_MONEY) ? Amount::zero() : minfee));
-    ret.emplace_back("minfeerate",
-                   ValueFromAmount((minfeerate == MAX_MONEY) ? Amount::zero()
-                                                             : minfeerate));
-    ret.emplace_back("mintxsize", mintxsize == excessiveBlockSize ? 0 : mintxsize);
-    ret.emplace_back("outs", outputs);
-    ret.emplace_back("subsidy", ValueFromAmount(GetBlockSubsidy(
-                                  pindex->nHeight, Params().GetConsensus())));
-    ret.emplace_back("time", pindex->GetBlockTime());
-    ret.emplace_back("total_out", ValueFromAmount(total_out));
-    ret.emplace_back("total_size", total_size);
-    ret.emplace_back("totalfee", ValueFromAmount(totalfee));
-    ret.emplace_back("txs", block.vtx.size());
-    ret.emplace_back("utxo_increase", outputs - inputs);
-    ret.emplace_back("utxo_size_inc", utxo_size_inc);
+    UniValue::Object ret = blockStatsToJSON(pindex, blockstats);
 
     if (!do_all) {
         // in this branch, we must return only the keys the client asked for
@@ -2375,11 +2343,14 @@ static UniValue savemempool(const Config &config,
     return UniValue();
 }
 
+//! Set of the pubkey scripts searched for by scantxoutset, looked up once per unspent output
+using ScriptSet = std::unordered_set<CScript, SaltedScriptHasher>;
+
 //! Search for a given set of pubkey scripts and tokens
 static bool FindScriptPubKeysAndTokens(std::atomic<int> &scan_progress,
                                        const std::atomic<bool> &should_abort,
                                        int64_t &count, CCoinsViewCursor *cursor,
-                                       const std::set<CScript> &needles,
+                                       const ScriptSet &needles,
                                        const std::set<token::Id> &tokenIds,
                                        std::map<COutPoint, Coin> &out_results,
                                        std::function<void()>& interruption_point) {
@@ -2565,7 +2536,7 @@ static UniValue scantxoutset(const Config &config,
                 RPC_INVALID_PARAMETER,
                 "Scan already in progress, use action \"abort\" or \"status\"");
         }
-        std::set<CScript> needles;
+        ScriptSet needles;
         std::set<token::Id> tokenIds;
         Amount total_in = Amount::zero();
 
@@ -2612,17 +2583,16 @@ static UniValue scantxoutset(const Config &config,
             if (!desc->IsRange()) {
                 range = 0;
             }
-            for (int i = 0; i <= range; ++i) {
-                std::vector<CScript> scripts;
-                if (!desc->Expand(i, provider, scripts, provider)) {
-                    throw JSONRPCError(
-                        RPC_INVALID_ADDRESS_OR_KEY,
-                        strprintf(
-                            "Cannot derive script without private keys: '%s'",
-                            desc_str));
-                }
-                needles.insert(scripts.begin(), scripts.end());
+            std::vector<CScript> scripts;
+            if (!ExpandRange(*desc, 0, range + 1, provider, scripts)) {
+                throw JSONRPCError(
+                    RPC_INVALID_ADDRESS_OR_KEY,
+                    strprintf(
+                        "Cannot derive script without private keys: '%s'",
+                        desc_str));
             }
+            needles.reserve(needles.size() + scripts.size());
+            needles.insert(std::make_move_iterator(scripts.begin()), std::make_move_iterator(scripts.end()));
         }
 
         // Scan the unspent transaction output set for inputs
@@ -2706,6 +2676,7 @@ static const ContextFreeRPCCommand commands[] = {
     { "blockchain",         "getblockstats",          getblockstats,          {"hash_or_height","stats"} },
     { "blockchain",         "getchaintips",           getchaintips,           {} },
     { "blockchain",         "getchaintxstats",        getchaintxstats,        {"nblocks", "blockhash"} },
+    { "blockchain",         "getdbinfo",              getdbinfo,              {} },
     { "blockchain",         "getdifficulty",          getdifficulty,          {} },
     { "blockchain",         "getfinalizedblockhash",  getfinalizedblockhash,  {} },
     { "blockchain",         "getmempoolancestors",    getmempoolancestors,    {"txid","verbose"} },
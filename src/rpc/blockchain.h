@@ -16,6 +16,7 @@ extern RecursiveMutex cs_main;
 
 class CBlock;
 class CBlockIndex;
+struct BlockStats;
 class Config;
 class CTxMemPool;
 class JSONRPCRequest;
@@ -48,5 +49,8 @@ UniValue MempoolToJSON(const CTxMemPool &pool, bool verbose = false);
 /** Block header to JSON */
 UniValue::Object blockheaderToJSON(const CBlockIndex *tip, const CBlockIndex *blockindex);
 
+/** Block statistics, as computed by ComputeBlockStats, to getblockstats JSON */
+UniValue::Object blockStatsToJSON(const CBlockIndex *pindex, const BlockStats &stats);
+
 /** Used by getblockstats to get feerates at different percentiles by weight  */
 void CalculatePercentilesBySize(Amount result[NUM_GETBLOCKSTATS_PERCENTILES], std::vector<std::pair<Amount, int64_t>>& scores, int64_t total_size);
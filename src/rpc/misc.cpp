@@ -11,13 +11,16 @@
 #include <httpserver.h>
 #include <key_io.h>
 #include <logging.h>
+#include <memorygovernor.h>
 #include <net.h>
 #include <netbase.h>
 #include <outputtype.h>
+#include <prevector.h>
 #include <rpc/blockchain.h>
 #include <rpc/server.h>
 #include <rpc/util.h>
 #include <timedata.h>
+#include <txmempool.h>
 #include <util/strencodings.h>
 #include <util/system.h>
 #include <validation.h>
@@ -26,6 +29,7 @@
 #include <univalue.h>
 
 #include <cstdint>
+#include <optional>
 #ifdef HAVE_MALLOC_INFO
 #include <malloc.h>
 #endif
@@ -325,6 +329,22 @@ static UniValue::Object RPCLockedMemoryInfo() {
     return obj;
 }
 
+static UniValue::Object RPCPrevectorInfo() {
+    UniValue::Object spills;
+    spills.reserve(prevector_stats::NUM_SIZE_CLASSES);
+    for (size_t i = 0; i < prevector_stats::NUM_SIZE_CLASSES; ++i) {
+        const size_t limit = prevector_stats::SizeClassLimit(i);
+        spills.emplace_back(limit ? std::to_string(limit) : "larger",
+                            prevector_stats::spills[i].load());
+    }
+    UniValue::Object obj;
+    obj.reserve(3);
+    obj.emplace_back("spills", std::move(spills));
+    obj.emplace_back("reallocs", prevector_stats::reallocs.load());
+    obj.emplace_back("pool_hits", prevector_stats::pool_hits.load());
+    return obj;
+}
+
 #ifdef HAVE_MALLOC_INFO
 static std::string RPCMallocInfo() {
     char *ptr = nullptr;
@@ -373,6 +393,21 @@ static UniValue getmemoryinfo(const Config &config,
             "disk.\n"
             "    \"chunks_used\": xxxxx,   (numeric) Number allocated chunks\n"
             "    \"chunks_free\": xxxxx,   (numeric) Number unused chunks\n"
+            "  },\n"
+            "  \"prevector\": {            (json object) Heap allocations of "
+            "small inline vectors, such as scripts\n"
+            "    \"spills\": {             (json object) Number of vectors "
+            "that moved to the heap, by buffer size\n"
+            "      \"32\": xxxxx,          (numeric) Buffers of at most 32 "
+            "bytes, and so on up to 2048\n"
+            "      ...\n"
+            "      \"larger\": xxxxx       (numeric) Buffers of more than "
+            "2048 bytes\n"
+            "    },\n"
+            "    \"reallocs\": xxxxx,      (numeric) Number of resizes of "
+            "buffers already on the heap\n"
+            "    \"pool_hits\": xxxxx      (numeric) Number of spills served "
+            "from a per-thread cache of freed buffers\n"
             "  }\n"
             "}\n"
             "\nResult (mode \"mallocinfo\"):\n"
@@ -386,8 +421,9 @@ static UniValue getmemoryinfo(const Config &config,
         request.params[0].isNull() ? "stats" : request.params[0].get_str();
     if (mode == "stats") {
         UniValue::Object obj;
-        obj.reserve(1);
+        obj.reserve(2);
         obj.emplace_back("locked", RPCLockedMemoryInfo());
+        obj.emplace_back("prevector", RPCPrevectorInfo());
         return obj;
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
@@ -402,6 +438,84 @@ static UniValue getmemoryinfo(const Config &config,
     }
 }
 
+static UniValue getmemorybudgetinfo(const Config &config,
+                                    const JSONRPCRequest &request) {
+    if (request.fHelp || request.params.size() != 0) {
+        throw std::runtime_error(
+            RPCHelpMan{"getmemorybudgetinfo",
+                "Returns how the memory budget set by -memorybudget is split "
+                "between the database caches, the in-memory UTXO set and the "
+                "mempool, and the latest decision of the memory governor.\n",
+                {}}
+                .ToString() +
+            "\nResult:\n"
+            "{\n"
+            "  \"enabled\": true|false,      (boolean) Whether -memorybudget "
+            "is set. If not, the other fields show the static split\n"
+            "  \"budget\": xxxxx,            (numeric) The whole budget, in "
+            "bytes (only if enabled)\n"
+            "  \"dbcache\": xxxxx,           (numeric) The part of the "
+            "budget used by the database caches, fixed at startup (only if "
+            "enabled)\n"
+            "  \"coinscache\": xxxxx,        (numeric) The current limit of "
+            "the in-memory UTXO set\n"
+            "  \"coinscacheusage\": xxxxx,   (numeric) The memory used by the "
+            "in-memory UTXO set\n"
+            "  \"mempool\": xxxxx,           (numeric) The current limit of "
+            "the mempool\n"
+            "  \"mempoolusage\": xxxxx,      (numeric) The memory used by the "
+            "mempool\n"
+            "  \"initialblockdownload\": true|false, (boolean) Whether the "
+            "governor last saw the node in initial block download (only if "
+            "enabled)\n"
+            "  \"hitrate\": x.xxx,           (numeric) The UTXO cache hit rate "
+            "between the last two rebalances, or null if there were too few "
+            "lookups (only if enabled)\n"
+            "  \"adjustments\": xxxxx,       (numeric) The number of times the "
+            "split changed (only if enabled)\n"
+            "  \"lastdecision\": \"str\",    (string) The reason for the "
+            "latest change of the split (only if enabled)\n"
+            "  \"lastdecisiontime\": xxxxx,  (numeric) The time of the latest "
+            "change of the split, in seconds since epoch (only if enabled)\n"
+            "}\n"
+            "\nExamples:\n" +
+            HelpExampleCli("getmemorybudgetinfo", "") +
+            HelpExampleRpc("getmemorybudgetinfo", ""));
+    }
+
+    size_t coinsCacheUsage;
+    size_t coinsCacheLimit;
+    {
+        LOCK(cs_main);
+        coinsCacheUsage = pcoinsTip ? pcoinsTip->DynamicMemoryUsage() : 0;
+        coinsCacheLimit = nCoinCacheUsage;
+    }
+    UniValue::Object obj;
+    obj.emplace_back("enabled", g_memory_governor != nullptr);
+    std::optional<MemoryGovernor::Info> info;
+    if (g_memory_governor) {
+        info = g_memory_governor->GetInfo();
+        obj.emplace_back("budget", info->budget);
+        obj.emplace_back("dbcache", info->levelDBCache);
+    }
+    obj.emplace_back("coinscache", coinsCacheLimit);
+    obj.emplace_back("coinscacheusage", coinsCacheUsage);
+    obj.emplace_back("mempool", config.GetMaxMemPoolSize());
+    obj.emplace_back("mempoolusage", g_mempool.DynamicMemoryUsage());
+    if (info) {
+        obj.emplace_back("initialblockdownload", info->initialBlockDownload);
+        if (info->hitRate) {
+            obj.emplace_back("hitrate", *info->hitRate);
+        } else {
+            obj.emplace_back("hitrate", UniValue());
+        }
+        obj.emplace_back("adjustments", info->adjustments);
+        obj.emplace_back("lastdecision", std::move(info->reason));
+        obj.emplace_back("lastdecisiontime", info->time);
+    }
+    return obj;
+}
+
 static void EnableOrDisableLogCategories(const UniValue::Array& cats, bool enable) {
     for (auto& cat : cats) {
         auto& catStr = cat.get_str();
@@ -540,6 +654,7 @@ static const ContextFreeRPCCommand commands[] = {
     //  category            name                      actor (function)        argNames
     //  ------------------- ------------------------  ----------------------  ----------
     { "control",            "getmemoryinfo",          getmemoryinfo,          {"mode"} },
+    { "control",            "getmemorybudgetinfo",    getmemorybudgetinfo,    {} },
     { "control",            "logging",                logging,                {"include", "exclude"} },
     { "util",               "validateaddress",        validateaddress,        {"address"} },
     { "util",               "createmultisig",         createmultisig,         {"nrequired","keys"} },
@@ -436,6 +436,12 @@ static UniValue getnettotals(const Config &config,
                 "  \"totalbytesrecv\": n,   (numeric) Total bytes received\n"
                 "  \"totalbytessent\": n,   (numeric) Total bytes sent\n"
                 "  \"timemillis\": t,       (numeric) Current UNIX time in milliseconds\n"
+                "  \"bytessent_per_class\":  (json object) Total bytes sent per message class\n"
+                "  {\n"
+                "    \"relay\": n,            (numeric) CMPCTBLOCK, BLOCKTXN, HEADERS and TX messages\n"
+                "    \"block\": n,            (numeric) BLOCK messages\n"
+                "    \"other\": n             (numeric) All other messages\n"
+                "  },\n"
                 "  \"uploadtarget\":\n"
                 "  {\n"
                 "    \"timeframe\": n,                         (numeric) Length of the measuring timeframe in seconds\n"
@@ -458,12 +464,20 @@ static UniValue getnettotals(const Config &config,
     }
 
     UniValue::Object obj;
-    obj.reserve(4);
+    obj.reserve(5);
 
     obj.emplace_back("totalbytesrecv", g_connman->GetTotalBytesRecv());
     obj.emplace_back("totalbytessent", g_connman->GetTotalBytesSent());
     obj.emplace_back("timemillis", GetTimeMillis());
 
+    const auto bytesSentPerClass = g_connman->GetTotalBytesSentPerClass();
+    UniValue::Object sentPerClass;
+    sentPerClass.reserve(bytesSentPerClass.size());
+    for (size_t i = 0; i < bytesSentPerClass.size(); ++i) {
+        sentPerClass.emplace_back(GetSendClassName(SendClass(i)), bytesSentPerClass[i]);
+    }
+    obj.emplace_back("bytessent_per_class", std::move(sentPerClass));
+
     UniValue::Object outboundLimit;
     outboundLimit.reserve(6);
     outboundLimit.emplace_back("timeframe", g_connman->GetMaxOutboundTimeframe());
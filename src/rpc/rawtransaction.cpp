@@ -1867,17 +1867,13 @@ static UniValue finalizepsbt(const Config &config,
     //   signature, but have not combined them yet (e.g. because the combiner
     //   that created this PartiallySignedTransaction did not understand them),
     //   this will combine them into a final script.
-    bool complete = true;
     const uint32_t scriptFlags = [&config] {
         LOCK(cs_main);
         return GetMemPoolScriptFlags(config.GetChainParams().GetConsensus(), ::ChainActive().Tip());
     }();
     // Assumption: Below code does NOT push_back new inputs to psbtx.tx.
     const auto contexts = ScriptExecutionContext::createForAllInputs(*psbtx.tx, psbtx.inputs);
-    for (size_t i = 0; i < psbtx.tx->vin.size(); ++i) {
-        complete &=
-            SignPSBTInput(DUMMY_SIGNING_PROVIDER, psbtx, i, scriptFlags, SigHashType(), contexts[i]);
-    }
+    const bool complete = SignPSBTInputs(DUMMY_SIGNING_PROVIDER, psbtx, scriptFlags, SigHashType(), contexts);
 
     UniValue::Object result;
     result.reserve(2);
@@ -15,8 +15,11 @@
 #include <util/strencodings.h>
 #include <util/system.h>
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -142,6 +145,9 @@ class BIP32PubkeyProvider final : public PubkeyProvider {
     CExtPubKey m_extkey;
     KeyPath m_path;
     DeriveType m_derive;
+    //! m_extkey derived along m_path, if the derivation is unhardened, so that
+    //! only the position is left to derive.
+    CExtPubKey m_path_extkey;
 
     bool GetExtKey(const SigningProvider &arg, CExtKey &ret) const {
         CKey key;
@@ -173,7 +179,14 @@ class BIP32PubkeyProvider final : public PubkeyProvider {
 public:
     BIP32PubkeyProvider(const CExtPubKey &extkey, KeyPath path,
                         DeriveType derive)
-        : m_extkey(extkey), m_path(std::move(path)), m_derive(derive) {}
+        : m_extkey(extkey), m_path(std::move(path)), m_derive(derive) {
+        if (!IsHardened()) {
+            m_path_extkey = m_extkey;
+            for (auto entry : m_path) {
+                m_path_extkey.Derive(m_path_extkey, entry);
+            }
+        }
+    }
     bool IsRange() const override { return m_derive != DeriveType::NO; }
     size_t GetSize() const override { return 33; }
     bool GetPubKey(int pos, const SigningProvider &arg, CPubKey &key,
@@ -194,11 +207,7 @@ public:
             }
             key = extkey.Neuter().pubkey;
         } else {
-            // TODO: optimize by caching
-            CExtPubKey extkey = m_extkey;
-            for (auto entry : m_path) {
-                extkey.Derive(extkey, entry);
-            }
+            CExtPubKey extkey = m_path_extkey;
             if (m_derive == DeriveType::UNHARDENED) {
                 extkey.Derive(extkey, pos);
             }
@@ -863,3 +872,88 @@ std::unique_ptr<Descriptor> InferDescriptor(const CScript &script,
                                             const SigningProvider &provider) {
     return InferScript(script, ParseScriptContext::TOP, provider);
 }
+
+//! Below this many positions per thread, starting worker threads costs more
+//! than expanding the positions on the calling thread.
+static constexpr int MIN_POSITIONS_PER_EXPAND_THREAD = 64;
+
+/**
+ * Expand a descriptor at one position and append its scripts to
+ * output_scripts. Some descriptors overwrite the scripts passed to Expand, so
+ * each position is expanded into a scratch vector.
+ */
+static bool AppendExpansion(const Descriptor &desc, int pos,
+                            const SigningProvider &provider,
+                            std::vector<CScript> &scratch,
+                            std::vector<CScript> &output_scripts,
+                            FlatSigningProvider &out) {
+    scratch.clear();
+    if (!desc.Expand(pos, provider, scratch, out)) {
+        return false;
+    }
+    output_scripts.insert(output_scripts.end(),
+                          std::make_move_iterator(scratch.begin()),
+                          std::make_move_iterator(scratch.end()));
+    return true;
+}
+
+bool ExpandRange(const Descriptor &desc, int begin, int end,
+                 const SigningProvider &provider,
+                 std::vector<CScript> &output_scripts) {
+    if (begin >= end) {
+        return true;
+    }
+    const size_t count = end - begin;
+    const size_t nThreads =
+        std::min<size_t>(std::max(GetNumCores(), 1),
+                         count / MIN_POSITIONS_PER_EXPAND_THREAD);
+    if (nThreads <= 1) {
+        const size_t size = output_scripts.size();
+        std::vector<CScript> scratch;
+        FlatSigningProvider out;
+        for (int pos = begin; pos < end; ++pos) {
+            if (!AppendExpansion(desc, pos, provider, scratch, output_scripts,
+                                 out)) {
+                output_scripts.erase(output_scripts.begin() + size,
+                                     output_scripts.end());
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Each thread expands a contiguous part of the range into its own
+    // scripts, which are then appended in order.
+    const size_t perThread = (count + nThreads - 1) / nThreads;
+    std::vector<std::vector<CScript>> scripts(nThreads);
+    std::atomic<bool> failed{false};
+    auto expand = [&](size_t thread) {
+        std::vector<CScript> scratch;
+        FlatSigningProvider out;
+        const int first = begin + thread * perThread;
+        const int last = begin + std::min(count, (thread + 1) * perThread);
+        for (int pos = first; pos < last && !failed; ++pos) {
+            if (!AppendExpansion(desc, pos, provider, scratch, scripts[thread],
+                                 out)) {
+                failed = true;
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t thread = 1; thread * perThread < count; ++thread) {
+        threads.emplace_back(expand, thread);
+    }
+    expand(0);
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    if (failed) {
+        return false;
+    }
+    for (std::vector<CScript> &part : scripts) {
+        output_scripts.insert(output_scripts.end(),
+                              std::make_move_iterator(part.begin()),
+                              std::make_move_iterator(part.end()));
+    }
+    return true;
+}
@@ -91,3 +91,13 @@ std::unique_ptr<Descriptor> Parse(const std::string &descriptor,
  */
 std::unique_ptr<Descriptor> InferDescriptor(const CScript &script,
                                             const SigningProvider &provider);
+
+/**
+ * Expand a descriptor at all positions from begin to end (excluded), and
+ * append the expanded scriptPubKeys to output_scripts in order of position.
+ * Large ranges are expanded on several threads. Fails if expanding any of the
+ * positions fails, in which case output_scripts is left unchanged.
+ */
+bool ExpandRange(const Descriptor &desc, int begin, int end,
+                 const SigningProvider &provider,
+                 std::vector<CScript> &output_scripts);
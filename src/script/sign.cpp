@@ -15,8 +15,10 @@
 using valtype = std::vector<uint8_t>;
 
 TransactionSignatureCreator::TransactionSignatureCreator(const ScriptExecutionContext &contextIn,
-                                                         SigHashType sigHashTypeIn)
-    : context(contextIn), sigHashType(sigHashTypeIn), checker(contextIn)
+                                                         SigHashType sigHashTypeIn,
+                                                         const PrecomputedTransactionData *txdataIn)
+    : context(contextIn), sigHashType(sigHashTypeIn), txdata(txdataIn),
+      checker(txdataIn ? TransactionSignatureChecker(contextIn, *txdataIn) : TransactionSignatureChecker(contextIn))
 {}
 
 bool TransactionSignatureCreator::CreateSig(const SigningProvider &provider, std::vector<uint8_t> &vchSig,
@@ -27,7 +29,7 @@ bool TransactionSignatureCreator::CreateSig(const SigningProvider &provider, std
         return false;
     }
 
-    const uint256 hash = SignatureHash(scriptCode, context, sigHashType, nullptr, scriptFlags);
+    const uint256 hash = SignatureHash(scriptCode, context, sigHashType, txdata, scriptFlags);
     if (!key.SignECDSA(hash, vchSig)) {
         return false;
     }
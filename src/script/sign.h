@@ -95,12 +95,16 @@ public:
 class TransactionSignatureCreator : public BaseSignatureCreator {
     const ScriptExecutionContext &context;
     SigHashType sigHashType;
+    const PrecomputedTransactionData *txdata;
     const TransactionSignatureChecker checker;
 
 public:
     // NB: if `context.isLimited()`, then we won't be able to sign SIGHASH_UTXOS
+    // If given, `txdataIn` must have been populated from a context for the same tx and of the same kind (limited or
+    // not) as `context`, and must outlive this instance.
     explicit TransactionSignatureCreator(const ScriptExecutionContext &context,
-                                         SigHashType sigHashTypeIn = SigHashType());
+                                         SigHashType sigHashTypeIn = SigHashType(),
+                                         const PrecomputedTransactionData *txdataIn = nullptr);
     const BaseSignatureChecker &Checker() const override { return checker; }
     bool CreateSig(const SigningProvider &provider,
                    std::vector<uint8_t> &vchSig, const CKeyID &keyid,
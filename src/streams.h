@@ -317,6 +317,16 @@ public:
     }
     value_type *data() { return vch.data() + nReadPos; }
     const value_type *data() const { return vch.data() + nReadPos; }
+    size_type capacity() const { return vch.capacity() - nReadPos; }
+
+    /**
+     * Exchange the underlying storage with `other` and rewind. Lets callers
+     * recycle an allocation without copying its contents.
+     */
+    void swap_buffer(vector_type &other) {
+        vch.swap(other);
+        nReadPos = 0;
+    }
 
     void insert(iterator it, std::vector<char>::const_iterator first,
                 std::vector<char>::const_iterator last) {
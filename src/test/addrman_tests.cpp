@@ -26,7 +26,7 @@ public:
             MakeDeterministic();
         }
         deterministic = makeDeterministic;
-        m_asmap = asmap;
+        m_asmap = ASMap(asmap);
     }
 
     //! Ensure that bucket placement is always the same for testing purposes.
@@ -441,7 +441,7 @@ BOOST_AUTO_TEST_CASE(caddrinfo_get_tried_bucket_legacy) {
     uint256 nKey2 = (uint256)(CHashWriter(SER_GETHASH, 0) << 2).GetHash();
 
     // use /16
-    std::vector<bool> asmap;
+    ASMap asmap;
 
     BOOST_CHECK_EQUAL(info1.GetTriedBucket(nKey1, asmap), 40);
 
@@ -494,7 +494,7 @@ BOOST_AUTO_TEST_CASE(caddrinfo_get_new_bucket_legacy) {
     uint256 nKey2 = (uint256)(CHashWriter(SER_GETHASH, 0) << 2).GetHash();
 
     // use /16
-    std::vector<bool> asmap;
+    ASMap asmap;
 
     // Test: Make sure the buckets are what we expect
     BOOST_CHECK_EQUAL(info1.GetNewBucket(nKey1, asmap), 786);
@@ -570,7 +570,7 @@ BOOST_AUTO_TEST_CASE(caddrinfo_get_tried_bucket) {
     uint256 nKey1 = (uint256)(CHashWriter(SER_GETHASH, 0) << 1).GetHash();
     uint256 nKey2 = (uint256)(CHashWriter(SER_GETHASH, 0) << 2).GetHash();
 
-    std::vector<bool> asmap = FromBytes(asmap_raw, sizeof(asmap_raw) * 8);
+    ASMap asmap(FromBytes(asmap_raw, sizeof(asmap_raw) * 8));
 
     BOOST_CHECK_EQUAL(info1.GetTriedBucket(nKey1, asmap), 236);
 
@@ -621,7 +621,7 @@ BOOST_AUTO_TEST_CASE(caddrinfo_get_new_bucket) {
     uint256 nKey1 = (uint256)(CHashWriter(SER_GETHASH, 0) << 1).GetHash();
     uint256 nKey2 = (uint256)(CHashWriter(SER_GETHASH, 0) << 2).GetHash();
 
-    std::vector<bool> asmap = FromBytes(asmap_raw, sizeof(asmap_raw) * 8);
+    ASMap asmap(FromBytes(asmap_raw, sizeof(asmap_raw) * 8));
 
     // Test: Make sure the buckets are what we expect
     BOOST_CHECK_EQUAL(info1.GetNewBucket(nKey1, asmap), 795);
@@ -747,6 +747,42 @@ BOOST_AUTO_TEST_CASE(addrman_serialization) {
     BOOST_CHECK(bucketAndEntry_asmap1_deser_addr1.second != bucketAndEntry_asmap1_deser_addr2.second);
 }
 
+BOOST_AUTO_TEST_CASE(asmap_compiled_lookup) {
+    const std::vector<bool> bits = FromBytes(asmap_raw, sizeof(asmap_raw) * 8);
+    const ASMap asmap(bits);
+    BOOST_CHECK(asmap.GetBits() == bits);
+    BOOST_CHECK(asmap.RangeCount() > 0);
+    BOOST_CHECK_EQUAL(ASMap().GetBits().size(), 0U);
+
+    // The mapped ranges of asmap.raw. Addresses outside them may map to any
+    // ASN, since the encoding does not need to tell them apart.
+    BOOST_CHECK_EQUAL(ResolveIP("250.0.0.0").GetMappedAS(asmap), 1000U);
+    BOOST_CHECK_EQUAL(ResolveIP("250.255.255.255").GetMappedAS(asmap), 1000U);
+    BOOST_CHECK_EQUAL(ResolveIP("101.1.0.0").GetMappedAS(asmap), 1U);
+    BOOST_CHECK_EQUAL(ResolveIP("101.4.128.1").GetMappedAS(asmap), 4U);
+    BOOST_CHECK_EQUAL(ResolveIP("101.8.255.255").GetMappedAS(asmap), 8U);
+    BOOST_CHECK_EQUAL(ResolveIP("::ffff:250.1.1.1").GetMappedAS(asmap), 1000U);
+    BOOST_CHECK_EQUAL(ResolveIP("2001:470::1").GetMappedAS(asmap), 0U);
+
+    // The compiled table agrees with the asmap interpreter, for random
+    // addresses in and around the mapped ranges and anywhere else.
+    for (int i = 0; i < 10000; ++i) {
+        uint64_t high = InsecureRandBits(64);
+        uint64_t low = InsecureRandBits(64);
+        if (i % 2 == 0) {
+            const uint64_t first_byte = i % 4 == 0 ? 101 : 250;
+            high = 0;
+            low = (uint64_t(0xffff) << 32) | (first_byte << 24) | InsecureRandBits(i % 3 == 0 ? 20 : 24);
+        }
+        std::vector<bool> ip(128);
+        for (int bit = 0; bit < 64; ++bit) {
+            ip[bit] = (high >> (63 - bit)) & 1;
+            ip[64 + bit] = (low >> (63 - bit)) & 1;
+        }
+        BOOST_CHECK_EQUAL(asmap.Lookup(high, low), Interpret(bits, ip));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(addrman_selecttriedcollision) {
     CAddrManTest addrman;
 
@@ -106,6 +106,40 @@ BOOST_AUTO_TEST_CASE(blockfail) {
     RunCheckOnBlock(config, block, "bad-blk-length");
 }
 
+// Large blocks get their transactions checked on the tx-check worker threads
+// (started by TestingSetup). The first bad transaction must still be the one
+// reported, regardless of which worker happened to find a failure first.
+BOOST_FIXTURE_TEST_CASE(parallel_tx_checks, TestingSetup) {
+    GlobalConfig config;
+    config.SetExcessiveBlockSize(DEFAULT_EXCESSIVE_BLOCK_SIZE);
+
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].scriptSig.resize(10);
+    tx.vout.resize(1);
+    tx.vout[0].nValue = 42 * SATOSHI;
+
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(tx));
+    for (size_t i = 1; i < 5000; i++) {
+        tx.vin[0].prevout = InsecureRandOutPoint();
+        block.vtx.push_back(MakeTransactionRef(tx));
+    }
+    RunCheckOnBlock(config, block);
+
+    // A transaction with duplicate inputs near the end of the block.
+    CMutableTransaction dupTx(*block.vtx[4000]);
+    dupTx.vin.push_back(dupTx.vin[0]);
+    block.vtx[4000] = MakeTransactionRef(dupTx);
+    RunCheckOnBlock(config, block, "bad-txns-inputs-duplicate");
+
+    // An earlier transaction without outputs takes precedence.
+    CMutableTransaction noOutTx(*block.vtx[2500]);
+    noOutTx.vout.clear();
+    block.vtx[2500] = MakeTransactionRef(noOutTx);
+    RunCheckOnBlock(config, block, "bad-txns-vout-empty");
+}
+
 BOOST_AUTO_TEST_CASE(blockserialization) {
     // While we have different serialization schemes for disk and network serialization,
     // for blocks in particular we want all schemes to produce the exact same data.
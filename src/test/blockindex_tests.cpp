@@ -38,6 +38,54 @@ BOOST_AUTO_TEST_CASE(get_block_header) {
     BOOST_CHECK(checkHeader.nNonce == expectedNonce);
 }
 
+BOOST_AUTO_TEST_CASE(evict_header_fields) {
+    CBlockHeader header;
+    header.nVersion = 4;
+    header.hashMerkleRoot = uint256S("0123456789ABCDEF");
+    header.nTime = 123;
+    header.nBits = 234;
+    header.nNonce = 345;
+
+    const BlockHash hash = header.GetHash();
+    CBlockIndex index(header);
+    index.phashBlock = &hash;
+
+    // Entries without header fields have nothing to evict.
+    CBlockIndex empty_index;
+    BOOST_CHECK(!empty_index.EvictHeaderFields());
+    BOOST_CHECK(!empty_index.HeaderFieldsEvicted());
+    BOOST_CHECK(empty_index.GetHeaderFields().hashMerkleRoot.IsNull());
+
+    // Evicted fields are read back through the loader, by block hash.
+    int loads = 0;
+    CBlockIndex::SetHeaderFieldsLoader([&](const BlockHash &loaded_hash) {
+        BOOST_CHECK(loaded_hash == hash);
+        ++loads;
+        return CBlockIndexHeaderFields{header.nVersion, header.hashMerkleRoot,
+                                       header.nNonce};
+    });
+    BOOST_CHECK(!index.HeaderFieldsEvicted());
+    BOOST_CHECK(index.EvictHeaderFields());
+    BOOST_CHECK(index.HeaderFieldsEvicted());
+    BOOST_CHECK(!index.EvictHeaderFields());
+    BOOST_CHECK(index.GetBlockHeader().GetHash() == hash);
+    BOOST_CHECK_EQUAL(loads, 1);
+
+    // Copies of an evicted entry, as written to disk, have all the fields.
+    const CDiskBlockIndex disk_index(&index);
+    BOOST_CHECK(disk_index.GetBlockHash() == hash);
+    BOOST_CHECK_EQUAL(loads, 2);
+
+    // Setting the fields makes them resident again.
+    index.SetHeaderFields({header.nVersion, header.hashMerkleRoot,
+                           header.nNonce});
+    BOOST_CHECK(!index.HeaderFieldsEvicted());
+    BOOST_CHECK(index.GetBlockHeader().GetHash() == hash);
+    BOOST_CHECK_EQUAL(loads, 2);
+
+    CBlockIndex::SetHeaderFieldsLoader(nullptr);
+}
+
 BOOST_AUTO_TEST_CASE(get_disk_positions) {
     // Test against all validity values
     std::set<BlockValidity> validityValues{
@@ -241,7 +289,7 @@ BOOST_AUTO_TEST_CASE(to_string) {
         "hashBlock="
         "0000000000000000000000000000000000000000000000000000000000000000)",
         &indexPrev);
-    index.hashMerkleRoot = uint256S("0123456789ABCDEF");
+    index.SetHeaderFields({0, uint256S("0123456789ABCDEF"), 0});
     indexString = index.ToString();
     BOOST_CHECK_EQUAL(indexString, expectedString);
 
@@ -0,0 +1,141 @@
+// Copyright (c) 2026 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/blockstatsindex.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <config.h>
+#include <script/sighashtype.h>
+#include <script/standard.h>
+#include <undo.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <test/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(blockstatsindex_tests)
+
+static void CheckStatsEqual(const BlockStats &a, const BlockStats &b) {
+    BOOST_CHECK(a.block_hash == b.block_hash);
+    BOOST_CHECK_EQUAL(a.txs, b.txs);
+    BOOST_CHECK_EQUAL(a.ins, b.ins);
+    BOOST_CHECK_EQUAL(a.outs, b.outs);
+    BOOST_CHECK_EQUAL(a.total_size, b.total_size);
+    BOOST_CHECK_EQUAL(a.mintxsize, b.mintxsize);
+    BOOST_CHECK_EQUAL(a.maxtxsize, b.maxtxsize);
+    BOOST_CHECK_EQUAL(a.mediantxsize, b.mediantxsize);
+    BOOST_CHECK_EQUAL(a.utxo_size_inc, b.utxo_size_inc);
+    BOOST_CHECK_EQUAL(a.total_out, b.total_out);
+    BOOST_CHECK_EQUAL(a.totalfee, b.totalfee);
+    BOOST_CHECK_EQUAL(a.minfee, b.minfee);
+    BOOST_CHECK_EQUAL(a.maxfee, b.maxfee);
+    BOOST_CHECK_EQUAL(a.medianfee, b.medianfee);
+    BOOST_CHECK_EQUAL(a.minfeerate, b.minfeerate);
+    BOOST_CHECK_EQUAL(a.maxfeerate, b.maxfeerate);
+    for (size_t i = 0; i < a.feerate_percentiles.size(); ++i) {
+        BOOST_CHECK_EQUAL(a.feerate_percentiles[i], b.feerate_percentiles[i]);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(blockstatsindex_initial_sync, TestChain100Setup) {
+    BlockStatsIndex index(1 << 20, true);
+
+    BlockStats stats;
+    const CBlockIndex *tip = WITH_LOCK(cs_main, return ::ChainActive().Tip());
+    BOOST_CHECK(!index.LookupStats(tip, stats));
+
+    index.Start();
+
+    // Allow the index to catch up with the block index.
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!index.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        MilliSleep(100);
+    }
+
+    // Spend a mature coinbase so the next block pays a fee.
+    const CScript scriptPubKey = CScript()
+                                 << ToByteVector(coinbaseKey.GetPubKey())
+                                 << OP_CHECKSIG;
+    CMutableTransaction spend;
+    spend.nVersion = 1;
+    spend.vin.resize(1);
+    spend.vin[0].prevout = COutPoint(m_coinbase_txns[0]->GetId(), 0);
+    spend.vout.resize(1);
+    spend.vout[0].nValue = m_coinbase_txns[0]->vout[0].nValue - 1000 * SATOSHI;
+    spend.vout[0].scriptPubKey = scriptPubKey;
+    std::vector<uint8_t> vchSig;
+    const uint256 hash = SignatureHash(
+        scriptPubKey,
+        ScriptExecutionContext{0, m_coinbase_txns[0]->vout[0], spend},
+        SigHashType().withFork(), nullptr, STANDARD_SCRIPT_VERIFY_FLAGS);
+    BOOST_REQUIRE(coinbaseKey.SignECDSA(hash, vchSig));
+    vchSig.push_back(uint8_t(SIGHASH_ALL | SIGHASH_FORKID));
+    spend.vin[0].scriptSig << vchSig;
+    CreateAndProcessBlock({spend}, scriptPubKey);
+    BOOST_CHECK(index.BlockUntilSyncedToCurrentChain());
+
+    // Every block's indexed stats match a fresh computation from disk.
+    std::vector<const CBlockIndex *> blocks;
+    {
+        LOCK(cs_main);
+        for (const CBlockIndex *pindex = ::ChainActive().Genesis(); pindex;
+             pindex = ::ChainActive().Next(pindex)) {
+            blocks.push_back(pindex);
+        }
+    }
+    const auto &consensus = GetConfig().GetChainParams().GetConsensus();
+    for (const CBlockIndex *pindex : blocks) {
+        CBlock block;
+        CBlockUndo undo;
+        BOOST_REQUIRE(ReadBlockFromDisk(block, pindex, consensus));
+        BOOST_REQUIRE(pindex->nHeight == 0 || UndoReadFromDisk(undo, pindex));
+        BlockStats expected;
+        ComputeBlockStats(block, &undo, expected);
+        BOOST_REQUIRE(index.LookupStats(pindex, stats));
+        CheckStatsEqual(stats, expected);
+    }
+
+    const BlockStats &fee_block = stats;
+    BOOST_CHECK_EQUAL(fee_block.txs, 2U);
+    BOOST_CHECK_EQUAL(fee_block.ins, 1U);
+    BOOST_CHECK_EQUAL(fee_block.totalfee, 1000 * SATOSHI);
+    BOOST_CHECK_EQUAL(fee_block.minfee, 1000 * SATOSHI);
+    BOOST_CHECK(fee_block.mintxsize > 0);
+
+    // Ranges are served with a single scan.
+    std::vector<BlockStats> range;
+    BOOST_REQUIRE(blocks.size() > 10);
+    const std::vector<const CBlockIndex *> tail(blocks.end() - 10,
+                                                blocks.end());
+    BOOST_REQUIRE(index.LookupStatsRange(tail, range));
+    BOOST_REQUIRE_EQUAL(range.size(), tail.size());
+    for (size_t i = 0; i < tail.size(); ++i) {
+        BOOST_CHECK(range[i].block_hash == tail[i]->GetBlockHash());
+    }
+
+    // A block that is not the one indexed at its height is not found.
+    CBlockIndex fake_index;
+    const BlockHash fake_hash(InsecureRand256());
+    fake_index.nHeight = blocks.back()->nHeight;
+    fake_index.phashBlock = &fake_hash;
+    BOOST_CHECK(!index.LookupStats(&fake_index, stats));
+    std::vector<const CBlockIndex *> with_fake(tail);
+    with_fake.back() = &fake_index;
+    BOOST_CHECK(!index.LookupStatsRange(with_fake, range));
+
+    // shutdown sequence (c.f. Shutdown() in init.cpp)
+    index.Stop();
+
+    scheduler.stop();
+    schedulerThread.join();
+
+    // Rest of shutdown sequence and destructors happen in ~TestingSetup()
+}
+
+BOOST_AUTO_TEST_SUITE_END()
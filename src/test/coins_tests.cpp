@@ -695,6 +695,22 @@ BOOST_AUTO_TEST_CASE(coin_access) {
     CheckAccessCoin(VALUE1, VALUE2, VALUE2, DIRTY | FRESH, DIRTY | FRESH);
 }
 
+BOOST_AUTO_TEST_CASE(coin_cache_hits) {
+    // Lookups of coins already in the cache are hits, other lookups are misses
+    // whether the base view has the coin or not.
+    SingleEntryCacheTest test(VALUE1, ABSENT, NO_ENTRY);
+    test.cache.AccessCoin(OUTPOINT);
+    BOOST_CHECK_EQUAL(test.cache.GetCacheHits(), 0U);
+    BOOST_CHECK_EQUAL(test.cache.GetCacheMisses(), 1U);
+    test.cache.AccessCoin(OUTPOINT);
+    BOOST_CHECK(test.cache.HaveCoin(OUTPOINT));
+    BOOST_CHECK_EQUAL(test.cache.GetCacheHits(), 2U);
+    BOOST_CHECK_EQUAL(test.cache.GetCacheMisses(), 1U);
+    BOOST_CHECK(!test.cache.HaveCoin(COutPoint(TxId(InsecureRand256()), 0)));
+    BOOST_CHECK_EQUAL(test.cache.GetCacheHits(), 2U);
+    BOOST_CHECK_EQUAL(test.cache.GetCacheMisses(), 2U);
+}
+
 static void CheckSpendCoin(Amount base_value, Amount cache_value,
                            Amount expected_value, char cache_flags,
                            char expected_flags) {
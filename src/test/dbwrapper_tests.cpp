@@ -5,13 +5,16 @@
 
 #include <dbwrapper.h>
 
+#include <fs.h>
 #include <random.h>
 #include <uint256.h>
+#include <util/system.h>
 
 #include <test/setup_common.h>
 
 #include <boost/test/unit_test.hpp>
 
+#include <cstdio>
 #include <memory>
 
 // Test if a string consists entirely of null characters
@@ -84,6 +87,41 @@ BOOST_AUTO_TEST_CASE(dbwrapper_batch) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(dbwrapper_unlogged) {
+    fs::path ph = SetDataDir("dbwrapper_unlogged");
+    create_directories(ph);
+    const uint256 in = InsecureRand256();
+    const uint256 in2 = InsecureRand256();
+    uint256 res;
+
+    {
+        CDBWrapper dbw(ph, (1 << 20), false, false, false);
+        BOOST_CHECK(dbw.Write('i', in));
+        CDBBatch batch(dbw);
+        batch.Write('j', in2);
+        BOOST_CHECK(dbw.WriteBatchUnlogged(batch));
+        BOOST_CHECK(dbw.Read('j', res));
+        BOOST_CHECK(res == in2);
+    }
+    {
+        // Without a flush, the unlogged write did not survive.
+        CDBWrapper dbw(ph, (1 << 20), false, false, false);
+        BOOST_CHECK(dbw.Read('i', res));
+        BOOST_CHECK(res == in);
+        BOOST_CHECK(!dbw.Read('j', res));
+
+        CDBBatch batch(dbw);
+        batch.Write('j', in2);
+        BOOST_CHECK(dbw.WriteBatchUnlogged(batch));
+        BOOST_CHECK(dbw.Flush());
+    }
+    {
+        CDBWrapper dbw(ph, (1 << 20), false, false, false);
+        BOOST_CHECK(dbw.Read('j', res));
+        BOOST_CHECK(res == in2);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(dbwrapper_iterator) {
     // Perform tests both obfuscated and non-obfuscated.
     for (const bool obfuscate : {false, true}) {
@@ -254,6 +292,76 @@ BOOST_AUTO_TEST_CASE(existing_data_reindex) {
     BOOST_CHECK_EQUAL(res3.ToString(), in2.ToString());
 }
 
+BOOST_AUTO_TEST_CASE(dbwrapper_mmap) {
+    fs::path ph = SetDataDir("dbwrapper_mmap");
+    create_directories(ph);
+    constexpr uint16_t num_keys = 2000;
+    std::vector<uint256> values(num_keys);
+
+    {
+        CDBWrapper dbw(ph, (1 << 20), false, false, false);
+        leveldb::MmapReadStats stats;
+        BOOST_CHECK(!dbw.GetMmapStats(stats));
+        for (uint16_t i = 0; i < num_keys; ++i) {
+            values[i] = InsecureRand256();
+            BOOST_CHECK(dbw.Write(i, values[i]));
+        }
+    }
+
+    gArgs.ForceSetArg("-dbmmap", "1");
+    const auto read_all = [&](const CDBWrapper &dbw) {
+        for (uint16_t i = 0; i < num_keys; ++i) {
+            uint256 res;
+            BOOST_CHECK(dbw.Read(i, res));
+            BOOST_CHECK(res == values[i]);
+        }
+    };
+    {
+        // Reopening flushes the log to a table, which is then mapped
+        auto dbw = std::make_unique<CDBWrapper>(ph, (1 << 20), false, false,
+                                                false, true);
+        leveldb::MmapReadStats stats;
+        BOOST_REQUIRE(dbw->GetMmapStats(stats));
+        read_all(*dbw);
+        BOOST_REQUIRE(dbw->GetMmapStats(stats));
+        BOOST_CHECK(stats.mapped_files > 0);
+        BOOST_CHECK(stats.mapped_bytes > 0);
+        BOOST_CHECK(stats.verified_blocks > 0);
+        BOOST_CHECK_EQUAL(stats.checksum_failures, 0U);
+
+        // Blocks are only verified on their first read
+        const uint64_t verified = stats.verified_blocks;
+        read_all(*dbw);
+        BOOST_REQUIRE(dbw->GetMmapStats(stats));
+        BOOST_CHECK_EQUAL(stats.verified_blocks, verified);
+
+        dbw.reset();
+    }
+
+    // Corrupt a byte of the first data block of every table
+    for (const auto &entry : fs::directory_iterator(ph)) {
+        if (entry.path().extension() != ".ldb") {
+            continue;
+        }
+        FILE *file = fsbridge::fopen(entry.path(), "r+b");
+        BOOST_REQUIRE(file);
+        BOOST_REQUIRE_EQUAL(fseek(file, 16, SEEK_SET), 0);
+        const int c = fgetc(file);
+        BOOST_REQUIRE(c != EOF);
+        BOOST_REQUIRE_EQUAL(fseek(file, 16, SEEK_SET), 0);
+        BOOST_REQUIRE(fputc(c ^ 0xff, file) != EOF);
+        fclose(file);
+    }
+    {
+        CDBWrapper dbw(ph, (1 << 20), false, false, false, true);
+        BOOST_CHECK_THROW(read_all(dbw), dbwrapper_error);
+        leveldb::MmapReadStats stats;
+        BOOST_REQUIRE(dbw.GetMmapStats(stats));
+        BOOST_CHECK(stats.checksum_failures > 0);
+    }
+    gArgs.ForceSetArg("-dbmmap", "0");
+}
+
 BOOST_AUTO_TEST_CASE(iterator_ordering) {
     fs::path ph = SetDataDir("iterator_ordering");
     CDBWrapper dbw(ph, (1 << 20), true, false, false);
@@ -13,6 +13,7 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -337,4 +338,48 @@ BOOST_AUTO_TEST_CASE(descriptor_test) {
         ")");
 }
 
+BOOST_AUTO_TEST_CASE(descriptor_expand_range) {
+    const std::string xprv =
+        "xprvA1RpRA33e1JQ7ifknakTFpgNXPmW2YvmhqLQYMmrj4xJXXWYpDPS3xz7iAxn8L39"
+        "njGVyuoseXzU6rcxFLJ8HFsTjSyQbLYnMpCqE2VbFWc";
+    const std::string xpub =
+        "xpub6ERApfZwUNrhLCkDtcHTcxd75RbzS1ed54G1LkBUHQVHQKqhMkhgbmJbZRkrgZw4"
+        "koxb5JaHWkY4ALHY2grBGRjaDMzQLcgJvLJuZZvRcEL";
+    constexpr int begin = 10;
+    constexpr int end = 310;
+
+    // Expanding a range gives the scripts of every position, in order, for
+    // unhardened and hardened derivations.
+    for (const std::string &desc_str :
+         {"combo(" + xpub + "/1/2/*)", "pkh(" + xprv + "/1'/*')",
+          "sh(multi(1," + xpub + "/*," + xprv + "/0'/*))"}) {
+        FlatSigningProvider keys;
+        const auto desc = Parse(desc_str, keys);
+        BOOST_REQUIRE(desc);
+        std::vector<CScript> expected;
+        for (int pos = begin; pos < end; ++pos) {
+            FlatSigningProvider out;
+            std::vector<CScript> pos_scripts;
+            BOOST_CHECK(desc->Expand(pos, keys, pos_scripts, out));
+            expected.insert(expected.end(), pos_scripts.begin(), pos_scripts.end());
+        }
+        std::vector<CScript> scripts{CScript() << OP_TRUE};
+        BOOST_CHECK(ExpandRange(*desc, begin, end, keys, scripts));
+        BOOST_REQUIRE_EQUAL(scripts.size(), expected.size() + 1);
+        BOOST_CHECK(scripts.front() == (CScript() << OP_TRUE));
+        BOOST_CHECK(std::equal(expected.begin(), expected.end(), scripts.begin() + 1));
+    }
+
+    // Hardened derivation fails without the private key, leaving the output
+    // unchanged.
+    FlatSigningProvider keys;
+    const auto desc = Parse("pkh(" + xpub + "/*')", keys);
+    BOOST_REQUIRE(desc);
+    std::vector<CScript> scripts{CScript() << OP_TRUE};
+    BOOST_CHECK(!ExpandRange(*desc, begin, end, keys, scripts));
+    BOOST_CHECK_EQUAL(scripts.size(), 1U);
+    BOOST_CHECK(ExpandRange(*desc, begin, begin, keys, scripts));
+    BOOST_CHECK_EQUAL(scripts.size(), 1U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -18,6 +18,7 @@
 #include <util/system.h>
 #include <util/time.h>
 #include <validation.h>
+#include <validationinterface.h>
 #include <version.h>
 
 #include <test/setup_common.h>
@@ -281,14 +282,27 @@ BOOST_AUTO_TEST_CASE(dsproof_orphan_autocleaner) {
     SetMockTime(0); // undo mocktime
 }
 
+/// Waits for the double spend proofs that AcceptToMemoryPool queued to the
+/// validation interface queue. The locks are released meanwhile, since proof
+/// creation needs them.
+static void SyncDoubleSpendProofs() EXCLUSIVE_LOCKS_REQUIRED(cs_main, g_mempool.cs) {
+    LEAVE_CRITICAL_SECTION(g_mempool.cs);
+    LEAVE_CRITICAL_SECTION(cs_main);
+    SyncWithValidationInterfaceQueue();
+    ENTER_CRITICAL_SECTION(cs_main);
+    ENTER_CRITICAL_SECTION(g_mempool.cs);
+}
+
 static std::pair<bool, CValidationState> ToMemPool(const CMutableTransaction &tx, CTransactionRef *pref = nullptr)
-EXCLUSIVE_LOCKS_REQUIRED(cs_main) {
+EXCLUSIVE_LOCKS_REQUIRED(cs_main, g_mempool.cs) {
     CValidationState state;
     auto txref = MakeTransactionRef(tx);
     if (pref) *pref = txref;
     const bool b = AcceptToMemoryPool(GetConfig(), g_mempool, state, txref,
                                       nullptr /* pfMissingInputs */, true /* bypass_limits */,
                                       Amount::zero() /* nAbsurdFee */);
+    if (!b && state.GetRejectReason() == "txn-mempool-conflict")
+        SyncDoubleSpendProofs();
     return {b, std::move(state)};
 }
 
@@ -392,14 +406,24 @@ BOOST_FIXTURE_TEST_CASE(dsproof_doublespend_mempool, EnsureClearedMempoolTestCha
             BOOST_CHECK(!ok);
             BOOST_CHECK(!state.IsValid());
             BOOST_CHECK_EQUAL(state.GetRejectReason(), "txn-mempool-conflict");
-            BOOST_CHECK(state.HasDspId());
             auto dsproof = DoubleSpendProof::create(CTransaction{spend2}, CTransaction{spend1},
                                                     spend1.vin[0].prevout, &cbTxRef->vout[0]);
             BOOST_CHECK(!dsproof.isEmpty());
             auto val = dsproof.validate(g_mempool, {});
             BOOST_CHECK_EQUAL(val, DoubleSpendProof::Validity::Valid);
-            BOOST_CHECK_EQUAL(dsproof.GetId(), state.GetDspId());
-            BOOST_CHECK(!state.GetDspId().IsNull());
+
+            // The signature checks can also be run separately, as the network
+            // code does; the result of the first run is served from the cache.
+            DoubleSpendProof::SignatureCheck check;
+            BOOST_CHECK_EQUAL(dsproof.prepareValidation(g_mempool, check), DoubleSpendProof::Validity::Valid);
+            BOOST_CHECK(check.spendingTxId == spend1.GetId());
+            BOOST_CHECK(!check.pubkey.empty());
+            const auto hits = DoubleSpendProof::GetValidationCacheHits();
+            BOOST_CHECK_EQUAL(dsproof.verifySignatures(check), DoubleSpendProof::Validity::Valid);
+            BOOST_CHECK_EQUAL(DoubleSpendProof::GetValidationCacheHits(), hits + 1);
+            DoubleSpendProof::ClearValidationCache();
+            BOOST_CHECK_EQUAL(dsproof.validate(g_mempool, {}), DoubleSpendProof::Validity::Valid);
+            BOOST_CHECK_EQUAL(DoubleSpendProof::GetValidationCacheHits(), 0u);
 
             // Ensure mempool entry has the proper hash as well
             auto optIter = g_mempool.GetIter(spend1.GetId());
@@ -680,6 +704,77 @@ BOOST_FIXTURE_TEST_CASE(dsproof_recursive_search_mempool, EnsureClearedMempoolTe
     BOOST_CHECK_EQUAL(g_mempool.doubleSpendProofStorage()->size(), 0u);
 }
 
+/// Test that a tx double-spending several mempool txs at once gets a proof created for each of them.
+BOOST_FIXTURE_TEST_CASE(dsproof_multiple_conflicts, EnsureClearedMempoolTestChain100Setup) {
+    FlatSigningProvider provider;
+    provider.keys[coinbaseKey.GetPubKey().GetID()] = coinbaseKey;
+    provider.pubkeys[coinbaseKey.GetPubKey().GetID()] = coinbaseKey.GetPubKey();
+
+    const CScript scriptPubKey = GetScriptForDestination(coinbaseKey.GetPubKey().GetID());
+    const size_t firstTxIdx = m_coinbase_txns.size();
+    constexpr size_t nConflicts = 3;
+
+    // mine some blocks that send coinbase to p2pkh, so that the first few of them mature
+    for (int i = 0; i < COINBASE_MATURITY + int(nConflicts); ++i) {
+        m_coinbase_txns.push_back(CreateAndProcessBlock({}, scriptPubKey).vtx[0]);
+    }
+
+    LOCK2(cs_main, g_mempool.cs);
+    auto const context = std::nullopt;
+
+    // Each mempool tx spends one of the coinbases
+    std::vector<CMutableTransaction> spends(nConflicts);
+    CMutableTransaction dblSpend;
+    dblSpend.nVersion = 1;
+    dblSpend.vout.resize(1);
+    dblSpend.vout[0].nValue = CENT;
+    dblSpend.vout[0].scriptPubKey = scriptPubKey;
+    for (size_t i = 0; i < nConflicts; ++i) {
+        const auto &cbTxRef = m_coinbase_txns.at(firstTxIdx + i);
+        spends[i].nVersion = 1;
+        spends[i].vin.resize(1);
+        spends[i].vin[0].prevout = COutPoint(cbTxRef->GetId(), 0);
+        spends[i].vout.resize(1);
+        spends[i].vout[0].nValue = int64_t(2 + i) * CENT;
+        spends[i].vout[0].scriptPubKey = scriptPubKey;
+        BOOST_CHECK(SignSignature(provider, *cbTxRef, spends[i], 0, SigHashType().withFork(),
+                                  STANDARD_SCRIPT_VERIFY_FLAGS, context));
+        auto [ok, state] = ToMemPool(spends[i]);
+        BOOST_CHECK(ok);
+        dblSpend.vin.emplace_back(spends[i].vin[0].prevout);
+    }
+    for (size_t i = 0; i < nConflicts; ++i) {
+        BOOST_CHECK(SignSignature(provider, *m_coinbase_txns.at(firstTxIdx + i), dblSpend, i,
+                                  SigHashType().withFork(), STANDARD_SCRIPT_VERIFY_FLAGS, context));
+    }
+
+    // The double spend conflicts on every one of its inputs
+    const auto conflicts = g_mempool.GetConflicts(CTransaction{dblSpend});
+    BOOST_CHECK_EQUAL(conflicts.size(), nConflicts);
+    for (size_t i = 0; i < conflicts.size(); ++i) {
+        BOOST_CHECK(conflicts[i].first == dblSpend.vin[i].prevout);
+        BOOST_CHECK(conflicts[i].second->GetId() == spends[i].GetId());
+    }
+
+    auto [ok, state] = ToMemPool(dblSpend);
+    BOOST_CHECK(!ok);
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "txn-mempool-conflict");
+
+    // ... and all of the txs it conflicts with got a proof
+    BOOST_CHECK_EQUAL(g_mempool.doubleSpendProofStorage()->size(), nConflicts);
+    for (const auto &spend : spends) {
+        const auto optProof = g_mempool.getDoubleSpendProof(spend.GetId());
+        BOOST_CHECK(bool(optProof));
+        if (!optProof) continue;
+        BOOST_CHECK(optProof->outPoint() == spend.vin[0].prevout);
+        BOOST_CHECK_EQUAL(optProof->validate(g_mempool), DoubleSpendProof::Validity::Valid);
+    }
+
+    g_mempool.clear();
+    BOOST_CHECK_EQUAL(g_mempool.size(), 0u);
+    BOOST_CHECK_EQUAL(g_mempool.doubleSpendProofStorage()->size(), 0u);
+}
+
 // Like EnsureClearedMempoolTestChain100Setup, but ensures tokens are enabled
 struct Upgrade9TestChain100Setup : Upgrade9ActivatedMixin, EnsureClearedMempoolTestChain100Setup {};
 
@@ -166,6 +166,64 @@ BOOST_AUTO_TEST_CASE(siphash) {
         BOOST_CHECK_EQUAL(SipHashUint256(k1, k2, x), sip256.Finalize());
         BOOST_CHECK_EQUAL(SipHashUint256Extra(k1, k2, x, n), sip288.Finalize());
     }
+
+    // Check consistency between SipHashUint256[Extra] and their 4-way versions.
+    for (int i = 0; i < 16; ++i) {
+        uint64_t k1 = ctx.rand64();
+        uint64_t k2 = ctx.rand64();
+        uint256 x[4];
+        const uint256 *px[4];
+        uint32_t n[4];
+        for (int j = 0; j < 4; ++j) {
+            x[j] = InsecureRand256();
+            px[j] = &x[j];
+            n[j] = ctx.rand32();
+        }
+        uint64_t out[4], out_extra[4];
+        SipHashUint256_4way(k1, k2, px, out);
+        SipHashUint256Extra_4way(k1, k2, px, n, out_extra);
+        for (int j = 0; j < 4; ++j) {
+            BOOST_CHECK_EQUAL(out[j], SipHashUint256(k1, k2, x[j]));
+            BOOST_CHECK_EQUAL(out_extra[j], SipHashUint256Extra(k1, k2, x[j], n[j]));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(salted_hasher_batch) {
+    // Batch sizes around the 4-way chunking, including a partial last chunk.
+    for (size_t count : {0, 1, 3, 4, 5, 8, 11}) {
+        std::vector<TxId> txids;
+        std::vector<COutPoint> outpoints;
+        for (size_t i = 0; i < count; ++i) {
+            txids.emplace_back(InsecureRand256());
+            outpoints.emplace_back(txids.back(), InsecureRand32());
+        }
+        std::vector<const uint256 *> pvals;
+        std::vector<const TxId *> ptxids;
+        std::vector<const COutPoint *> poutpoints;
+        for (size_t i = 0; i < count; ++i) {
+            pvals.push_back(&txids[i]);
+            ptxids.push_back(&txids[i]);
+            poutpoints.push_back(&outpoints[i]);
+        }
+
+        const SaltedUint256Hasher uint256_hasher;
+        const SaltedTxIdHasher txid_hasher;
+        const SaltedOutpointHasher outpoint_hasher;
+        std::vector<size_t> out(count);
+        uint256_hasher.HashBatch(pvals.data(), count, out.data());
+        for (size_t i = 0; i < count; ++i) {
+            BOOST_CHECK_EQUAL(out[i], uint256_hasher(txids[i]));
+        }
+        txid_hasher.HashBatch(ptxids.data(), count, out.data());
+        for (size_t i = 0; i < count; ++i) {
+            BOOST_CHECK_EQUAL(out[i], txid_hasher(txids[i]));
+        }
+        outpoint_hasher.HashBatch(poutpoints.data(), count, out.data());
+        for (size_t i = 0; i < count; ++i) {
+            BOOST_CHECK_EQUAL(out[i], outpoint_hasher(outpoints[i]));
+        }
+    }
 }
 
 namespace {
@@ -0,0 +1,113 @@
+// Copyright (c) 2026 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <memorygovernor.h>
+
+#include <test/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(memorygovernor_tests, BasicTestingSetup)
+
+namespace {
+
+constexpr size_t MIB = 1024 * 1024;
+constexpr size_t BUDGET = 1024 * MIB;
+constexpr size_t LEVELDB_CACHE = 64 * MIB;
+constexpr size_t SHARED = BUDGET - LEVELDB_CACHE;
+constexpr size_t STEP = SHARED / 16;
+
+void CheckSplit(const MemoryGovernor::Info &info) {
+    BOOST_CHECK_EQUAL(info.budget, BUDGET);
+    BOOST_CHECK_EQUAL(info.levelDBCache, LEVELDB_CACHE);
+    BOOST_CHECK_EQUAL(info.coinsCacheSize + info.mempoolSize, SHARED);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(rebalance) {
+    MemoryGovernor governor(BUDGET, LEVELDB_CACHE, 300 * MIB);
+    BOOST_CHECK_EQUAL(governor.GetMinMempoolSize(), SHARED / 16);
+    BOOST_CHECK_EQUAL(governor.GetMaxMempoolSize(), 300 * MIB);
+
+    // Starts as if synced, with the mempool at its maximum.
+    MemoryGovernor::Info info = governor.GetInfo();
+    CheckSplit(info);
+    BOOST_CHECK_EQUAL(info.mempoolSize, 300 * MIB);
+    BOOST_CHECK_EQUAL(info.adjustments, 0U);
+
+    // During initial block download, the mempool is at its minimum whatever
+    // the hit rate.
+    uint64_t hits = 0, misses = 0;
+    info = governor.Rebalance({true, hits += 100, misses += 10000, 0}, 1);
+    CheckSplit(info);
+    BOOST_CHECK(info.initialBlockDownload);
+    BOOST_CHECK_EQUAL(info.mempoolSize, SHARED / 16);
+    BOOST_CHECK_EQUAL(info.adjustments, 1U);
+    BOOST_CHECK_EQUAL(info.time, 1);
+    info = governor.Rebalance({true, hits += 100000, misses, 0}, 2);
+    BOOST_CHECK_EQUAL(info.mempoolSize, SHARED / 16);
+    BOOST_CHECK_EQUAL(info.adjustments, 1U);
+    BOOST_CHECK_EQUAL(info.time, 1);
+
+    // Once synced, the mempool gets back to its maximum.
+    info = governor.Rebalance({false, hits += 1000, misses, 0}, 3);
+    CheckSplit(info);
+    BOOST_CHECK(!info.initialBlockDownload);
+    BOOST_CHECK_EQUAL(info.mempoolSize, 300 * MIB);
+    BOOST_CHECK_EQUAL(info.adjustments, 2U);
+
+    // A low hit rate only moves memory to the UTXO cache if the mempool is
+    // under-used...
+    info = governor.Rebalance({false, hits += 900, misses += 100, 200 * MIB}, 4);
+    BOOST_CHECK(info.hitRate && *info.hitRate == 0.9);
+    BOOST_CHECK_EQUAL(info.mempoolSize, 300 * MIB);
+    info = governor.Rebalance({false, hits += 900, misses += 100, 100 * MIB}, 5);
+    CheckSplit(info);
+    BOOST_CHECK_EQUAL(info.mempoolSize, 300 * MIB - STEP);
+    BOOST_CHECK_EQUAL(info.adjustments, 3U);
+
+    // ... and not below the minimum of the mempool.
+    for (int i = 0; i < 100; ++i) {
+        info = governor.Rebalance({false, hits += 900, misses += 100, 0}, 6);
+    }
+    CheckSplit(info);
+    BOOST_CHECK_EQUAL(info.mempoolSize, SHARED / 16);
+
+    // Too few lookups give no hit rate, and do not prevent a full mempool from
+    // growing.
+    info = governor.Rebalance({false, hits += 10, misses += 10, SHARED / 16}, 7);
+    BOOST_CHECK(!info.hitRate);
+    BOOST_CHECK_EQUAL(info.mempoolSize, SHARED / 16 + STEP);
+
+    // A full mempool does not grow while the hit rate is not high enough...
+    info = governor.Rebalance({false, hits += 980, misses += 20, SHARED}, 8);
+    BOOST_CHECK_EQUAL(info.mempoolSize, SHARED / 16 + STEP);
+
+    // ... but does when it is, up to its maximum.
+    for (int i = 0; i < 100; ++i) {
+        info = governor.Rebalance({false, hits += 1000, misses, SHARED}, 9);
+    }
+    CheckSplit(info);
+    BOOST_CHECK_EQUAL(info.mempoolSize, 300 * MIB);
+
+    // The counters starting over are not taken as a huge number of lookups.
+    info = governor.Rebalance({false, 10, 10, 0}, 10);
+    BOOST_CHECK(!info.hitRate);
+}
+
+BOOST_AUTO_TEST_CASE(bounds) {
+    // The mempool cannot take more than three quarters of what the LevelDB
+    // caches leave.
+    MemoryGovernor governor(BUDGET, LEVELDB_CACHE, BUDGET);
+    BOOST_CHECK_EQUAL(governor.GetMaxMempoolSize(), SHARED / 4 * 3);
+    CheckSplit(governor.GetInfo());
+
+    // A small maximum mempool size is also its minimum.
+    MemoryGovernor small(BUDGET, LEVELDB_CACHE, MIB);
+    BOOST_CHECK_EQUAL(small.GetMinMempoolSize(), MIB);
+    BOOST_CHECK_EQUAL(small.GetMaxMempoolSize(), MIB);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
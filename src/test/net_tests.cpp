@@ -704,6 +704,163 @@ BOOST_AUTO_TEST_CASE(PoissonNextSend) {
     g_mock_deterministic_tests = false;
 }
 
+BOOST_AUTO_TEST_CASE(send_class) {
+    BOOST_CHECK(GetSendClass(NetMsgType::CMPCTBLOCK) == SendClass::RELAY);
+    BOOST_CHECK(GetSendClass(NetMsgType::BLOCKTXN) == SendClass::RELAY);
+    BOOST_CHECK(GetSendClass(NetMsgType::HEADERS) == SendClass::RELAY);
+    BOOST_CHECK(GetSendClass(NetMsgType::TX) == SendClass::RELAY);
+    BOOST_CHECK(GetSendClass(NetMsgType::BLOCK) == SendClass::BLOCK);
+    BOOST_CHECK(GetSendClass(NetMsgType::INV) == SendClass::OTHER);
+    BOOST_CHECK(GetSendClass(NetMsgType::MERKLEBLOCK) == SendClass::OTHER);
+    BOOST_CHECK_EQUAL(GetSendClassName(SendClass::RELAY), "relay");
+    BOOST_CHECK_EQUAL(GetSendClassName(SendClass::BLOCK), "block");
+    BOOST_CHECK_EQUAL(GetSendClassName(SendClass::OTHER), "other");
+}
+
+BOOST_AUTO_TEST_CASE(token_bucket) {
+    constexpr uint64_t rate = 1000;
+    int64_t now = 1000000;
+    TokenBucket bucket;
+    BOOST_CHECK(!bucket.HasTokens());
+
+    // The first refill fills the bucket with one second's worth.
+    bucket.Refill(rate, now);
+    BOOST_CHECK(bucket.HasTokens());
+
+    // Taking more than available puts the bucket in debt...
+    bucket.Consume(3 * rate);
+    BOOST_CHECK(!bucket.HasTokens());
+    now += 1000000;
+    bucket.Refill(rate, now);
+    BOOST_CHECK(!bucket.HasTokens());
+
+    // ...until it has been paid off.
+    now += 1001000;
+    bucket.Refill(rate, now);
+    BOOST_CHECK(bucket.HasTokens());
+
+    // Tokens never accrue beyond one second's worth, and fractional tokens
+    // are not lost by frequent refills.
+    now += 3600 * 1000000LL;
+    bucket.Refill(rate, now);
+    bucket.Consume(rate);
+    BOOST_CHECK(!bucket.HasTokens());
+    now += 500;
+    bucket.Refill(rate, now);
+    BOOST_CHECK(!bucket.HasTokens());
+    now += 500;
+    bucket.Refill(rate, now);
+    BOOST_CHECK(bucket.HasTokens());
+}
+
+#ifndef WIN32
+BOOST_AUTO_TEST_CASE(socket_send_queued) {
+    int fds[2];
+    BOOST_REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    std::deque<std::vector<uint8_t>> queue;
+    std::vector<uint8_t> expected;
+    for (size_t i = 0; i < MAX_SEND_IOVECS + 10; ++i) {
+        queue.emplace_back(i % 7 + 4, uint8_t(i));
+    }
+    // Sending starts at the offset into the first entry, and stops after
+    // MAX_SEND_IOVECS entries.
+    const size_t offset = 3;
+    expected.insert(expected.end(), queue[0].begin() + offset, queue[0].end());
+    for (size_t i = 1; i < MAX_SEND_IOVECS; ++i) {
+        expected.insert(expected.end(), queue[i].begin(), queue[i].end());
+    }
+
+    const int nBytes = SocketSendQueued(fds[0], queue, offset);
+    BOOST_REQUIRE_EQUAL(nBytes, int(expected.size()));
+    std::vector<uint8_t> received(expected.size());
+    BOOST_REQUIRE_EQUAL(recv(fds[1], received.data(), received.size(), 0),
+                        ssize_t(received.size()));
+    BOOST_CHECK(received == expected);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(recv_buffer_pool) {
+    RecvBufferPool pool(3 * MIN_POOLED_RECV_BUFFER);
+    CSerializeData buf;
+    BOOST_CHECK(!pool.Acquire(MIN_POOLED_RECV_BUFFER, buf));
+
+    // Small buffers are not worth keeping.
+    CSerializeData small(1024);
+    pool.Release(std::move(small));
+    BOOST_CHECK_EQUAL(pool.GetIdleBytes(), 0U);
+
+    CSerializeData large;
+    large.reserve(2 * MIN_POOLED_RECV_BUFFER);
+    const size_t large_capacity = large.capacity();
+    large.resize(100);
+    pool.Release(std::move(large));
+    BOOST_CHECK_EQUAL(pool.GetIdleBytes(), large_capacity);
+
+    // A buffer that would exceed the cap is dropped.
+    CSerializeData extra;
+    extra.reserve(2 * MIN_POOLED_RECV_BUFFER);
+    pool.Release(std::move(extra));
+    BOOST_CHECK_EQUAL(pool.GetIdleBytes(), large_capacity);
+
+    // Requests larger than any idle buffer miss; smaller ones are served
+    // from a bigger class, empty and with their capacity intact.
+    BOOST_CHECK(!pool.Acquire(large_capacity + 1, buf));
+    BOOST_CHECK(pool.Acquire(MIN_POOLED_RECV_BUFFER + 1, buf));
+    BOOST_CHECK(buf.empty());
+    BOOST_CHECK_EQUAL(buf.capacity(), large_capacity);
+    BOOST_CHECK_EQUAL(pool.GetIdleBytes(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(receive_large_message) {
+    const Config &config = GetConfig();
+    const uint32_t payload_size = 4 * MIN_POOLED_RECV_BUFFER + 17;
+    std::vector<uint8_t> payload(payload_size);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = uint8_t(i * 31);
+    }
+    CMessageHeader hdr(config.GetChainParams().NetMagic(), NetMsgType::BLOCK,
+                       payload_size);
+    const uint256 hash = Hash(payload);
+    memcpy(hdr.pchChecksum, hash.begin(), CMessageHeader::CHECKSUM_SIZE);
+    CDataStream wire(SER_NETWORK, PROTOCOL_VERSION);
+    wire << hdr;
+    wire.write(CharCast(payload.data()), payload.size());
+
+    const auto receive = [&]() {
+        CNetMessage msg(config.GetChainParams().NetMagic(), SER_NETWORK,
+                        INIT_PROTO_VERSION);
+        const char *pch = wire.data();
+        uint32_t remaining = wire.size();
+        while (remaining > 0) {
+            // Feed the data in socket-sized chunks.
+            const uint32_t chunk = std::min<uint32_t>(remaining, 0x10000);
+            const int handled = msg.in_data
+                                    ? msg.readData(pch, chunk)
+                                    : msg.readHeader(config, pch, chunk);
+            BOOST_REQUIRE(handled > 0);
+            pch += handled;
+            remaining -= handled;
+        }
+        BOOST_REQUIRE(msg.complete());
+        BOOST_CHECK(msg.GetMessageHash() == hash);
+        BOOST_REQUIRE_EQUAL(msg.vRecv.size(), payload.size());
+        BOOST_CHECK(memcmp(msg.vRecv.data(), payload.data(), payload.size()) ==
+                    0);
+    };
+
+    // The first message's buffer is recycled when it is destroyed, and the
+    // next message of the same size picks it up again.
+    receive();
+    const size_t idle = GetRecvBufferPool().GetIdleBytes();
+    BOOST_CHECK(idle >= payload_size);
+    receive();
+    BOOST_CHECK_EQUAL(GetRecvBufferPool().GetIdleBytes(), idle);
+}
+
 // prior to PR #14728, this test triggers an undefined behavior
 BOOST_AUTO_TEST_CASE(ipv4_peer_with_ipv6_addrMe_test) {
     // set up local addresses; all that's necessary to reproduce the bug is
@@ -9,6 +9,7 @@
 #include <protocol.h>
 #include <serialize.h>
 #include <streams.h>
+#include <util/asmap.h>
 #include <util/bit_cast.h>
 #include <util/strencodings.h>
 #include <version.h>
@@ -315,7 +316,7 @@ BOOST_AUTO_TEST_CASE(subnet_test) {
 
 BOOST_AUTO_TEST_CASE(netbase_getgroup) {
     // use /16
-    std::vector<bool> asmap;
+    ASMap asmap;
     typedef std::vector<uint8_t> Vec8;
     // Local -> !Routable()
     BOOST_CHECK(ResolveIP("127.0.0.1").GetGroup(asmap) == Vec8{0});
@@ -467,6 +468,15 @@ BOOST_AUTO_TEST_CASE(netpermissions_test) {
         "bloom,forcerelay,noban,relay,mempool@1.2.3.4/32", whitelistPermissions,
         error));
 
+    // earlyrelay is opt-in only, it is not part of "all"
+    BOOST_CHECK(NetWhitelistPermissions::TryParse(
+        "noban,earlyrelay@1.2.3.4/32", whitelistPermissions, error));
+    BOOST_CHECK_EQUAL(whitelistPermissions.m_flags, PF_NOBAN | PF_EARLYRELAY);
+    BOOST_CHECK(NetWhitelistPermissions::TryParse("all@1.2.3.4/32",
+                                                  whitelistPermissions, error));
+    BOOST_CHECK(!NetPermissions::HasFlag(whitelistPermissions.m_flags,
+                                         PF_EARLYRELAY));
+
     const auto strings = NetPermissions::ToStrings(PF_ALL);
     BOOST_CHECK_EQUAL(strings.size(), 6U);
     BOOST_CHECK(std::find(strings.begin(), strings.end(), "bloomfilter") !=
@@ -0,0 +1,99 @@
+// Copyright (c) 2026 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <key.h>
+#include <keystore.h>
+#include <policy/policy.h>
+#include <psbt.h>
+#include <script/script_execution_context.h>
+#include <script/standard.h>
+
+#include <test/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(psbt_tests, BasicTestingSetup)
+
+namespace {
+
+constexpr size_t NUM_KEYS = 4;
+constexpr size_t NUM_INPUTS = 200;
+
+/** A PSBT spending P2PKH coins of the keys in keystore, one per input. */
+PartiallySignedTransaction MakePSBT(CBasicKeyStore &keystore) {
+    std::vector<CScript> scripts;
+    for (size_t i = 0; i < NUM_KEYS; ++i) {
+        CKey key;
+        key.MakeNewKey(true);
+        keystore.AddKey(key);
+        scripts.push_back(GetScriptForDestination(key.GetPubKey().GetID()));
+    }
+
+    CMutableTransaction mtx;
+    for (size_t i = 0; i < NUM_INPUTS; ++i) {
+        mtx.vin.emplace_back(COutPoint(TxId(InsecureRand256()), i));
+    }
+    mtx.vout.emplace_back(int64_t(NUM_INPUTS) * COIN, scripts[0]);
+
+    PartiallySignedTransaction psbt{CTransaction(mtx)};
+    for (size_t i = 0; i < NUM_INPUTS; ++i) {
+        psbt.inputs[i].utxo = CTxOut(COIN + int64_t(i) * SATOSHI, scripts[i % NUM_KEYS]);
+    }
+    return psbt;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(sign_psbt_inputs) {
+    const uint32_t flags = STANDARD_SCRIPT_VERIFY_FLAGS | SCRIPT_ENABLE_TOKENS;
+    CBasicKeyStore keystore;
+    const PartiallySignedTransaction unsigned_psbt = MakePSBT(keystore);
+
+    // Signing all inputs at once gives the same signatures as signing them one
+    // at a time, with limited contexts...
+    {
+        PartiallySignedTransaction expected = unsigned_psbt;
+        for (size_t i = 0; i < NUM_INPUTS; ++i) {
+            BOOST_CHECK(SignPSBTInput(keystore, expected, i, flags, SigHashType().withFork()));
+        }
+        PartiallySignedTransaction psbt = unsigned_psbt;
+        BOOST_CHECK(SignPSBTInputs(keystore, psbt, flags, SigHashType().withFork()));
+        for (size_t i = 0; i < NUM_INPUTS; ++i) {
+            BOOST_CHECK(!psbt.inputs[i].final_script_sig.empty());
+            BOOST_CHECK(psbt.inputs[i].final_script_sig == expected.inputs[i].final_script_sig);
+        }
+    }
+
+    // ... and with full contexts, which can sign the hash of all utxos.
+    {
+        const SigHashType sighash = SigHashType().withFork().withUtxos();
+        PartiallySignedTransaction expected = unsigned_psbt;
+        const auto expected_contexts = ScriptExecutionContext::createForAllInputs(*expected.tx, expected.inputs);
+        for (size_t i = 0; i < NUM_INPUTS; ++i) {
+            BOOST_CHECK(SignPSBTInput(keystore, expected, i, flags, sighash, expected_contexts[i]));
+        }
+        PartiallySignedTransaction psbt = unsigned_psbt;
+        const auto contexts = ScriptExecutionContext::createForAllInputs(*psbt.tx, psbt.inputs);
+        BOOST_CHECK(SignPSBTInputs(keystore, psbt, flags, sighash, contexts));
+        for (size_t i = 0; i < NUM_INPUTS; ++i) {
+            BOOST_CHECK(!psbt.inputs[i].final_script_sig.empty());
+            BOOST_CHECK(psbt.inputs[i].final_script_sig == expected.inputs[i].final_script_sig);
+        }
+    }
+
+    // An input that cannot be signed makes the PSBT incomplete, without
+    // preventing the other inputs from being signed.
+    {
+        PartiallySignedTransaction psbt = unsigned_psbt;
+        psbt.inputs[NUM_INPUTS / 2].utxo = CTxOut();
+        BOOST_CHECK(!SignPSBTInputs(keystore, psbt, flags, SigHashType().withFork()));
+        for (size_t i = 0; i < NUM_INPUTS; ++i) {
+            BOOST_CHECK_EQUAL(psbt.inputs[i].final_script_sig.empty(), i == NUM_INPUTS / 2);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -125,6 +125,60 @@ BOOST_AUTO_TEST_CASE(getlocator_test) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(findfork_test) {
+    // Build a main chain 100000 blocks long, and side branches of random
+    // lengths forking off it at random heights.
+    std::vector<CBlockIndexPtr> vBlocksMain(100000);
+    for (size_t i = 0; i < vBlocksMain.size(); i++) {
+        vBlocksMain[i] = MkCBlockIndexPtr();
+        vBlocksMain[i]->nHeight = i;
+        vBlocksMain[i]->pprev = i ? vBlocksMain[i - 1].get() : nullptr;
+        vBlocksMain[i]->BuildSkip();
+    }
+
+    CChain chain;
+    BOOST_CHECK(chain.FindFork(vBlocksMain.back().get()) == nullptr);
+    chain.SetTip(vBlocksMain.back().get());
+
+    for (int n = 0; n < 100; n++) {
+        const int fork_height = InsecureRandRange(vBlocksMain.size());
+        const int side_length = 1 + InsecureRandRange(5000);
+        std::vector<CBlockIndexPtr> vBlocksSide(side_length);
+        for (size_t i = 0; i < vBlocksSide.size(); i++) {
+            vBlocksSide[i] = MkCBlockIndexPtr();
+            vBlocksSide[i]->nHeight = fork_height + 1 + i;
+            vBlocksSide[i]->pprev = i ? vBlocksSide[i - 1].get()
+                                      : vBlocksMain[fork_height].get();
+            vBlocksSide[i]->BuildSkip();
+        }
+
+        const CBlockIndex *fork = vBlocksMain[fork_height].get();
+        for (const CBlockIndexPtr &side : vBlocksSide) {
+            BOOST_CHECK(chain.FindFork(side.get()) == fork);
+        }
+        // Blocks in the chain are their own fork point.
+        BOOST_CHECK(chain.FindFork(fork) == fork);
+
+        // Ancestor lookups agree with the skiplist, in or out of the chain.
+        const CBlockIndex *side_tip = vBlocksSide.back().get();
+        const int height = InsecureRandRange(side_tip->nHeight + 1);
+        BOOST_CHECK(chain.GetAncestor(side_tip, height) ==
+                    side_tip->GetAncestor(height));
+        BOOST_CHECK(chain.GetAncestor(fork, height) ==
+                    fork->GetAncestor(height));
+        BOOST_CHECK(chain.GetAncestor(fork, fork_height + 1) == nullptr);
+    }
+
+    // A block that does not share the chain's genesis has no fork point.
+    CBlockIndex other_genesis;
+    BOOST_CHECK(chain.FindFork(&other_genesis) == nullptr);
+    CBlockIndex other_block;
+    other_block.nHeight = 1;
+    other_block.pprev = &other_genesis;
+    other_block.BuildSkip();
+    BOOST_CHECK(chain.FindFork(&other_block) == nullptr);
+}
+
 BOOST_AUTO_TEST_CASE(findearliestatleast_test) {
     std::vector<BlockHash> vHashMain(100000);
     std::vector<CBlockIndexPtr> vBlocksMain(100000);
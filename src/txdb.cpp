@@ -47,7 +47,8 @@ struct CoinEntry {
 } // namespace
 
 CCoinsViewDB::CCoinsViewDB(size_t nCacheSize, bool fMemory, bool fWipe)
-    : db(GetDataDir() / "chainstate", nCacheSize, fMemory, fWipe, true) {}
+    : db(GetDataDir() / "chainstate", nCacheSize, fMemory, fWipe, true,
+         true /* random_access */) {}
 
 bool CCoinsViewDB::GetCoin(const COutPoint &outpoint, Coin &coin) const {
     return db.Read(CoinEntry(&outpoint), coin);
@@ -99,6 +100,12 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const BlockHash &hashBlock) {
     batch.Erase(DB_BEST_BLOCK);
     batch.Write(DB_HEAD_BLOCKS, Vector(hashBlock, old_tip));
 
+    // A flush that does not fit in one batch, as during IBD and reindex, is
+    // written without LevelDB's log and made durable by flushing the memtable
+    // at the end, which saves writing every coin twice. A crash midway still
+    // leaves a prefix of the batches on disk, which the head blocks cover.
+    bool bulk = false;
+
     for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end();) {
         if (it->second.flags & CCoinsCacheEntry::DIRTY) {
             CoinEntry entry(&it->first);
@@ -115,7 +122,8 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const BlockHash &hashBlock) {
         if (batch.SizeEstimate() > batch_size) {
             LogPrint(BCLog::COINDB, "Writing partial batch of %.2f MiB\n",
                      batch.SizeEstimate() * (1.0 / 1048576.0));
-            db.WriteBatch(batch);
+            bulk = true;
+            db.WriteBatchUnlogged(batch);
             batch.Clear();
             if (crash_simulate) {
                 static FastRandomContext rng;
@@ -133,7 +141,8 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const BlockHash &hashBlock) {
 
     LogPrint(BCLog::COINDB, "Writing final batch of %.2f MiB\n",
              batch.SizeEstimate() * (1.0 / 1048576.0));
-    bool ret = db.WriteBatch(batch);
+    bool ret = bulk ? db.WriteBatchUnlogged(batch) && db.Flush()
+                    : db.WriteBatch(batch);
     LogPrint(BCLog::COINDB,
              "Committed %u changed transaction outputs (out of "
              "%u) to coin database...\n",
@@ -254,6 +263,17 @@ bool CBlockTreeDB::ReadFlag(const std::string &name, bool &fValue) {
     return true;
 }
 
+CBlockIndexHeaderFields
+CBlockTreeDB::ReadHeaderFields(const BlockHash &hash) const {
+    CDiskBlockIndex diskindex;
+    if (!Read(std::make_pair(DB_BLOCK_INDEX, hash), diskindex)) {
+        throw dbwrapper_error(strprintf(
+            "Block index entry %s is missing from the database",
+            hash.ToString()));
+    }
+    return {diskindex.nVersion, diskindex.hashMerkleRoot, diskindex.nNonce};
+}
+
 bool CBlockTreeDB::LoadBlockIndexGuts(
     const Consensus::Params &params,
     std::function<CBlockIndex *(const BlockHash &)> insertBlockIndex) {
@@ -281,11 +301,11 @@ bool CBlockTreeDB::LoadBlockIndexGuts(
         pindexNew->nFile = diskindex.nFile;
         pindexNew->nDataPos = diskindex.nDataPos;
         pindexNew->nUndoPos = diskindex.nUndoPos;
-        pindexNew->nVersion = diskindex.nVersion;
-        pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
+        pindexNew->SetHeaderFields({diskindex.nVersion,
+                                    diskindex.hashMerkleRoot,
+                                    diskindex.nNonce});
         pindexNew->nTime = diskindex.nTime;
         pindexNew->nBits = diskindex.nBits;
-        pindexNew->nNonce = diskindex.nNonce;
         pindexNew->nStatus = diskindex.nStatus;
         pindexNew->nTx = diskindex.nTx;
 
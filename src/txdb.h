@@ -20,6 +20,7 @@
 
 struct BlockHash;
 class CBlockIndex;
+struct CBlockIndexHeaderFields;
 class CCoinsViewDBCursor;
 
 namespace Consensus {
@@ -66,6 +67,8 @@ public:
     //! Returns whether an error occurred.
     bool Upgrade();
     size_t EstimateSize() const override;
+
+    const CDBWrapper &GetDB() const { return db; }
 };
 
 /** Specialization of CCoinsViewCursor to iterate over a CCoinsViewDB */
@@ -107,4 +110,6 @@ public:
     bool LoadBlockIndexGuts(
         const Consensus::Params &params,
         std::function<CBlockIndex *(const BlockHash &)> insertBlockIndex);
+    //! Read the header fields of a block index entry evicted from memory.
+    CBlockIndexHeaderFields ReadHeaderFields(const BlockHash &hash) const;
 };
@@ -587,6 +587,18 @@ const CTransaction *CTxMemPool::GetConflictTx(const COutPoint &prevout) const {
     return it == mapNextTx.end() ? nullptr : it->second;
 }
 
+std::vector<std::pair<COutPoint, const CTransaction *>>
+CTxMemPool::GetConflicts(const CTransaction &tx) const {
+    std::vector<std::pair<COutPoint, const CTransaction *>> conflicts;
+    for (const CTxIn &txin : tx.vin) {
+        const auto it = mapNextTx.find(txin.prevout);
+        if (it != mapNextTx.end()) {
+            conflicts.emplace_back(txin.prevout, it->second);
+        }
+    }
+    return conflicts;
+}
+
 std::optional<CTxMemPool::txiter>
 CTxMemPool::GetIter(const TxId &txid) const {
     std::optional<CTxMemPool::txiter> ret;
@@ -559,6 +559,14 @@ public:
     const CTransaction *GetConflictTx(const COutPoint &prevout) const
         EXCLUSIVE_LOCKS_REQUIRED(cs);
 
+    /**
+     * Get every input of tx that is already spent by a transaction in the
+     * pool, paired with that transaction, in input order. Empty if tx does not
+     * conflict with the pool.
+     */
+    std::vector<std::pair<COutPoint, const CTransaction *>>
+    GetConflicts(const CTransaction &tx) const EXCLUSIVE_LOCKS_REQUIRED(cs);
+
     /** Returns an iterator to the given txid, if found */
     std::optional<txiter> GetIter(const TxId &txid) const
         EXCLUSIVE_LOCKS_REQUIRED(cs);
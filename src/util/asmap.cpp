@@ -3,9 +3,12 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <util/asmap.h>
+
 #include <crypto/common.h>
 #include <span.h>
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <map>
@@ -184,3 +187,104 @@ bool SanityCheckASMap(const std::vector<bool> &asmap, uint32_t bits) {
     }
     return false; // Reached EOF without RETURN instruction
 }
+
+namespace {
+
+using IP128 = std::pair<uint64_t, uint64_t>;
+
+/** Set bit `bit` (0 is the most significant) of a 128-bit address. */
+void SetBit(IP128 &ip, uint32_t bit) {
+    if (bit < 64) {
+        ip.first |= uint64_t(1) << (63 - bit);
+    } else {
+        ip.second |= uint64_t(1) << (127 - bit);
+    }
+}
+
+/**
+ * Walks every path through the asmap bytecode, emitting one range per
+ * RETURN and per MATCH mismatch. Each range covers all addresses with a given
+ * prefix, so the ranges are disjoint and, for a sane asmap, cover the whole
+ * address space.
+ */
+class ASMapCompiler {
+    const std::vector<bool>::const_iterator m_begin, m_end;
+
+public:
+    //! Range start and ASN, in the order they were found.
+    std::vector<std::pair<IP128, uint32_t>> ranges;
+
+    explicit ASMapCompiler(const std::vector<bool> &asmap) : m_begin(asmap.begin()), m_end(asmap.end()) {}
+
+    void Run(std::vector<bool>::const_iterator pos, IP128 prefix, uint32_t prefix_len, uint32_t default_asn) {
+        while (pos != m_end) {
+            const Instruction opcode = DecodeType(pos, m_end);
+            if (opcode == Instruction::RETURN) {
+                const uint32_t asn = DecodeASN(pos, m_end);
+                if (asn == INVALID) return;
+                ranges.emplace_back(prefix, asn);
+                return;
+            } else if (opcode == Instruction::JUMP) {
+                const uint32_t jump = DecodeJump(pos, m_end);
+                if (jump == INVALID || prefix_len == 128) return;
+                if (static_cast<int64_t>(jump) >= static_cast<int64_t>(m_end - pos)) return;
+                // Follow the jump for a 1 bit, then fall through for a 0 bit.
+                IP128 one = prefix;
+                SetBit(one, prefix_len);
+                Run(pos + jump, one, prefix_len + 1, default_asn);
+                ++prefix_len;
+            } else if (opcode == Instruction::MATCH) {
+                const uint32_t match = DecodeMatch(pos, m_end);
+                if (match == INVALID) return;
+                const uint32_t matchlen = CountBits(match) - 1;
+                if (prefix_len + matchlen > 128) return;
+                for (uint32_t bit = 0; bit < matchlen; bit++) {
+                    // Addresses that differ from the match at this bit get
+                    // the default ASN.
+                    IP128 mismatch = prefix;
+                    if ((match >> (matchlen - 1 - bit)) & 1) {
+                        SetBit(prefix, prefix_len);
+                    } else {
+                        SetBit(mismatch, prefix_len);
+                    }
+                    ranges.emplace_back(mismatch, default_asn);
+                    ++prefix_len;
+                }
+            } else if (opcode == Instruction::DEFAULT) {
+                default_asn = DecodeASN(pos, m_end);
+                if (default_asn == INVALID) return;
+            } else {
+                return;
+            }
+        }
+    }
+};
+
+} // namespace
+
+ASMap::ASMap(std::vector<bool> bits) : m_bits(std::move(bits)) {
+    if (m_bits.empty()) {
+        return;
+    }
+    ASMapCompiler compiler(m_bits);
+    compiler.Run(m_bits.begin(), {0, 0}, 0, 0);
+    std::sort(compiler.ranges.begin(), compiler.ranges.end());
+
+    // Merge adjacent ranges that map to the same ASN.
+    for (const auto &[start, asn] : compiler.ranges) {
+        if (m_range_asns.empty() || m_range_asns.back() != asn) {
+            m_range_starts.push_back(start);
+            m_range_asns.push_back(asn);
+        }
+    }
+    m_range_starts.shrink_to_fit();
+    m_range_asns.shrink_to_fit();
+}
+
+uint32_t ASMap::Lookup(uint64_t ip_high, uint64_t ip_low) const {
+    const auto it = std::upper_bound(m_range_starts.begin(), m_range_starts.end(), IP128{ip_high, ip_low});
+    if (it == m_range_starts.begin()) {
+        return 0; // Only for an empty or insane asmap
+    }
+    return m_range_asns[it - m_range_starts.begin() - 1];
+}
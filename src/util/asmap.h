@@ -5,9 +5,39 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <utility>
 #include <vector>
 
 uint32_t Interpret(const std::vector<bool> &asmap, const std::vector<bool> &ip);
 
 bool SanityCheckASMap(const std::vector<bool> &asmap, uint32_t bits);
+
+/**
+ * An asmap, compiled when it is loaded into a sorted table of the address
+ * ranges it maps, so that a lookup is a binary search instead of a run of the
+ * asmap bytecode bit by bit. Lookup() returns the same ASN as Interpret() on
+ * the source asmap.
+ */
+class ASMap {
+    std::vector<bool> m_bits;
+    //! First address of each range, as the big-endian high and low halves of
+    //! the 128-bit address, in ascending order.
+    std::vector<std::pair<uint64_t, uint64_t>> m_range_starts;
+    //! ASN of each range.
+    std::vector<uint32_t> m_range_asns;
+
+public:
+    ASMap() = default;
+    //! The asmap must pass SanityCheckASMap(bits, 128).
+    explicit ASMap(std::vector<bool> bits);
+
+    //! The source asmap.
+    const std::vector<bool> &GetBits() const { return m_bits; }
+    bool empty() const { return m_bits.empty(); }
+    size_t RangeCount() const { return m_range_asns.size(); }
+
+    //! The ASN of a 128-bit address, given as its big-endian high and low halves.
+    uint32_t Lookup(uint64_t ip_high, uint64_t ip_low) const;
+};
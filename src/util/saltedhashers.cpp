@@ -7,6 +7,8 @@
 
 #include <random.h>
 
+#include <algorithm>
+
 SaltedHasherBase::SaltedHasherBase() noexcept
     : m_k0(GetRand64()), m_k1(GetRand64())
 {}
@@ -14,3 +16,50 @@ SaltedHasherBase::SaltedHasherBase() noexcept
 size_t ByteVectorHash::operator()(const std::vector<uint8_t> &input) const noexcept {
     return static_cast<size_t>(CSipHasher(k0(), k1()).Write(input.data(), input.size()).Finalize());
 }
+
+size_t SaltedScriptHasher::operator()(const CScript &script) const noexcept {
+    return static_cast<size_t>(CSipHasher(k0(), k1()).Write(script.data(), script.size()).Finalize());
+}
+
+void SaltedUint256Hasher::HashBatch(const uint256 *const *vals, size_t n, size_t *out) const noexcept {
+    uint64_t hashes[4];
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        SipHashUint256_4way(k0(), k1(), vals + i, hashes);
+        std::copy(std::begin(hashes), std::end(hashes), out + i);
+    }
+    for (; i < n; ++i) {
+        out[i] = (*this)(*vals[i]);
+    }
+}
+
+void SaltedTxIdHasher::HashBatch(const TxId *const *txids, size_t n, size_t *out) const noexcept {
+    uint64_t hashes[4];
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const uint256 *const vals[4] = {txids[i], txids[i + 1], txids[i + 2], txids[i + 3]};
+        SipHashUint256_4way(k0(), k1(), vals, hashes);
+        std::copy(std::begin(hashes), std::end(hashes), out + i);
+    }
+    for (; i < n; ++i) {
+        out[i] = (*this)(*txids[i]);
+    }
+}
+
+void SaltedOutpointHasher::HashBatch(const COutPoint *const *outpoints, size_t n, size_t *out) const noexcept {
+    uint64_t hashes[4];
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const uint256 *vals[4];
+        uint32_t extras[4];
+        for (size_t j = 0; j < 4; ++j) {
+            vals[j] = &outpoints[i + j]->GetTxId();
+            extras[j] = outpoints[i + j]->GetN();
+        }
+        SipHashUint256Extra_4way(k0(), k1(), vals, extras, hashes);
+        std::copy(std::begin(hashes), std::end(hashes), out + i);
+    }
+    for (; i < n; ++i) {
+        out[i] = (*this)(*outpoints[i]);
+    }
+}
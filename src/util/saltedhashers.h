@@ -30,11 +30,15 @@ struct SaltedUint256Hasher : SaltedHasherBase {
     size_t operator()(const uint256 &u) const noexcept {
         return static_cast<size_t>(SipHashUint256(k0(), k1(), u));
     }
+    /// Hash n values at once, setting out[i] to (*this)(*vals[i]); faster than one at a time for n >= 4
+    void HashBatch(const uint256 *const *vals, size_t n, size_t *out) const noexcept;
 };
 
 struct SaltedTxIdHasher : protected SaltedUint256Hasher {
     SaltedTxIdHasher() noexcept {} // circumvent some libstdc++-11 bugs on Debian unstable
     size_t operator()(const TxId &u) const noexcept { return SaltedUint256Hasher::operator()(u); }
+    /// Hash n values at once, setting out[i] to (*this)(*txids[i]); faster than one at a time for n >= 4
+    void HashBatch(const TxId *const *txids, size_t n, size_t *out) const noexcept;
 };
 
 struct SaltedOutpointHasher : SaltedHasherBase {
@@ -42,6 +46,8 @@ struct SaltedOutpointHasher : SaltedHasherBase {
     size_t operator()(const COutPoint &o) const noexcept {
         return static_cast<size_t>(SipHashUint256Extra(k0(), k1(), o.GetTxId(), o.GetN()));
     }
+    /// Hash n values at once, setting out[i] to (*this)(*outpoints[i]); faster than one at a time for n >= 4
+    void HashBatch(const COutPoint *const *outpoints, size_t n, size_t *out) const noexcept;
 };
 
 /// @class StdHashWrapper
@@ -68,3 +74,8 @@ struct ByteVectorHash : SaltedHasherBase {
     ByteVectorHash() noexcept {} // circumvent some libstdc++-11 bugs on Debian unstable
     size_t operator()(const std::vector<uint8_t> &input) const noexcept;
 };
+
+struct SaltedScriptHasher : SaltedHasherBase {
+    SaltedScriptHasher() noexcept {} // circumvent some libstdc++-11 bugs on Debian unstable
+    size_t operator()(const CScript &script) const noexcept;
+};
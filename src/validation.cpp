@@ -60,6 +60,7 @@
 #include <limits>
 #include <list>
 #include <optional>
+#include <set>
 #include <string>
 #include <thread>
 #include <utility>
@@ -269,6 +270,7 @@ bool fIsBareMultisigStd = DEFAULT_PERMIT_BAREMULTISIG;
 bool fRequireStandard = true;
 bool fCheckBlockIndex = false;
 bool fCheckBlockReads = false;
+bool fLazyBlockIndex = DEFAULT_LAZY_BLOCK_INDEX;
 bool fCheckpointsEnabled = DEFAULT_CHECKPOINTS_ENABLED;
 size_t nCoinCacheUsage = 5000 * 300;
 uint64_t nPruneTarget = 0;
@@ -320,6 +322,12 @@ std::set<const CBlockIndex *> setDirtyBlockIndex;
 
 /** Dirty block file entries. */
 std::set<int> setDirtyFileInfo;
+
+/**
+ * Highest active chain block whose header fields were evicted by
+ * EvictBlockIndexHeaderFields(), with all of its ancestors.
+ */
+const CBlockIndex *pindexHeaderFieldsEvicted = nullptr;
 } // namespace
 
 BlockValidationOptions::BlockValidationOptions(const Config &config)
@@ -449,7 +457,7 @@ bool CheckSequenceLocks(const CTxMemPool &pool, const CTransaction &tx,
                     maxInputHeight = std::max(maxInputHeight, height);
                 }
             }
-            lp->maxInputBlock = tip->GetAncestor(maxInputHeight);
+            lp->maxInputBlock = ::ChainActive()[maxInputHeight];
         }
     }
     return EvaluateSequenceLocks(index, lockPair);
@@ -504,6 +512,79 @@ static bool CheckInputsFromMempoolAndCache(
     return CheckInputs(tx, state, view, true, flags, cacheSigStore, true, txdata, nSigChecksOut);
 }
 
+/**
+ * Create double spend proofs for the mempool transactions that tx conflicts
+ * with, trying each conflicting input until every such transaction has a
+ * proof. Runs from the validation interface queue, so that the transaction
+ * that triggered it does not wait for it; the mempool is consulted afresh.
+ */
+static void CreateDoubleSpendProofs(CTxMemPool &pool, const CTransactionRef &ptx) LOCKS_EXCLUDED(cs_main) {
+    struct Candidate {
+        DoubleSpendProof proof;
+        DoubleSpendProof::SignatureCheck check;
+    };
+    std::vector<Candidate> candidates;
+    {
+        LOCK2(cs_main, pool.cs);
+        const CCoinsViewMemPool viewMemPool(pcoinsTip.get(), pool); // always sees mempool-spent
+        std::set<TxId> covered;
+        for (const auto &[prevout, txConflicting] : pool.GetConflicts(*ptx)) {
+            const auto txidConflicting = txConflicting->GetId();
+            const auto entryIt = pool.mapTx.find(txidConflicting);
+            if (entryIt->HasDsp() || covered.count(txidConflicting)) {
+                // a mempool tx holds at most one proof
+                continue;
+            }
+            try {
+                LogPrint(BCLog::DSPROOF, "Creating double spend proof (mempool tx: %s; doublespend tx: %s; outpoint: %s)\n",
+                         txidConflicting.ToString(), ptx->GetId().ToString(), prevout.ToString());
+
+                Coin coin;
+                if (!viewMemPool.GetCoin(prevout, coin))
+                    throw std::runtime_error(strprintf("Could not find coin: %s", prevout.ToString()));
+
+                Candidate candidate{DoubleSpendProof::create(*txConflicting, *ptx, prevout, &coin.GetTxOut()),
+                                    DoubleSpendProof::SignatureCheck()};
+                if (candidate.proof.prepareValidation(pool, candidate.check, entryIt->GetSharedTx()) != DoubleSpendProof::Valid)
+                    throw std::runtime_error("Proof is not valid (doublespend tx may be bad)");
+
+                candidates.push_back(std::move(candidate));
+                covered.insert(txidConflicting);
+            } catch (const std::exception &e) {
+                // We don't support 100% of the types of transactions yet, failures are possible.
+                LogPrint(BCLog::DSPROOF, "DSProof create failed: %s\n", e.what());
+            }
+        }
+    }
+
+    // Verify the whole batch without holding the locks. The results are
+    // cached, so validating again below only redoes the mempool lookups.
+    std::vector<std::pair<CTransactionRef, DspId>> added;
+    for (const auto &candidate : candidates) {
+        if (candidate.proof.verifySignatures(candidate.check) != DoubleSpendProof::Valid) {
+            LogPrint(BCLog::DSPROOF, "DSProof create failed: Proof is not valid (doublespend tx may be bad)\n");
+            continue;
+        }
+        LOCK2(cs_main, pool.cs);
+        // the mempool may have changed in the meantime
+        if (candidate.proof.validate(pool) != DoubleSpendProof::Valid)
+            continue;
+        const auto txRef = pool.addDoubleSpendProof(candidate.proof);
+        if (!txRef) {
+            LogPrint(BCLog::DSPROOF, "DSProof add failed: %s\n", candidate.proof.GetId().ToString());
+            continue;
+        }
+        LogPrint(BCLog::DSPROOF, "  DSProof created: %s (outpoint: %s)\n", candidate.proof.GetId().ToString(),
+                 candidate.proof.outPoint().ToString());
+        added.emplace_back(txRef, candidate.proof.GetId());
+    }
+
+    // inform other subsystems via signal
+    for (const auto &[txRef, dspId] : added) {
+        GetMainSignals().TransactionDoubleSpent(txRef, dspId);
+    }
+}
+
 static bool
 AcceptToMemoryPoolWorker(const Config &config, CTxMemPool &pool,
                          CValidationState &state, const CTransactionRef &ptx,
@@ -564,54 +645,27 @@ AcceptToMemoryPoolWorker(const Config &config, CTxMemPool &pool,
     std::list<std::pair<DspId, NodeId>> rescuedDSPOrphans; //! always empty in test_accept mode
 
     // Check for conflicts with in-memory transactions
-    for (const CTxIn &txin : tx.vin) {
-        if (!test_accept && DoubleSpendProof::IsEnabled()) {
+    if (const auto conflicts = pool.GetConflicts(tx); !conflicts.empty()) {
+        // double-spend detected
+        if (!test_accept && DoubleSpendProof::IsEnabled()
+                && std::any_of(conflicts.begin(), conflicts.end(), [&pool](const auto &conflict) {
+                       return !pool.mapTx.find(conflict.second->GetId())->HasDsp();
+                   })) {
+            // if no DS proof exists, we make one -- off the critical path
+            LogPrint(BCLog::DSPROOF, "Double spend found, queueing double spend proof creation (%u conflicting inputs; doublespend tx: %s)\n",
+                     conflicts.size(), txid.ToString());
+            CallFunctionInValidationInterfaceQueue([&pool, ptx] { CreateDoubleSpendProofs(pool, ptx); });
+        }
+
+        return state.Invalid(false, REJECT_DUPLICATE, "txn-mempool-conflict");
+    }
+
+    if (!test_accept && DoubleSpendProof::IsEnabled()) {
+        for (const CTxIn &txin : tx.vin) {
             // add existing DSProof orphans (if any) to the rescued set
             rescuedDSPOrphans.splice(rescuedDSPOrphans.end(),
                                      pool.doubleSpendProofStorage()->findOrphans(txin.prevout));
         }
-        auto itConflicting = pool.mapNextTx.find(txin.prevout);
-        if (itConflicting != pool.mapNextTx.end()) {
-            // double-spend detected
-            if (!test_accept && DoubleSpendProof::IsEnabled()) {
-                const auto txidConflicting = itConflicting->second->GetId();
-                const auto entryIt = pool.mapTx.find(txidConflicting);
-                if (!entryIt->HasDsp()) {
-                    // if no DS proof exists, we make one
-                    try {
-                        LogPrint(BCLog::DSPROOF, "Double spend found, creating double spend proof (mempool tx: %s; doublespend tx: %s)\n",
-                                 txidConflicting.ToString(), txid.ToString());
-
-                        const CCoinsViewMemPool viewMemPool(pcoinsTip.get(), pool); // always sees mempool-spent
-                        Coin coin;
-                        if (!viewMemPool.GetCoin(txin.prevout, coin))
-                            throw std::runtime_error(strprintf("Could not find coin: %s", txin.prevout.ToString()));
-
-                        const auto proof = DoubleSpendProof::create(*itConflicting->second, tx, txin.prevout, &coin.GetTxOut());
-
-                        if (proof.validate(pool, entryIt->GetSharedTx()) != DoubleSpendProof::Valid)
-                            throw std::runtime_error("Proof is not valid (doublespend tx may be bad)");
-
-                        const auto txRef = pool.addDoubleSpendProof(proof, entryIt);
-                        if (!txRef)
-                            throw std::runtime_error("Failed to add proof to mempool store");
-
-                        const auto &proofHash = proof.GetId();
-                        LogPrint(BCLog::DSPROOF, "  DSProof created: %s (outpoint: %s)\n", proofHash.ToString(), proof.outPoint().ToString());
-
-                        // inform caller & other subsystems via signal
-                        state.SetDspId(proofHash);
-                        GetMainSignals().TransactionDoubleSpent(txRef, proofHash);
-
-                    } catch (const std::exception &e) {
-                        // We don't support 100% of the types of transactions yet, failures are possible.
-                        LogPrint(BCLog::DSPROOF, "DSProof create & add failed: %s\n", e.what());
-                    }
-                }
-            }
-
-            return state.Invalid(false, REJECT_DUPLICATE, "txn-mempool-conflict");
-        }
     }
 
     {
@@ -1718,12 +1772,54 @@ static bool WriteUndoDataForBlock(const CBlockUndo &blockundo,
 
 static CCheckQueue<CScriptCheck> scriptcheckqueue(128);
 
+/**
+ * Closure running the context-free CheckRegularTransaction() over a contiguous
+ * range of a block's transactions. Used by CheckBlock() to spread the checks
+ * of large blocks across the tx-check worker threads.
+ * Note that this stores pointers into the block's vtx.
+ */
+class CTxCheck {
+private:
+    const CTransactionRef *begin{};
+    const CTransactionRef *end{};
+
+public:
+    CTxCheck() = default;
+
+    CTxCheck(const CTransactionRef *beginIn, const CTransactionRef *endIn)
+        : begin(beginIn), end(endIn) {}
+
+    bool operator()() {
+        for (const CTransactionRef *it = begin; it != end; ++it) {
+            CValidationState state;
+            if (!CheckRegularTransaction(**it, state)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void swap(CTxCheck &check) {
+        std::swap(begin, check.begin);
+        std::swap(end, check.end);
+    }
+};
+
+static CCheckQueue<CTxCheck> txcheckqueue(16);
+
+//! Blocks with fewer transactions than this are checked serially in CheckBlock
+static constexpr size_t PARALLEL_TXCHECK_MIN_BLOCK_TXS = 1024;
+//! Number of transactions covered by one CTxCheck work unit
+static constexpr size_t TXCHECK_CHUNK_SIZE = 64;
+
 void StartScriptCheckWorkerThreads(int threads_num) {
     scriptcheckqueue.StartWorkerThreads(threads_num);
+    txcheckqueue.StartWorkerThreads(threads_num, "txcheck");
 }
 
 void StopScriptCheckWorkerThreads() {
     scriptcheckqueue.StopWorkerThreads();
+    txcheckqueue.StopWorkerThreads();
 }
 
 int32_t ComputeBlockVersion(const CBlockIndex *pindexPrev,
@@ -2197,6 +2293,40 @@ bool CChainState::ConnectBlock(const CBlock &block, CValidationState &state,
     return true;
 }
 
+/**
+ * With -lazyblockindex, evict the header fields of the active chain's blocks
+ * that are at least LAZY_BLOCK_INDEX_MIN_DEPTH deep. Only called right after
+ * the dirty block index entries were written, so that all evicted entries can
+ * be read back from the block tree database.
+ */
+static void EvictBlockIndexHeaderFields() EXCLUSIVE_LOCKS_REQUIRED(cs_main) {
+    if (!fLazyBlockIndex) {
+        return;
+    }
+
+    const CChain &chain = ::ChainActive();
+    const int evict_height = chain.Height() - LAZY_BLOCK_INDEX_MIN_DEPTH;
+    // Carry on from the previous run, or from its fork point with the active
+    // chain after a reorg. Entries evicted off the active chain stay evicted.
+    const CBlockIndex *pindexLast =
+        pindexHeaderFieldsEvicted ? chain.FindFork(pindexHeaderFieldsEvicted)
+                                  : nullptr;
+    int height = pindexLast ? pindexLast->nHeight + 1 : 0;
+    if (height > evict_height) {
+        return;
+    }
+
+    size_t evicted = 0;
+    for (; height <= evict_height; ++height) {
+        evicted += chain[height]->EvictHeaderFields();
+    }
+    pindexHeaderFieldsEvicted = chain[evict_height];
+    LogPrint(BCLog::BENCH,
+             "Evicted header fields of %u block index entries up to "
+             "height %d\n",
+             evicted, evict_height);
+}
+
 /**
  * Update the on-disk chain state.
  * The caches and indexes are flushed depending on the mode we're called with if
@@ -2308,6 +2438,7 @@ static bool FlushStateToDisk(const CChainParams &chainparams,
                         return AbortNode(
                             state, "Failed to write to block index database");
                     }
+                    EvictBlockIndexHeaderFields();
                 }
 
                 // Finally remove any pruned files
@@ -2385,7 +2516,7 @@ static void UpdateTip(const CChainParams &params, CBlockIndex *pindexNew) {
     LogPrintf("%s: new best=%s height=%d version=0x%08x log2_work=%.8g tx=%ld "
               "date='%s' progress=%f cache=%.1fMiB(%utxo)\n",
               __func__, pindexNew->GetBlockHash().ToString(),
-              pindexNew->nHeight, pindexNew->nVersion,
+              pindexNew->nHeight, pindexNew->GetHeaderFields().nVersion,
               log(pindexNew->nChainWork.getdouble()) / log(2.0),
               pindexNew->GetChainTxCount(),
               FormatISO8601DateTime(pindexNew->GetBlockTime()),
@@ -3862,7 +3993,22 @@ bool CheckBlock(const CBlock &block, CValidationState &state,
 
     // Check transactions for regularity, skipping the first. Note that this
     // is the first time we check that all after the first are !IsCoinBase.
-    for (size_t i = 1; i < block.vtx.size(); i++) {
+    // For large blocks the checks are first spread over the tx-check worker
+    // threads. Only if that fails do we run the serial loop below, so that
+    // the reported failure is always the one of the first bad transaction.
+    bool fTxChecksOk = false;
+    if (block.vtx.size() >= PARALLEL_TXCHECK_MIN_BLOCK_TXS) {
+        CCheckQueueControl<CTxCheck> control(&txcheckqueue);
+        std::vector<CTxCheck> vChecks;
+        vChecks.reserve(block.vtx.size() / TXCHECK_CHUNK_SIZE + 1);
+        const CTransactionRef *const vtxEnd = block.vtx.data() + block.vtx.size();
+        for (const CTransactionRef *it = block.vtx.data() + 1; it < vtxEnd; it += TXCHECK_CHUNK_SIZE) {
+            vChecks.emplace_back(it, std::min(it + TXCHECK_CHUNK_SIZE, vtxEnd));
+        }
+        control.Add(vChecks);
+        fTxChecksOk = control.Wait();
+    }
+    for (size_t i = 1; !fTxChecksOk && i < block.vtx.size(); i++) {
         auto *tx = block.vtx[i].get();
         if (!CheckRegularTransaction(*tx, state)) {
             return state.Invalid(
@@ -4792,7 +4938,8 @@ bool CChainState::LoadBlockIndex(const Config &config,
     for (const std::pair<const BlockHash, CBlockIndex *> &item : mapBlockIndex) {
         CBlockIndex *pindex = item.second;
         // Check sanity that we actually loaded all referenced hashes (detects leveldb corruption)
-        if (pindex->nHeight == 0 && pindex->hashMerkleRoot.IsNull()) {
+        if (pindex->nHeight == 0 &&
+            pindex->GetHeaderFields().hashMerkleRoot.IsNull()) {
             // oops! this block index was never loaded from the disk db! Corruption likely. See BCHN issue #244.
             return error("%s: block hash %s is missing from the block database", __func__, item.first.ToString());
         }
@@ -5277,6 +5424,7 @@ void UnloadBlockIndex() {
     nLastBlockFile = 0;
     setDirtyBlockIndex.clear();
     setDirtyFileInfo.clear();
+    pindexHeaderFieldsEvicted = nullptr;
 
     for (const BlockMap::value_type &entry : mapBlockIndex) {
         delete entry.second;
@@ -5289,6 +5437,11 @@ void UnloadBlockIndex() {
 }
 
 bool LoadBlockIndex(const Config &config) {
+    // Block index header fields evicted with -lazyblockindex are read back
+    // from here.
+    CBlockIndex::SetHeaderFieldsLoader(
+        [](const BlockHash &hash) { return pblocktree->ReadHeaderFields(hash); });
+
     // Load block index from databases
     bool needs_init = fReindex;
     if (!fReindex) {
@@ -156,6 +156,14 @@ static constexpr unsigned int DEFAULT_BANSCORE_THRESHOLD = 100;
 
 /** Default for -persistmempool */
 static constexpr bool DEFAULT_PERSIST_MEMPOOL = true;
+/** Default for -lazyblockindex */
+static constexpr bool DEFAULT_LAZY_BLOCK_INDEX = false;
+/**
+ * With -lazyblockindex, blocks at least this deep in the active chain keep
+ * only the block index fields used for chain selection in memory. This is far
+ * below the finalization depth, so their other header fields are seldom read.
+ */
+static constexpr int LAZY_BLOCK_INDEX_MIN_DEPTH = 2016;
 /** Default for using fee filter */
 static constexpr bool DEFAULT_FEEFILTER = true;
 
@@ -205,6 +213,7 @@ extern bool fIsBareMultisigStd;
 extern bool fRequireStandard;
 extern bool fCheckBlockIndex;
 extern bool fCheckBlockReads;
+extern bool fLazyBlockIndex;
 extern bool fCheckpointsEnabled;
 extern size_t nCoinCacheUsage;
 
@@ -390,7 +399,10 @@ bool LoadChainTip(const Config &config) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
  */
 void UnloadBlockIndex();
 
-/** Run instances of script checking worker threads */
+/**
+ * Run instances of script checking worker threads. The same number of threads
+ * is also started for the context-free transaction checks of CheckBlock().
+ */
 void StartScriptCheckWorkerThreads(int threads_num);
 /** Stop all of the script checking worker threads */
 void StopScriptCheckWorkerThreads();
@@ -570,6 +570,49 @@ BOOST_FIXTURE_TEST_CASE(wallet_disableprivkeys, TestChain100Setup) {
     BOOST_CHECK(!wallet->GetKeyFromPool(pubkey, false));
 }
 
+BOOST_AUTO_TEST_CASE(wallet_topup_hd_keypool) {
+    auto chain = interfaces::MakeChain();
+    CWallet wallet(Params(), *chain, WalletLocation(),
+                   WalletDatabase::CreateDummy());
+    LOCK(wallet.cs_wallet);
+    wallet.SetMinVersion(FEATURE_LATEST);
+    wallet.SetHDSeed(wallet.GenerateNewSeed());
+
+    // Expected keys at m/0'/0'/i'
+    const uint32_t hardened = 0x80000000;
+    CKey seed;
+    BOOST_CHECK(wallet.GetKey(wallet.GetHDChain().seed_id, seed));
+    CExtKey masterKey, accountKey, chainKey;
+    masterKey.SetSeed(seed.begin(), seed.size());
+    masterKey.Derive(accountKey, hardened);
+    accountKey.Derive(chainKey, hardened);
+    std::vector<CKeyID> expected;
+    for (uint32_t i = 0; i < 301; ++i) {
+        CExtKey childKey;
+        chainKey.Derive(childKey, i | hardened);
+        expected.push_back(childKey.key.GetPubKey().GetID());
+    }
+
+    // A key already known to the wallet is skipped, and the pool is filled
+    // from the next index on.
+    CExtKey knownKey;
+    chainKey.Derive(knownKey, 100 | hardened);
+    AddKey(wallet, knownKey.key);
+
+    // Enough keys to be derived over several threads
+    BOOST_CHECK(wallet.TopUpKeyPool(300));
+    BOOST_CHECK_EQUAL(wallet.KeypoolCountExternalKeys(), 300U);
+    BOOST_CHECK_EQUAL(wallet.GetHDChain().nExternalChainCounter, 301U);
+    BOOST_CHECK_EQUAL(wallet.GetHDChain().nInternalChainCounter, 300U);
+    for (uint32_t i = 0; i < expected.size(); ++i) {
+        BOOST_CHECK(wallet.HaveKey(expected[i]));
+        if (i != 100) {
+            BOOST_CHECK_EQUAL(wallet.mapKeyMetadata[expected[i]].hdKeypath,
+                              strprintf("m/0'/0'/%d'", i));
+        }
+    }
+}
+
 // Explicit calculation which is used to test the wallet constant
 static size_t CalculateP2PKHInputSize(bool use_max_sig) {
     // Generate ephemeral valid pubkey
@@ -42,6 +42,7 @@
 #include <cassert>
 #include <future>
 #include <optional>
+#include <thread>
 
 static RecursiveMutex cs_wallets;
 static std::vector<std::shared_ptr<CWallet>> vpwallets GUARDED_BY(cs_wallets);
@@ -244,8 +245,7 @@ CPubKey CWallet::GenerateNewKey(WalletBatch &batch, bool internal) {
     return pubkey;
 }
 
-void CWallet::DeriveNewChildKey(WalletBatch &batch, CKeyMetadata &metadata,
-                                CKey &secret, bool internal) {
+CExtKey CWallet::DeriveChainKey(bool internal) {
     // for now we use a fixed keypath scheme of m/0'/0'/k
     // seed (256bit)
     CKey seed;
@@ -255,8 +255,6 @@ void CWallet::DeriveNewChildKey(WalletBatch &batch, CKeyMetadata &metadata,
     CExtKey accountKey;
     // key at m/0'/0' (external) or m/0'/1' (internal)
     CExtKey chainChildKey;
-    // key at m/0'/0'/<n>'
-    CExtKey childKey;
 
     // try to get the seed
     if (!GetKey(hdChain.seed_id, seed)) {
@@ -274,6 +272,14 @@ void CWallet::DeriveNewChildKey(WalletBatch &batch, CKeyMetadata &metadata,
     assert(internal ? CanSupportFeature(FEATURE_HD_SPLIT) : true);
     accountKey.Derive(chainChildKey,
                       BIP32_HARDENED_KEY_LIMIT + (internal ? 1 : 0));
+    return chainChildKey;
+}
+
+void CWallet::DeriveNewChildKey(WalletBatch &batch, CKeyMetadata &metadata,
+                                CKey &secret, bool internal) {
+    const CExtKey chainChildKey = DeriveChainKey(internal);
+    // key at m/0'/0'/<n>'
+    CExtKey childKey;
 
     // derive child key at next index, skip keys already known to the wallet
     do {
@@ -306,6 +312,122 @@ void CWallet::DeriveNewChildKey(WalletBatch &batch, CKeyMetadata &metadata,
     }
 }
 
+namespace {
+//! Below this many keys per thread, starting worker threads costs more than
+//! deriving the keys on the calling thread.
+constexpr size_t MIN_KEYS_PER_DERIVE_THREAD = 64;
+//! Number of keys derived at once when topping up the keypool of an HD
+//! wallet. Bounds the memory held by derived keys, and how often the HD chain
+//! is written.
+constexpr int64_t KEYPOOL_TOPUP_CHUNK = 1000;
+
+/**
+ * Derive the hardened children first...first + count - 1 of chainKey along
+ * with their public keys. Computing and verifying the public keys dominates
+ * the cost, so large ranges are split over short-lived worker threads.
+ */
+std::vector<std::pair<CKey, CPubKey>>
+DeriveHardenedChildKeys(const CExtKey &chainKey, uint32_t first,
+                        size_t count) {
+    std::vector<std::pair<CKey, CPubKey>> keys(count);
+    auto derive = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            CExtKey childKey;
+            chainKey.Derive(childKey,
+                            (first + i) | BIP32_HARDENED_KEY_LIMIT);
+            CPubKey pubkey = childKey.key.GetPubKey();
+            assert(childKey.key.VerifyPubKey(pubkey));
+            keys[i] = {childKey.key, pubkey};
+        }
+    };
+
+    const size_t nThreads =
+        std::min<size_t>(std::max(GetNumCores(), 1),
+                         count / MIN_KEYS_PER_DERIVE_THREAD);
+    if (nThreads <= 1) {
+        derive(0, count);
+        return keys;
+    }
+
+    const size_t perThread = (count + nThreads - 1) / nThreads;
+    std::vector<std::thread> threads;
+    for (size_t begin = perThread; begin < count; begin += perThread) {
+        threads.emplace_back(derive, begin,
+                             std::min(count, begin + perThread));
+    }
+    derive(0, perThread);
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    return keys;
+}
+} // namespace
+
+void CWallet::AddHDKeysToPool(WalletBatch &batch, bool internal,
+                              int64_t count) {
+    AssertLockHeld(cs_wallet);
+    assert(!IsWalletFlagSet(WALLET_FLAG_DISABLE_PRIVATE_KEYS));
+    assert(!IsWalletFlagSet(WALLET_FLAG_BLANK_WALLET));
+    if (count <= 0) {
+        return;
+    }
+
+    // Derived keys are always compressed
+    SetMinVersion(FEATURE_COMPRPUBKEY);
+
+    const CExtKey chainChildKey = DeriveChainKey(internal);
+    uint32_t &counter = internal ? hdChain.nInternalChainCounter
+                                 : hdChain.nExternalChainCounter;
+    const int64_t nCreationTime = GetTime();
+    UpdateTimeFirstKey(nCreationTime);
+
+    while (count > 0) {
+        // Derive exactly the missing number of keys, and derive again only if
+        // some of them turn out to be already known to the wallet.
+        const size_t nDerive = std::min<int64_t>(count, KEYPOOL_TOPUP_CHUNK);
+        for (const auto &[secret, pubkey] :
+             DeriveHardenedChildKeys(chainChildKey, counter, nDerive)) {
+            const uint32_t childIndex = counter++;
+            if (HaveKey(pubkey.GetID())) {
+                continue;
+            }
+
+            CKeyMetadata metadata(nCreationTime);
+            metadata.hdKeypath = strprintf("m/0'/%d'/%d'", internal ? 1 : 0,
+                                           childIndex);
+            metadata.hd_seed_id = hdChain.seed_id;
+            mapKeyMetadata[pubkey.GetID()] = metadata;
+            if (!AddKeyPubKeyWithDB(batch, secret, pubkey)) {
+                throw std::runtime_error(std::string(__func__) +
+                                         ": AddKey failed");
+            }
+
+            // How in the hell did you use so many keys?
+            assert(m_max_keypool_index < std::numeric_limits<int64_t>::max());
+            int64_t index = ++m_max_keypool_index;
+            if (!batch.WritePool(index, CKeyPool(pubkey, internal))) {
+                throw std::runtime_error(std::string(__func__) +
+                                         ": writing generated key failed");
+            }
+
+            if (internal) {
+                setInternalKeyPool.insert(index);
+            } else {
+                setExternalKeyPool.insert(index);
+            }
+            m_pool_key_to_index[pubkey.GetID()] = index;
+            --count;
+        }
+
+        // update the chain model in the database, once per chunk rather than
+        // once per key
+        if (!batch.WriteHDChain(hdChain)) {
+            throw std::runtime_error(std::string(__func__) +
+                                     ": Writing HD chain model failed");
+        }
+    }
+}
+
 bool CWallet::AddKeyPubKeyWithDB(WalletBatch &batch, const CKey &secret,
                                  const CPubKey &pubkey) {
     // mapKeyMetadata
@@ -3744,29 +3866,37 @@ bool CWallet::TopUpKeyPool(unsigned int kpSize) {
             // don't create extra internal keys
             missingInternal = 0;
         }
-        bool internal = false;
         WalletBatch batch(*database);
-        for (int64_t i = missingInternal + missingExternal; i--;) {
-            if (i < missingInternal) {
-                internal = true;
-            }
+        if (IsHDEnabled()) {
+            // Derive the keys of each chain in bulk, external keys first like
+            // in the loop below.
+            AddHDKeysToPool(batch, false, missingExternal);
+            AddHDKeysToPool(batch, true, missingInternal);
+        } else {
+            bool internal = false;
+            for (int64_t i = missingInternal + missingExternal; i--;) {
+                if (i < missingInternal) {
+                    internal = true;
+                }
 
-            // How in the hell did you use so many keys?
-            assert(m_max_keypool_index < std::numeric_limits<int64_t>::max());
-            int64_t index = ++m_max_keypool_index;
+                // How in the hell did you use so many keys?
+                assert(m_max_keypool_index <
+                       std::numeric_limits<int64_t>::max());
+                int64_t index = ++m_max_keypool_index;
 
-            CPubKey pubkey(GenerateNewKey(batch, internal));
-            if (!batch.WritePool(index, CKeyPool(pubkey, internal))) {
-                throw std::runtime_error(std::string(__func__) +
-                                         ": writing generated key failed");
-            }
+                CPubKey pubkey(GenerateNewKey(batch, internal));
+                if (!batch.WritePool(index, CKeyPool(pubkey, internal))) {
+                    throw std::runtime_error(std::string(__func__) +
+                                             ": writing generated key failed");
+                }
 
-            if (internal) {
-                setInternalKeyPool.insert(index);
-            } else {
-                setExternalKeyPool.insert(index);
+                if (internal) {
+                    setInternalKeyPool.insert(index);
+                } else {
+                    setExternalKeyPool.insert(index);
+                }
+                m_pool_key_to_index[pubkey.GetID()] = index;
             }
-            m_pool_key_to_index[pubkey.GetID()] = index;
         }
         if (missingInternal + missingExternal > 0) {
             WalletLogPrintf(
@@ -780,6 +780,18 @@ private:
                            CKey &secret, bool internal = false)
         EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
+    /* HD derive the key at m/0'/0' (external) or m/0'/1' (internal) */
+    CExtKey DeriveChainKey(bool internal) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
+    /**
+     * HD derive count new child keys on one chain and add them to the keypool,
+     * skipping keys already known to the wallet like DeriveNewChildKey. The
+     * keys are derived in parallel, and the HD chain is written once per chunk
+     * of keys.
+     */
+    void AddHDKeysToPool(WalletBatch &batch, bool internal, int64_t count)
+        EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
     std::set<int64_t> setInternalKeyPool;
     std::set<int64_t> setExternalKeyPool GUARDED_BY(cs_wallet);
     std::set<int64_t> set_pre_split_keypool;
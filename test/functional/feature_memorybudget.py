@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 The Bitcoin developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the memory governor enabled by -memorybudget"""
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_greater_than,
+    wait_until,
+)
+
+MIB = 1024 * 1024
+# -maxmempool is in units of 1,000,000 bytes
+MAX_MEMPOOL = 50 * 1000 * 1000
+
+
+class MemoryBudgetTest(BitcoinTestFramework):
+
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 2
+        self.extra_args = [["-memorybudget=200", "-maxmempool=50"], []]
+
+    def run_test(self):
+        node = self.nodes[0]
+
+        self.log.info("Test that the static split is reported without -memorybudget")
+        info = self.nodes[1].getmemorybudgetinfo()
+        assert_equal(info["enabled"], False)
+        assert "budget" not in info
+        assert_equal(info["mempool"], self.nodes[1].getmempoolinfo()["maxmempool"])
+
+        self.log.info("Test that the mempool is held at its minimum during initial block download")
+        wait_until(lambda: node.getmemorybudgetinfo()["initialblockdownload"], timeout=60)
+        ibd_info = node.getmemorybudgetinfo()
+        assert_equal(ibd_info["enabled"], True)
+        assert_equal(ibd_info["budget"], 200 * MIB)
+        assert_equal(ibd_info["dbcache"] + ibd_info["coinscache"] + ibd_info["mempool"], 200 * MIB)
+        assert_greater_than(MAX_MEMPOOL, ibd_info["mempool"])
+        assert_equal(ibd_info["mempool"], node.getmempoolinfo()["maxmempool"])
+        assert_greater_than(ibd_info["adjustments"], 0)
+        assert ibd_info["lastdecision"].startswith("initial block download")
+
+        self.log.info("Test that the mempool gets back to its maximum once synced")
+        node.generatetoaddress(1, node.get_deterministic_priv_key().address)
+        wait_until(lambda: not node.getmemorybudgetinfo()["initialblockdownload"], timeout=60)
+        info = node.getmemorybudgetinfo()
+        assert_equal(info["mempool"], MAX_MEMPOOL)
+        assert_equal(info["mempool"], node.getmempoolinfo()["maxmempool"])
+        assert_equal(info["coinscache"], ibd_info["coinscache"] - (MAX_MEMPOOL - ibd_info["mempool"]))
+        assert_equal(info["dbcache"] + info["coinscache"] + info["mempool"], 200 * MIB)
+        assert_equal(info["adjustments"], ibd_info["adjustments"] + 1)
+        assert info["lastdecision"].startswith("synced")
+
+
+if __name__ == '__main__':
+    MemoryBudgetTest().main()
@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 The Bitcoin developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test bitcoin-cli -bulk"""
+import subprocess
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_greater_than,
+)
+
+NUM_BLOCKS = 25
+
+
+class TestBitcoinCliBulk(BitcoinTestFramework):
+
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 1
+
+    def run_bulk(self, commands, *options):
+        """Run bitcoin-cli -bulk with one command per input line, and return
+        its exit code, output lines and error output."""
+        node = self.nodes[0]
+        p_args = [node.cli.binary, "-datadir=" + node.cli.datadir, "-bulk"] + list(options)
+        process = subprocess.run(p_args, input="".join(c + "\n" for c in commands),
+                                 stdout=subprocess.PIPE, stderr=subprocess.PIPE, universal_newlines=True)
+        return process.returncode, process.stdout.splitlines(), process.stderr
+
+    def run_test(self):
+        node = self.nodes[0]
+        node.generatetoaddress(NUM_BLOCKS, node.get_deterministic_priv_key().address)
+        hashes = [node.getblockhash(height) for height in range(NUM_BLOCKS + 1)]
+        commands = ["getblockhash {}".format(height) for height in range(NUM_BLOCKS + 1)]
+
+        self.log.info("Test that replies are printed in input order")
+        for batch_size, connections in [(1, 1), (3, 2), (4, 8), (100, 4)]:
+            returncode, lines, _ = self.run_bulk(
+                commands, "-bulkbatchsize={}".format(batch_size), "-bulkconnections={}".format(connections))
+            assert_equal(returncode, 0)
+            assert_equal(lines, hashes)
+
+        self.log.info("Test that blank lines are skipped and JSON results are printed on one line")
+        returncode, lines, _ = self.run_bulk(["", "getblockhash 0", "  ", "getblockheader {} true".format(hashes[1])],
+                                             "-bulkbatchsize=2")
+        assert_equal(returncode, 0)
+        assert_equal(len(lines), 2)
+        assert_equal(lines[0], hashes[0])
+        assert '"height":1' in lines[1]
+
+        self.log.info("Test that failing commands print an error line and set the exit code")
+        returncode, lines, _ = self.run_bulk(
+            ["getblockhash 0", "getblockhash {}".format(NUM_BLOCKS + 1), "getblockhash 1", "notacommand"],
+            "-bulkbatchsize=3")
+        assert_greater_than(returncode, 0)
+        assert_equal(len(lines), 4)
+        assert_equal(lines[0], hashes[0])
+        assert lines[1].startswith("error: ")
+        assert "Block height out of range" in lines[1]
+        assert_equal(lines[2], hashes[1])
+        assert lines[3].startswith("error: ")
+        assert "Method not found" in lines[3]
+
+        self.log.info("Test that unparsable arguments fail only their own command")
+        returncode, lines, _ = self.run_bulk(["getblockhash notanumber", "getblockhash 2"])
+        assert_greater_than(returncode, 0)
+        assert_equal(len(lines), 2)
+        assert lines[0].startswith("error: ")
+        assert_equal(lines[1], hashes[2])
+
+        self.log.info("Test that -bulk cannot be combined with a command line command")
+        returncode, lines, stderr = self.run_bulk([], "getblockcount")
+        assert_equal(returncode, 1)
+        assert_equal(lines, [])
+        assert "-bulk" in stderr
+
+
+if __name__ == '__main__':
+    TestBitcoinCliBulk().main()
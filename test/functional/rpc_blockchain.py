@@ -14,6 +14,7 @@ Test the following RPCs:
     - getblockhash
     - getblockheader
     - getchaintxstats
+    - getdbinfo
     - getnetworkhashps
     - verifychain
 
@@ -64,6 +65,7 @@ class BlockchainTest(BitcoinTestFramework):
         self._test_getblockchaininfo()
         self._test_getchaintxstats()
         self._test_gettxoutsetinfo()
+        self._test_getdbinfo()
         self._test_getblockheader()
         self._test_getdifficulty()
         self._test_getnetworkhashps()
@@ -198,6 +200,31 @@ class BlockchainTest(BitcoinTestFramework):
         assert 'window_interval' not in chaintxstats
         assert 'txrate' not in chaintxstats
 
+    def _test_getdbinfo(self):
+        self.log.info("Test getdbinfo")
+        node = self.nodes[0]
+
+        res = node.getdbinfo()
+        assert_equal(sorted(res.keys()), ['blockindex', 'chainstate'])
+        for db in res.values():
+            assert_equal(sorted(db.keys()), ['estimatedsize', 'usage'])
+
+        self.restart_node(0, ['-stopatheight=207', '-prune=550', '-dbmmap'])
+        # Scan the whole UTXO set, which reads every chainstate table
+        node.gettxoutsetinfo()
+        res = node.getdbinfo()
+        for db in res.values():
+            assert_equal(sorted(db['mmap'].keys()), [
+                'checksumfailures', 'mappedbytes', 'mappedfiles',
+                'verifiedblocks'])
+        mmap = res['chainstate']['mmap']
+        assert_greater_than(mmap['mappedfiles'], 0)
+        assert_greater_than(mmap['mappedbytes'], 0)
+        assert_greater_than(mmap['verifiedblocks'], 0)
+        assert_equal(mmap['checksumfailures'], 0)
+
+        self.restart_node(0, ['-stopatheight=207', '-prune=550'])
+
     def _test_gettxoutsetinfo(self):
         node = self.nodes[0]
         res = node.gettxoutsetinfo()
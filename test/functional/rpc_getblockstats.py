@@ -7,13 +7,16 @@
 # Test getblockstats rpc call
 #
 import decimal
+import http.client
 import json
 import os
+import urllib.parse
 
 from test_framework.test_framework import BitcoinTestFramework
 from test_framework.util import (
     assert_equal,
     assert_raises_rpc_error,
+    wait_until,
 )
 
 TESTSDIR = os.path.dirname(os.path.realpath(__file__))
@@ -43,7 +46,8 @@ class GetblockstatsTest(BitcoinTestFramework):
 
     def set_test_params(self):
         self.num_nodes = 2
-        self.extra_args = [['-txindex'], ['-paytxfee=0.003']]
+        self.extra_args = [['-txindex'],
+                           ['-paytxfee=0.003', '-blockstatsindex', '-rest']]
         self.setup_clean_chain = True
 
     def get_stats(self):
@@ -131,6 +135,26 @@ class GetblockstatsTest(BitcoinTestFramework):
                 hash_or_height=blockhash)
             assert_equal(stats_by_hash, self.expected_stats[i])
 
+        self.log.info('Checking stats served by the block stats index')
+        url = urllib.parse.urlparse(self.nodes[1].url)
+
+        def get_rest_range():
+            conn = http.client.HTTPConnection(url.hostname, url.port)
+            conn.request('GET', '/rest/blockstats/{}/{}.json'.format(
+                self.max_stat_pos + 1, self.expected_stats[0]['blockhash']))
+            resp = conn.getresponse()
+            return resp.status, resp.read()
+
+        # The index syncs in the background, and the range is unavailable
+        # until all of it has been indexed.
+        wait_until(lambda: get_rest_range()[0] == 200)
+        rest_stats = json.loads(get_rest_range()[1].decode('utf-8'),
+                                parse_float=decimal.Decimal)
+        assert_equal(rest_stats, self.expected_stats)
+        for i in range(self.max_stat_pos + 1):
+            assert_equal(self.nodes[1].getblockstats(
+                hash_or_height=self.start_height + i), self.expected_stats[i])
+
         # Make sure each stat can be queried on its own
         for stat in expected_keys:
             for i in range(self.max_stat_pos + 1):
@@ -35,6 +35,15 @@ class RpcMiscTest(BitcoinTestFramework):
         assert_greater_than(memory['chunks_free'], 0)
         assert_equal(memory['used'] + memory['free'], memory['total'])
 
+        prevector = node.getmemoryinfo()['prevector']
+        assert_equal(list(prevector['spills'].keys()),
+                     ['32', '64', '128', '256', '512', '1024', '2048', 'larger'])
+        # The node has deserialized scripts too long to be stored inline, if
+        # only the genesis block's coinbase.
+        assert_greater_than(sum(prevector['spills'].values()), 0)
+        assert_greater_than_or_equal(prevector['reallocs'], 0)
+        assert_greater_than_or_equal(prevector['pool_hits'], 0)
+
         self.log.info("test mallocinfo")
         try:
             mallocinfo = node.getmemoryinfo(mode="mallocinfo")
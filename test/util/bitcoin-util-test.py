@@ -180,8 +180,8 @@ def parse_output(a, fmt):
     Raise an error if the output can't be parsed."""
     if fmt == 'json':  # json: compare parsed data
         return json.loads(a)
-    elif fmt == 'hex':  # hex: parse and compare binary data
-        return binascii.a2b_hex(a.strip())
+    elif fmt == 'hex':  # hex: parse and compare binary data, line by line
+        return [binascii.a2b_hex(line) for line in a.split()]
     else:
         raise NotImplementedError("Don't know how to compare {}".format(fmt))
 